@@ -0,0 +1,514 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Render time and memory benchmark.
+ *
+ * Renders a list of XML scenes in the background, and writes the time spent in
+ * each phase of the render along with peak memory usage to a JSON file. When a
+ * baseline file written by an earlier run is given, the results are compared
+ * against it and the exit code is non-zero if any scene regressed.
+ *
+ *   cycles_benchmark --samples 64 --output results.json --baseline baseline.json *.xml
+ *
+ * Path tracing and denoise times are summed over all render threads, the other
+ * times are elapsed times. The process peak memory only ever grows, for exact
+ * per scene numbers render one scene per run. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#endif
+
+#include "device/device.h"
+#include "render/buffers.h"
+#include "render/camera.h"
+#include "render/film.h"
+#include "render/scene.h"
+#include "render/session.h"
+#include "render/stats.h"
+
+#include "util/util_args.h"
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+#include "util/util_map.h"
+#include "util/util_path.h"
+#include "util/util_string.h"
+#include "util/util_time.h"
+#include "util/util_vector.h"
+#include "util/util_version.h"
+
+#include "app/cycles_xml.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Results of rendering a single scene, all times in seconds. */
+struct BenchmarkResult {
+  string name;
+  map<string, double> values;
+};
+
+/* Metrics in the order they are written, with the noise floor below which
+ * differences are not reported as regressions. */
+static const struct {
+  const char *name;
+  double noise_floor;
+} benchmark_metrics[] = {
+    {"sync", 0.01},
+    {"scene_update", 0.01},
+    {"bvh", 0.01},
+    {"images", 0.01},
+    {"path_tracing", 0.05},
+    {"denoise", 0.05},
+    {"render", 0.05},
+    {"total", 0.05},
+    {"device_memory_peak", 1024.0 * 1024.0},
+    {"process_memory_peak", 1024.0 * 1024.0},
+};
+
+static struct {
+  vector<string> filepaths;
+  SessionParams session_params;
+  SceneParams scene_params;
+  int width, height;
+  int repeat;
+  bool denoise;
+  float threshold;
+  string output_path;
+  string baseline_path;
+} options;
+
+static size_t process_memory_peak()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#  ifdef __APPLE__
+  /* Bytes on macOS, kilobytes elsewhere. */
+  return usage.ru_maxrss;
+#  else
+  return usage.ru_maxrss * 1024;
+#  endif
+#endif
+}
+
+static double update_stats_time(const UpdateTimeStats &stats, const char *filter)
+{
+  double time = 0.0;
+
+  foreach (const NamedTimeEntry &entry, stats.times.entries) {
+    if (string_endswith(entry.name, filter)) {
+      time += entry.time;
+    }
+  }
+
+  return time;
+}
+
+static BenchmarkResult benchmark_render(const string &filepath)
+{
+  BenchmarkResult result;
+  result.name = path_filename(filepath);
+
+  double start_time = time_dt();
+
+  Session *session = new Session(options.session_params);
+
+  /* Load scene. */
+  Scene *scene = new Scene(options.scene_params, session->device);
+  scene->enable_update_stats();
+  xml_read_file(scene, filepath.c_str());
+
+  if (!(options.width == 0 || options.height == 0)) {
+    scene->camera->set_full_width(options.width);
+    scene->camera->set_full_height(options.height);
+  }
+  scene->camera->compute_auto_viewplane();
+
+  BufferParams buffer_params;
+  buffer_params.width = scene->camera->get_full_width();
+  buffer_params.height = scene->camera->get_full_height();
+  buffer_params.full_width = buffer_params.width;
+  buffer_params.full_height = buffer_params.height;
+
+  if (session->params.denoising.use) {
+    scene->film->set_denoising_data_pass(true);
+    buffer_params.denoising_data_pass = true;
+  }
+
+  session->scene = scene;
+  result.values["sync"] = time_dt() - start_time;
+
+  /* Render. */
+  double render_start_time = time_dt();
+
+  session->reset(buffer_params, options.session_params.samples);
+  session->start();
+  session->wait();
+
+  double path_tracing_time, denoise_time;
+  session->progress.get_tiles_time(path_tracing_time, denoise_time);
+
+  const SceneUpdateStats *update_stats = scene->update_stats;
+  result.values["scene_update"] = update_stats->scene.times.total_time;
+  result.values["bvh"] = update_stats_time(update_stats->geometry, "BVH)") +
+                         update_stats_time(update_stats->geometry, "BVHs)");
+  result.values["images"] = update_stats->image.times.total_time;
+  result.values["path_tracing"] = path_tracing_time;
+  result.values["denoise"] = denoise_time;
+  result.values["render"] = time_dt() - render_start_time - update_stats->scene.times.total_time;
+  result.values["device_memory_peak"] = session->stats.mem_peak;
+
+  if (session->progress.get_error()) {
+    fprintf(stderr,
+            "Error rendering %s: %s\n",
+            filepath.c_str(),
+            session->progress.get_error_message().c_str());
+    exit(EXIT_FAILURE);
+  }
+
+  delete session;
+
+  result.values["total"] = time_dt() - start_time;
+  result.values["process_memory_peak"] = process_memory_peak();
+
+  return result;
+}
+
+/* Writing and reading of results. Only what is written here needs to be read back,
+ * so this is not a complete JSON parser. */
+
+static bool results_write(const string &filepath, const vector<BenchmarkResult> &results)
+{
+  FILE *f = path_fopen(filepath, "wb");
+  if (!f) {
+    return false;
+  }
+
+  fprintf(f, "{\n");
+  fprintf(f, "  \"version\": \"%s\",\n", CYCLES_VERSION_STRING);
+  fprintf(f, "  \"device\": \"%s\",\n", options.session_params.device.description.c_str());
+  fprintf(f, "  \"threads\": %d,\n", options.session_params.threads);
+  fprintf(f, "  \"samples\": %d,\n", options.session_params.samples);
+  fprintf(f, "  \"scenes\": [\n");
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchmarkResult &result = results[i];
+
+    fprintf(f, "    {\n");
+    fprintf(f, "      \"name\": \"%s\"", result.name.c_str());
+    for (const auto &metric : benchmark_metrics) {
+      fprintf(f, ",\n      \"%s\": %.6f", metric.name, result.values.at(metric.name));
+    }
+    fprintf(f, "\n    }%s\n", (i + 1 < results.size()) ? "," : "");
+  }
+
+  fprintf(f, "  ]\n");
+  fprintf(f, "}\n");
+  fclose(f);
+
+  return true;
+}
+
+static bool results_read(const string &filepath, vector<BenchmarkResult> &results)
+{
+  string text;
+  if (!path_read_text(filepath, text)) {
+    return false;
+  }
+
+  /* Find the scenes array, then read objects of string and number values. */
+  size_t pos = text.find("\"scenes\"");
+  if (pos == string::npos) {
+    return false;
+  }
+
+  while ((pos = text.find('{', pos)) != string::npos) {
+    const size_t end = text.find('}', pos);
+    if (end == string::npos) {
+      return false;
+    }
+
+    BenchmarkResult result;
+    size_t key_begin = pos;
+
+    while ((key_begin = text.find('"', key_begin)) != string::npos && key_begin < end) {
+      const size_t key_end = text.find('"', key_begin + 1);
+      const size_t colon = text.find(':', key_end);
+      if (key_end == string::npos || colon == string::npos || colon > end) {
+        return false;
+      }
+
+      const string key = text.substr(key_begin + 1, key_end - key_begin - 1);
+      const size_t value_begin = text.find_first_not_of(" \t\r\n", colon + 1);
+      if (value_begin == string::npos || value_begin >= end) {
+        return false;
+      }
+
+      if (text[value_begin] == '"') {
+        const size_t value_end = text.find('"', value_begin + 1);
+        if (value_end == string::npos || value_end > end) {
+          return false;
+        }
+        if (key == "name") {
+          result.name = text.substr(value_begin + 1, value_end - value_begin - 1);
+        }
+        key_begin = value_end + 1;
+      }
+      else {
+        const char *value_str = text.c_str() + value_begin;
+        char *value_end;
+        const double value = strtod(value_str, &value_end);
+        if (value_end == value_str) {
+          return false;
+        }
+        result.values[key] = value;
+        key_begin = value_end - text.c_str();
+      }
+    }
+
+    if (result.name.empty()) {
+      return false;
+    }
+
+    results.push_back(result);
+    pos = end + 1;
+  }
+
+  return true;
+}
+
+/* Print a comparison against the baseline, returns false if any metric regressed. */
+static bool results_compare(const vector<BenchmarkResult> &results,
+                            const vector<BenchmarkResult> &baseline)
+{
+  bool ok = true;
+
+  printf("%-24s %-20s %14s %14s %9s\n", "Scene", "Metric", "Baseline", "Current", "Change");
+
+  foreach (const BenchmarkResult &result, results) {
+    const BenchmarkResult *base = NULL;
+    foreach (const BenchmarkResult &candidate, baseline) {
+      if (candidate.name == result.name) {
+        base = &candidate;
+      }
+    }
+
+    if (base == NULL) {
+      printf("%-24s not in baseline\n", result.name.c_str());
+      continue;
+    }
+
+    for (const auto &metric : benchmark_metrics) {
+      map<string, double>::const_iterator it = base->values.find(metric.name);
+      if (it == base->values.end()) {
+        continue;
+      }
+
+      const double base_value = it->second;
+      const double value = result.values.at(metric.name);
+      const double change = (base_value > 0.0) ? (value - base_value) / base_value : 0.0;
+      const bool regressed = (value - base_value > metric.noise_floor) &&
+                             (change > options.threshold);
+
+      printf("%-24s %-20s %14.3f %14.3f %+8.1f%%%s\n",
+             result.name.c_str(),
+             metric.name,
+             base_value,
+             value,
+             change * 100.0,
+             regressed ? "  REGRESSION" : "");
+
+      if (regressed) {
+        ok = false;
+      }
+    }
+  }
+
+  return ok;
+}
+
+static int files_parse(int argc, const char *argv[])
+{
+  for (int i = 0; i < argc; i++) {
+    options.filepaths.push_back(argv[i]);
+  }
+
+  return 0;
+}
+
+static void options_parse(int argc, const char **argv)
+{
+  options.width = 0;
+  options.height = 0;
+  options.repeat = 1;
+  options.denoise = false;
+  options.threshold = 0.05f;
+
+  string devicename = "CPU";
+  bool help = false, debug = false;
+  int verbosity = 1;
+
+  ArgParse ap;
+
+  ap.options("Usage: cycles_benchmark [options] file.xml ...",
+             "%*",
+             files_parse,
+             "",
+             "--device %s",
+             &devicename,
+             "Device to use, defaults to CPU",
+             "--samples %d",
+             &options.session_params.samples,
+             "Number of samples to render",
+             "--threads %d",
+             &options.session_params.threads,
+             "CPU Rendering Threads",
+             "--width %d",
+             &options.width,
+             "Override the width of the render in pixels",
+             "--height %d",
+             &options.height,
+             "Override the height of the render in pixels",
+             "--tile-width %d",
+             &options.session_params.tile_size.x,
+             "Tile width in pixels",
+             "--tile-height %d",
+             &options.session_params.tile_size.y,
+             "Tile height in pixels",
+             "--denoise",
+             &options.denoise,
+             "Denoise with OpenImageDenoise",
+             "--repeat %d",
+             &options.repeat,
+             "Render every scene this many times and keep the fastest times",
+             "--output %s",
+             &options.output_path,
+             "File path to write JSON results to",
+             "--baseline %s",
+             &options.baseline_path,
+             "JSON results to compare against",
+             "--threshold %f",
+             &options.threshold,
+             "Relative increase in time or memory that is reported as regression",
+#ifdef WITH_CYCLES_LOGGING
+             "--debug",
+             &debug,
+             "Enable debug logging",
+             "--verbose %d",
+             &verbosity,
+             "Set verbosity of the logger",
+#endif
+             "--help",
+             &help,
+             "Print help message",
+             NULL);
+
+  if (ap.parse(argc, argv) < 0) {
+    fprintf(stderr, "%s\n", ap.geterror().c_str());
+    ap.usage();
+    exit(EXIT_FAILURE);
+  }
+
+  if (debug) {
+    util_logging_start();
+    util_logging_verbosity_set(verbosity);
+  }
+
+  if (help || options.filepaths.empty()) {
+    ap.usage();
+    exit(EXIT_SUCCESS);
+  }
+
+  DeviceType device_type = Device::type_from_string(devicename.c_str());
+  vector<DeviceInfo> devices = Device::available_devices(DEVICE_MASK(device_type));
+
+  if (devices.empty()) {
+    fprintf(stderr, "Unknown device: %s\n", devicename.c_str());
+    exit(EXIT_FAILURE);
+  }
+  else if (options.session_params.samples < 1) {
+    fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
+    exit(EXIT_FAILURE);
+  }
+  else if (options.repeat < 1) {
+    fprintf(stderr, "Invalid number of repetitions: %d\n", options.repeat);
+    exit(EXIT_FAILURE);
+  }
+
+  options.session_params.device = devices.front();
+  options.session_params.background = true;
+  options.session_params.progressive = false;
+
+  if (options.denoise) {
+    options.session_params.denoising.use = true;
+    options.session_params.denoising.type = DENOISER_OPENIMAGEDENOISE;
+  }
+}
+
+CCL_NAMESPACE_END
+
+using namespace ccl;
+
+int main(int argc, const char **argv)
+{
+  util_logging_init(argv[0]);
+  path_init();
+  options_parse(argc, argv);
+
+  vector<BenchmarkResult> results;
+
+  foreach (const string &filepath, options.filepaths) {
+    printf("Rendering %s\n", filepath.c_str());
+    fflush(stdout);
+
+    BenchmarkResult best = benchmark_render(filepath);
+
+    for (int i = 1; i < options.repeat; i++) {
+      BenchmarkResult result = benchmark_render(filepath);
+
+      for (auto &value : best.values) {
+        value.second = min(value.second, result.values[value.first]);
+      }
+    }
+
+    results.push_back(best);
+  }
+
+  if (!options.output_path.empty() && !results_write(options.output_path, results)) {
+    fprintf(stderr, "Failed to write results to %s\n", options.output_path.c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (!options.baseline_path.empty()) {
+    vector<BenchmarkResult> baseline;
+    if (!results_read(options.baseline_path, baseline)) {
+      fprintf(stderr, "Failed to read baseline from %s\n", options.baseline_path.c_str());
+      return EXIT_FAILURE;
+    }
+
+    if (!results_compare(results, baseline)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
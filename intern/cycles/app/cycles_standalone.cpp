@@ -429,6 +429,9 @@ static void options_parse(int argc, const char **argv)
              "--tile-height %d",
              &options.session_params.tile_size.y,
              "Tile height in pixels",
+             "--compact-geometry",
+             &options.scene_params.use_compact_geometry,
+             "Share triangle vertices to reduce memory usage",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -392,6 +392,13 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights based on their estimated contribution to the shading point, "
+        "instead of by power alone (less noise in scenes with many lights, slower per sample). "
+        "Only used by the Path Tracing integrator",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -694,6 +701,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         default=0,
         min=0, max=16,
     )
+    debug_use_compact_geometry: BoolProperty(
+        name="Use Compact Geometry",
+        description="Share triangle vertices between triangles instead of duplicating them for ray intersection: "
+        "uses less ram but renders slower",
+        default=False,
+    )
     tile_order: EnumProperty(
         name="Tile Order",
         description="Tile order for rendering",
@@ -839,6 +852,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
     )
     debug_use_cpu_split_kernel: BoolProperty(name="Split Kernel", default=False)
 
+    debug_use_shader_object_values: BoolProperty(
+        name="Hoist Object Values",
+        description="Evaluate parts of shaders which are constant over an object once per object instead of at every shading point",
+        default=False,
+    )
+
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
     debug_use_cuda_split_kernel: BoolProperty(name="Split Kernel", default=False)
 
@@ -80,6 +80,7 @@ bool debug_flags_sync_from_scene(BL::Scene b_scene)
   DebugFlags::OpenCL::DeviceType opencl_device_type = flags.opencl.device_type;
   /* Synchronize shared flags. */
   flags.viewport_static_bvh = get_enum(cscene, "debug_bvh_type");
+  flags.shader_object_values = get_boolean(cscene, "debug_use_shader_object_values");
   /* Synchronize CPU flags. */
   flags.cpu.avx2 = get_boolean(cscene, "debug_use_cpu_avx2");
   flags.cpu.avx = get_boolean(cscene, "debug_use_cpu_avx");
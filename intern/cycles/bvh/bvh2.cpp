@@ -460,9 +460,12 @@ void BVH2::pack_triangle(int idx, float4 tri_verts[3])
 void BVH2::pack_primitives()
 {
   const size_t tidx_size = pack.prim_index.size();
+  /* With compact geometry the kernel reads triangle vertices from the shared vertex array
+   * through the primitive index, so no triangle storage is packed into the BVH. */
+  const bool pack_triangles = !params.use_compact_geometry;
   size_t num_prim_triangles = 0;
   /* Count number of triangles primitives in BVH. */
-  for (unsigned int i = 0; i < tidx_size; i++) {
+  for (unsigned int i = 0; i < tidx_size && pack_triangles; i++) {
     if ((pack.prim_index[i] != -1)) {
       if ((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
         ++num_prim_triangles;
@@ -471,9 +474,11 @@ void BVH2::pack_primitives()
   }
   /* Reserve size for arrays. */
   pack.prim_tri_index.clear();
-  pack.prim_tri_index.resize(tidx_size);
   pack.prim_tri_verts.clear();
-  pack.prim_tri_verts.resize(num_prim_triangles * 3);
+  if (pack_triangles) {
+    pack.prim_tri_index.resize(tidx_size);
+    pack.prim_tri_verts.resize(num_prim_triangles * 3);
+  }
   pack.prim_visibility.clear();
   pack.prim_visibility.resize(tidx_size);
   /* Fill in all the arrays. */
@@ -482,7 +487,10 @@ void BVH2::pack_primitives()
     if (pack.prim_index[i] != -1) {
       int tob = pack.prim_object[i];
       Object *ob = objects[tob];
-      if ((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
+      if (!pack_triangles) {
+        /* Pass. */
+      }
+      else if ((pack.prim_type[i] & PRIMITIVE_ALL_TRIANGLE) != 0) {
         pack_triangle(i, (float4 *)&pack.prim_tri_verts[3 * prim_triangle_index]);
         pack.prim_tri_index[i] = 3 * prim_triangle_index;
         ++prim_triangle_index;
@@ -493,7 +501,9 @@ void BVH2::pack_primitives()
       pack.prim_visibility[i] = ob->visibility_for_tracing();
     }
     else {
-      pack.prim_tri_index[i] = -1;
+      if (pack_triangles) {
+        pack.prim_tri_index[i] = -1;
+      }
       pack.prim_visibility[i] = 0;
     }
   }
@@ -546,7 +556,9 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   pack.prim_object.resize(prim_index_size);
   pack.prim_visibility.resize(prim_index_size);
   pack.prim_tri_verts.resize(prim_tri_verts_size);
-  pack.prim_tri_index.resize(prim_index_size);
+  if (!params.use_compact_geometry) {
+    pack.prim_tri_index.resize(prim_index_size);
+  }
   pack.nodes.resize(nodes_size);
   pack.leaf_nodes.resize(leaf_nodes_size);
   pack.object_node.resize(objects.size());
@@ -609,16 +621,20 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
       int *bvh_prim_index = &bvh->pack.prim_index[0];
       int *bvh_prim_type = &bvh->pack.prim_type[0];
       uint *bvh_prim_visibility = &bvh->pack.prim_visibility[0];
-      uint *bvh_prim_tri_index = &bvh->pack.prim_tri_index[0];
+      uint *bvh_prim_tri_index = bvh->pack.prim_tri_index.size() ?
+                                     &bvh->pack.prim_tri_index[0] :
+                                     NULL;
       float2 *bvh_prim_time = bvh->pack.prim_time.size() ? &bvh->pack.prim_time[0] : NULL;
 
       for (size_t i = 0; i < bvh_prim_index_size; i++) {
-        if (bvh->pack.prim_type[i] & PRIMITIVE_ALL_CURVE) {
-          pack_prim_index[pack_prim_index_offset] = bvh_prim_index[i] + geom_prim_offset;
+        pack_prim_index[pack_prim_index_offset] = bvh_prim_index[i] + geom_prim_offset;
+        if (bvh_prim_tri_index == NULL) {
+          /* Compact geometry, triangles are looked up by primitive index. */
+        }
+        else if (bvh->pack.prim_type[i] & PRIMITIVE_ALL_CURVE) {
           pack_prim_tri_index[pack_prim_index_offset] = -1;
         }
         else {
-          pack_prim_index[pack_prim_index_offset] = bvh_prim_index[i] + geom_prim_offset;
           pack_prim_tri_index[pack_prim_index_offset] = bvh_prim_tri_index[i] +
                                                         pack_prim_tri_verts_offset;
         }
@@ -91,6 +91,9 @@ class BVHParams {
   /* These are needed for Embree. */
   int curve_subdivisions;
 
+  /* Same as in SceneParams, triangle vertices are not duplicated into the BVH pack. */
+  bool use_compact_geometry;
+
   /* fixed parameters */
   enum { MAX_DEPTH = 64, MAX_SPATIAL_DEPTH = 48, NUM_SPATIAL_BINS = 32 };
 
@@ -122,6 +125,8 @@ class BVHParams {
     bvh_type = 0;
 
     curve_subdivisions = 4;
+
+    use_compact_geometry = false;
   }
 
   /* SAH costs */
@@ -18,18 +18,55 @@
  *
  * Basic triangle with 3 vertices is used to represent mesh surfaces. For BVH
  * ray intersection we use a precomputed triangle storage to accelerate
- * intersection at the cost of more memory usage */
+ * intersection at the cost of more memory usage. With compact geometry the
+ * vertices are instead stored once and shared between triangles. */
 
 CCL_NAMESPACE_BEGIN
 
+/* Triangle vertex fetching, from either the per-triangle or the shared vertex storage. */
+
+ccl_device_inline void triangle_vertices_from_vindex(KernelGlobals *kg,
+                                                     const uint4 tri_vindex,
+                                                     float4 verts[3])
+{
+  if (kernel_data.bvh.use_compact_geometry) {
+    verts[0] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.x);
+    verts[1] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.y);
+    verts[2] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.z);
+  }
+  else {
+    verts[0] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0);
+    verts[1] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1);
+    verts[2] = kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2);
+  }
+}
+
+ccl_device_inline void triangle_vertices_from_prim_addr(KernelGlobals *kg,
+                                                        int prim_addr,
+                                                        float4 verts[3])
+{
+  if (kernel_data.bvh.use_compact_geometry) {
+    const int prim = kernel_tex_fetch(__prim_index, prim_addr);
+    triangle_vertices_from_vindex(kg, kernel_tex_fetch(__tri_vindex, prim), verts);
+  }
+  else {
+    const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, prim_addr);
+    verts[0] = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0);
+    verts[1] = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1);
+    verts[2] = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2);
+  }
+}
+
 /* Normal on triangle. */
 ccl_device_inline float3 triangle_normal(KernelGlobals *kg, ShaderData *sd)
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-  const float3 v0 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0));
-  const float3 v1 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1));
-  const float3 v2 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2));
+  float4 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  const float3 v0 = float4_to_float3(verts[0]);
+  const float3 v1 = float4_to_float3(verts[1]);
+  const float3 v2 = float4_to_float3(verts[2]);
 
   /* return normal */
   if (sd->object_flag & SD_OBJECT_NEGATIVE_SCALE_APPLIED) {
@@ -46,9 +83,11 @@ ccl_device_inline void triangle_point_normal(
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 v0 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0));
-  float3 v1 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1));
-  float3 v2 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2));
+  float4 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  float3 v0 = float4_to_float3(verts[0]);
+  float3 v1 = float4_to_float3(verts[1]);
+  float3 v2 = float4_to_float3(verts[2]);
   /* compute point */
   float t = 1.0f - u - v;
   *P = (u * v0 + v * v1 + t * v2);
@@ -70,9 +109,11 @@ ccl_device_inline void triangle_point_normal(
 ccl_device_inline void triangle_vertices(KernelGlobals *kg, int prim, float3 P[3])
 {
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  P[0] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0));
-  P[1] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1));
-  P[2] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2));
+  float4 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  P[0] = float4_to_float3(verts[0]);
+  P[1] = float4_to_float3(verts[1]);
+  P[2] = float4_to_float3(verts[2]);
 }
 
 /* Interpolate smooth vertex normal from vertices */
@@ -100,9 +141,11 @@ ccl_device_inline void triangle_dPdudv(KernelGlobals *kg,
 {
   /* fetch triangle vertex coordinates */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  const float3 p0 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0));
-  const float3 p1 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1));
-  const float3 p2 = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2));
+  float4 verts[3];
+  triangle_vertices_from_vindex(kg, tri_vindex, verts);
+  const float3 p0 = float4_to_float3(verts[0]);
+  const float3 p1 = float4_to_float3(verts[1]);
+  const float3 p2 = float4_to_float3(verts[2]);
 
   /* compute derivatives of P w.r.t. uv */
   *dPdu = (p0 - p2);
@@ -30,13 +30,20 @@ ccl_device_inline bool triangle_intersect(KernelGlobals *kg,
                                           int object,
                                           int prim_addr)
 {
-  const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, prim_addr);
+  float4 tri_verts[3];
 #if defined(__KERNEL_SSE2__) && defined(__KERNEL_SSE__)
-  const ssef *ssef_verts = (ssef *)&kg->__prim_tri_verts.data[tri_vindex];
+  const ssef *ssef_verts;
+  if (kernel_data.bvh.use_compact_geometry) {
+    /* Shared vertices are not stored consecutively, gather them first. */
+    triangle_vertices_from_prim_addr(kg, prim_addr, tri_verts);
+    ssef_verts = (const ssef *)tri_verts;
+  }
+  else {
+    const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, prim_addr);
+    ssef_verts = (ssef *)&kg->__prim_tri_verts.data[tri_vindex];
+  }
 #else
-  const float4 tri_a = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0),
-               tri_b = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1),
-               tri_c = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2);
+  triangle_vertices_from_prim_addr(kg, prim_addr, tri_verts);
 #endif
   float t, u, v;
   if (ray_triangle_intersect(P,
@@ -45,9 +52,9 @@ ccl_device_inline bool triangle_intersect(KernelGlobals *kg,
 #if defined(__KERNEL_SSE2__) && defined(__KERNEL_SSE__)
                              ssef_verts,
 #else
-                             float4_to_float3(tri_a),
-                             float4_to_float3(tri_b),
-                             float4_to_float3(tri_c),
+                             float4_to_float3(tri_verts[0]),
+                             float4_to_float3(tri_verts[1]),
+                             float4_to_float3(tri_verts[2]),
 #endif
                              &u,
                              &v,
@@ -97,13 +104,21 @@ ccl_device_inline bool triangle_intersect_local(KernelGlobals *kg,
     }
   }
 
-  const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, prim_addr);
+  float4 tri_verts[3];
 #  if defined(__KERNEL_SSE2__) && defined(__KERNEL_SSE__)
-  const ssef *ssef_verts = (ssef *)&kg->__prim_tri_verts.data[tri_vindex];
+  const ssef *ssef_verts;
+  if (kernel_data.bvh.use_compact_geometry) {
+    triangle_vertices_from_prim_addr(kg, prim_addr, tri_verts);
+    ssef_verts = (const ssef *)tri_verts;
+  }
+  else {
+    const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, prim_addr);
+    ssef_verts = (ssef *)&kg->__prim_tri_verts.data[tri_vindex];
+  }
 #  else
-  const float3 tri_a = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0)),
-               tri_b = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1)),
-               tri_c = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2));
+  triangle_vertices_from_prim_addr(kg, prim_addr, tri_verts);
+  const float3 tri_a = float4_to_float3(tri_verts[0]), tri_b = float4_to_float3(tri_verts[1]),
+               tri_c = float4_to_float3(tri_verts[2]);
 #  endif
   float t, u, v;
   if (!ray_triangle_intersect(P,
@@ -171,9 +186,9 @@ ccl_device_inline bool triangle_intersect_local(KernelGlobals *kg,
 
   /* Record geometric normal. */
 #  if defined(__KERNEL_SSE2__) && defined(__KERNEL_SSE__)
-  const float3 tri_a = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0)),
-               tri_b = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1)),
-               tri_c = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2));
+  triangle_vertices_from_prim_addr(kg, prim_addr, tri_verts);
+  const float3 tri_a = float4_to_float3(tri_verts[0]), tri_b = float4_to_float3(tri_verts[1]),
+               tri_c = float4_to_float3(tri_verts[2]);
 #  endif
   local_isect->Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
 
@@ -219,10 +234,9 @@ ccl_device_inline float3 triangle_refine(KernelGlobals *kg,
 
   P = P + D * t;
 
-  const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, isect->prim);
-  const float4 tri_a = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0),
-               tri_b = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1),
-               tri_c = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2);
+  float4 tri_verts[3];
+  triangle_vertices_from_prim_addr(kg, isect->prim, tri_verts);
+  const float4 tri_a = tri_verts[0], tri_b = tri_verts[1], tri_c = tri_verts[2];
   float3 edge1 = make_float3(tri_a.x - tri_c.x, tri_a.y - tri_c.y, tri_a.z - tri_c.z);
   float3 edge2 = make_float3(tri_b.x - tri_c.x, tri_b.y - tri_c.y, tri_b.z - tri_c.z);
   float3 tvec = make_float3(P.x - tri_c.x, P.y - tri_c.y, P.z - tri_c.z);
@@ -286,10 +300,9 @@ ccl_device_inline float3 triangle_refine_local(KernelGlobals *kg,
   P = P + D * t;
 
 #  ifdef __INTERSECTION_REFINE__
-  const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, isect->prim);
-  const float4 tri_a = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0),
-               tri_b = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1),
-               tri_c = kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2);
+  float4 tri_verts[3];
+  triangle_vertices_from_prim_addr(kg, isect->prim, tri_verts);
+  const float4 tri_a = tri_verts[0], tri_b = tri_verts[1], tri_c = tri_verts[2];
   float3 edge1 = make_float3(tri_a.x - tri_c.x, tri_a.y - tri_c.y, tri_a.z - tri_c.z);
   float3 edge2 = make_float3(tri_b.x - tri_c.x, tri_b.y - tri_c.y, tri_b.z - tri_c.z);
   float3 tvec = make_float3(P.x - tri_c.x, P.y - tri_c.y, P.z - tri_c.z);
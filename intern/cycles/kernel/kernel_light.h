@@ -15,6 +15,7 @@
  */
 
 #include "kernel_light_background.h"
+#include "kernel_light_tree.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -37,6 +38,18 @@ typedef struct LightSample {
 
 /* Regular Light */
 
+/* Probability of selecting the lamp, which depends on the shading point with the light tree. */
+ccl_device_inline float lamp_light_select_pdf(KernelGlobals *kg,
+                                              const ccl_global KernelLight *klight,
+                                              float3 P)
+{
+  if (kernel_data.integrator.use_light_tree && klight->light_tree_emitter != -1) {
+    return light_tree_pdf(kg, P, klight->light_tree_emitter);
+  }
+
+  return kernel_data.integrator.pdf_lights;
+}
+
 ccl_device_inline bool lamp_light_sample(
     KernelGlobals *kg, int lamp, float randu, float randv, float3 P, LightSample *ls)
 {
@@ -171,7 +184,7 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= lamp_light_select_pdf(kg, klight, P);
 
   return (ls->pdf > 0.0f);
 }
@@ -328,7 +341,7 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  ls->pdf *= lamp_light_select_pdf(kg, klight, P);
 
   return true;
 }
@@ -365,12 +378,32 @@ ccl_device_inline bool triangle_world_space_vertices(
   return has_motion;
 }
 
-ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
-                                                const float3 Ng,
+/* Probability of selecting the triangle divided by its area, as triangle pdfs are
+ * computed per unit area. */
+ccl_device_inline float triangle_light_select_pdf_area(KernelGlobals *kg,
+                                                       int object,
+                                                       int prim,
+                                                       float3 P)
+{
+  if (kernel_data.integrator.use_light_tree) {
+    const int emitter = light_tree_triangle_emitter(kg, object, prim);
+    if (emitter == -1) {
+      return 0.0f;
+    }
+
+    return light_tree_pdf(kg, P, emitter) *
+           kernel_tex_fetch(__light_tree_emitters, emitter).invarea;
+  }
+
+  return kernel_data.integrator.pdf_triangles;
+}
+
+ccl_device_inline float triangle_light_pdf_area(const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float pdf_triangles)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
+  float pdf = pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -395,10 +428,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
   const float3 N = cross(e0, e1);
   const float distance_to_plane = fabsf(dot(N, sd->I * t)) / dot(N, N);
 
+  /* sd contains the point on the light source
+   * calculate Px, the point that we're shading */
+  const float3 Px = sd->P + sd->I * t;
+  const float pdf_triangles = triangle_light_select_pdf_area(kg, sd->object, sd->prim, Px);
+
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
-    /* sd contains the point on the light source
-     * calculate Px, the point that we're shading */
-    const float3 Px = sd->P + sd->I * t;
     const float3 v0_p = V[0] - Px;
     const float3 v1_p = V[1] - Px;
     const float3 v2_p = V[2] - Px;
@@ -426,12 +461,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
       else {
         area = 0.5f * len(N);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       return pdf / solid_angle;
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
+    float pdf = triangle_light_pdf_area(sd->Ng, sd->I, t, pdf_triangles);
     if (has_motion) {
       const float area = 0.5f * len(N);
       if (UNLIKELY(area == 0.0f)) {
@@ -486,6 +521,8 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
   ls->shader |= SHADER_USE_MIS;
   ls->type = LIGHT_TRIANGLE;
 
+  const float pdf_triangles = triangle_light_select_pdf_area(kg, object, prim, P);
+
   float distance_to_plane = fabsf(dot(N0, V[0] - P) / dot(N0, N0));
 
   if (longest_edge_squared > distance_to_plane * distance_to_plane) {
@@ -579,7 +616,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
         triangle_world_space_vertices(kg, object, prim, -1.0f, V);
         area = triangle_area(V[0], V[1], V[2]);
       }
-      const float pdf = area * kernel_data.integrator.pdf_triangles;
+      const float pdf = area * pdf_triangles;
       ls->pdf = pdf / solid_angle;
     }
   }
@@ -601,7 +638,7 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
+    ls->pdf = triangle_light_pdf_area(ls->Ng, -ls->D, ls->t, pdf_triangles);
     if (has_motion && area != 0.0f) {
       /* scale the PDF.
        * area = the area the sample was taken from
@@ -669,7 +706,30 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
-  if (lamp < 0) {
+  if (lamp < 0 && kernel_data.integrator.use_light_tree) {
+    /* sample index */
+    int index = light_tree_distant_sample(kg, &randu);
+    if (index == -1) {
+      index = light_tree_sample(kg, P, &randu);
+      if (index == -1) {
+        return false;
+      }
+    }
+
+    /* fetch light data */
+    const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                          index);
+    int prim = kemitter->prim;
+
+    if (prim >= 0) {
+      triangle_light_sample(kg, prim, kemitter->object_id, randu, randv, time, ls, P);
+      ls->shader |= kemitter->shader_flag;
+      return (ls->pdf > 0.0f);
+    }
+
+    lamp = -prim - 1;
+  }
+  else if (lamp < 0) {
     /* sample index */
     int index = light_distribution_sample(kg, &randu);
 
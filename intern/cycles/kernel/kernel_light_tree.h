@@ -0,0 +1,198 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Importance sampling of one emitter out of many, by traversing a hierarchy of
+ * emitters built on the host. At every inner node a child is chosen proportional
+ * to an estimate of the light it contributes to the shading point, based on its
+ * energy, distance and orientation bounds. Emitters within a leaf are chosen
+ * proportional to their energy.
+ *
+ * Distant and background lights are not part of the tree, they are selected
+ * uniformly with the remaining probability, through pdf_lights. */
+
+ccl_device float light_tree_node_importance(const float3 P,
+                                            const ccl_global KernelLightTreeNode *knode)
+{
+  if (knode->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_squared = 0.25f * len_squared(bbox_max - bbox_min);
+
+  const float3 point_to_centroid = P - centroid;
+  const float distance_squared = len_squared(point_to_centroid);
+
+  float cos_theta_prime = 1.0f;
+
+  if (knode->theta_o < M_PI_F) {
+    /* Smallest angle between the direction to the shading point and any emitter
+     * normal, taking into account the angle the node covers as seen from the point. */
+    const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+    const float distance = sqrtf(distance_squared);
+    const float cos_theta = (distance > 0.0f) ? dot(axis, point_to_centroid) / distance : 1.0f;
+    const float theta = fast_acosf(clamp(cos_theta, -1.0f, 1.0f));
+    const float theta_u = (distance_squared > radius_squared) ?
+                              fast_asinf(sqrtf(radius_squared / distance_squared)) :
+                              M_PI_F;
+    const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+
+    if (theta_prime >= knode->theta_e) {
+      return 0.0f;
+    }
+
+    cos_theta_prime = fast_cosf(theta_prime);
+  }
+
+  /* Clamp the distance to the size of the node, to not overestimate nodes close to
+   * or containing the shading point. */
+  const float clamped_distance_squared = max(max(distance_squared, radius_squared), 1e-10f);
+
+  return knode->energy * cos_theta_prime / clamped_distance_squared;
+}
+
+/* Pick a distant or background light with the probability not given to the tree, or
+ * return -1 to sample the tree. The random number is rescaled for reuse. */
+ccl_device int light_tree_distant_sample(KernelGlobals *kg, float *randu)
+{
+  const int num_distant = kernel_data.integrator.num_distant_lights;
+  if (num_distant == 0) {
+    return -1;
+  }
+
+  const float tree_pdf = kernel_data.integrator.light_tree_pdf;
+
+  if (*randu < tree_pdf) {
+    *randu = *randu / tree_pdf;
+    return -1;
+  }
+
+  const float r = (*randu - tree_pdf) / (1.0f - tree_pdf) * num_distant;
+  const int distant = min((int)r, num_distant - 1);
+
+  *randu = min(r - distant, 1.0f - FLT_EPSILON);
+  return kernel_data.integrator.num_light_tree_emitters + distant;
+}
+
+/* Pick an emitter for the shading point, rescaling the random number for reuse. Returns -1
+ * when no emitter can be picked. */
+ccl_device int light_tree_sample(KernelGlobals *kg, const float3 P, float *randu)
+{
+  /* The tree has no nodes when there are only distant lights. */
+  if (kernel_data.integrator.num_light_tree_emitters == 0) {
+    return -1;
+  }
+
+  float r = *randu;
+  int index = 0;
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, index);
+
+  while (knode->num_emitters == 0) {
+    const int left_index = index + 1;
+    const int right_index = knode->child_index;
+
+    const float left_importance = light_tree_node_importance(
+        P, &kernel_tex_fetch(__light_tree_nodes, left_index));
+    const float right_importance = light_tree_node_importance(
+        P, &kernel_tex_fetch(__light_tree_nodes, right_index));
+    const float total_importance = left_importance + right_importance;
+
+    if (total_importance == 0.0f) {
+      return -1;
+    }
+
+    const float left_probability = left_importance / total_importance;
+
+    if (r < left_probability) {
+      index = left_index;
+      r = r / left_probability;
+    }
+    else {
+      index = right_index;
+      r = (r - left_probability) / (1.0f - left_probability);
+    }
+
+    knode = &kernel_tex_fetch(__light_tree_nodes, index);
+  }
+
+  const int first = knode->child_index;
+  const int last = first + knode->num_emitters - 1;
+
+  for (int emitter = first; emitter <= last; emitter++) {
+    const float leaf_pdf = kernel_tex_fetch(__light_tree_emitters, emitter).leaf_pdf;
+
+    if (r < leaf_pdf || emitter == last) {
+      *randu = (leaf_pdf > 0.0f) ? min(r / leaf_pdf, 1.0f - FLT_EPSILON) : r;
+      return emitter;
+    }
+
+    r -= leaf_pdf;
+  }
+
+  return -1;
+}
+
+/* Probability of picking the emitter from the shading point, including the
+ * probability of choosing the tree over distant lights. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, const float3 P, int emitter)
+{
+  const ccl_global KernelLightTreeEmitter *kemitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                        emitter);
+  float pdf = kernel_data.integrator.light_tree_pdf * kemitter->leaf_pdf;
+  int index = kemitter->leaf;
+
+  while (index != 0) {
+    const int parent = kernel_tex_fetch(__light_tree_nodes, index).parent;
+    const int left_index = parent + 1;
+    const int right_index = kernel_tex_fetch(__light_tree_nodes, parent).child_index;
+
+    const float left_importance = light_tree_node_importance(
+        P, &kernel_tex_fetch(__light_tree_nodes, left_index));
+    const float right_importance = light_tree_node_importance(
+        P, &kernel_tex_fetch(__light_tree_nodes, right_index));
+    const float total_importance = left_importance + right_importance;
+
+    if (total_importance == 0.0f) {
+      return 0.0f;
+    }
+
+    pdf *= ((index == left_index) ? left_importance : right_importance) / total_importance;
+    index = parent;
+  }
+
+  return pdf;
+}
+
+/* Emitter of a mesh light triangle, or -1 if it can't be picked by light sampling. */
+ccl_device_inline int light_tree_triangle_emitter(KernelGlobals *kg, int object, int prim)
+{
+  const int offset = kernel_tex_fetch(__light_tree_triangles, object * 2);
+
+  if (offset == -1) {
+    return -1;
+  }
+
+  const int prim_offset = kernel_tex_fetch(__light_tree_triangles, object * 2 + 1);
+  return kernel_tex_fetch(__light_tree_triangles, offset + prim - prim_offset);
+}
+
+CCL_NAMESPACE_END
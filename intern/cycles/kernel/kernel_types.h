@@ -1385,6 +1385,12 @@ typedef struct KernelIntegrator {
 
   int max_closures;
 
+  /* light tree */
+  int use_light_tree;
+  int num_light_tree_emitters;
+  int num_distant_lights;
+  float light_tree_pdf;
+
   int pad1, pad2;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
@@ -1411,6 +1417,9 @@ typedef struct KernelBVH {
   int bvh_layout;
   int use_bvh_steps;
   int curve_subdivisions;
+  /* Triangle vertices are shared between triangles instead of duplicated per triangle. */
+  int use_compact_geometry;
+  int pad1, pad3, pad4;
 
   /* Custom BVH */
 #ifdef __KERNEL_OPTIX__
@@ -1519,7 +1528,7 @@ typedef struct KernelLight {
   float max_bounces;
   float random;
   float strength[3];
-  float pad1;
+  int light_tree_emitter;
   Transform tfm;
   Transform itfm;
   union {
@@ -1546,6 +1555,39 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light tree node, bounding the position, orientation and energy of the emitters below it.
+ * Emitter normals lie within theta_o of the axis, and emit light within theta_e of their
+ * normal. Inner nodes have their left child directly after them. */
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* Right child for inner nodes, first emitter for leaves. */
+  int child_index;
+  /* Zero for inner nodes. */
+  int num_emitters;
+  int parent;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+typedef struct KernelLightTreeEmitter {
+  /* Probability of selecting the emitter from its leaf. */
+  float leaf_pdf;
+  /* Inverse area of triangles, as their pdfs are computed per unit area. */
+  float invarea;
+  /* Same as KernelLightDistribution. */
+  int prim;
+  int shader_flag;
+  int object_id;
+  int leaf;
+  int pad1, pad2;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
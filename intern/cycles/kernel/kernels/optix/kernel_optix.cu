@@ -165,10 +165,11 @@ extern "C" __global__ void __anyhit__kernel_optix_local_hit()
   isect->v = barycentrics.x;
 
   // Record geometric normal
-  const uint tri_vindex = kernel_tex_fetch(__prim_tri_index, isect->prim);
-  const float3 tri_a = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 0));
-  const float3 tri_b = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 1));
-  const float3 tri_c = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex + 2));
+  float4 tri_verts[3];
+  triangle_vertices_from_prim_addr(NULL, isect->prim, tri_verts);  // Globals are unused in OptiX
+  const float3 tri_a = float4_to_float3(tri_verts[0]);
+  const float3 tri_b = float4_to_float3(tri_verts[1]);
+  const float3 tri_c = float4_to_float3(tri_verts[2]);
   local_isect->Ng[hit] = normalize(cross(tri_b - tri_a, tri_c - tri_a));
 
   // Continue tracing (without this the trace call would return after the first hit)
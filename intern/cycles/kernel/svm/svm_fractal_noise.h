@@ -103,6 +103,40 @@ ccl_device_noinline float fractal_noise_3d(float3 p, float octaves, float roughn
   }
 }
 
+#ifdef __KERNEL_SSE2__
+/* Same as fractal_noise_3d, but evaluated for four points at once, with the coordinates of
+ * the points stored per axis. */
+ccl_device_noinline float4
+fractal_noise_3d_x4(float4 x, float4 y, float4 z, float octaves, float roughness)
+{
+  float fscale = 1.0f;
+  float amp = 1.0f;
+  float maxamp = 0.0f;
+  float4 sum = zero_float4();
+  octaves = clamp(octaves, 0.0f, 16.0f);
+  int n = float_to_int(octaves);
+  for (int i = 0; i <= n; i++) {
+    float4 t = noise_3d_x4(fscale * x, fscale * y, fscale * z);
+    sum += t * amp;
+    maxamp += amp;
+    amp *= clamp(roughness, 0.0f, 1.0f);
+    fscale *= 2.0f;
+  }
+  float rmd = octaves - floorf(octaves);
+  if (rmd != 0.0f) {
+    float4 t = noise_3d_x4(fscale * x, fscale * y, fscale * z);
+    float4 sum2 = sum + t * amp;
+    /* Divide per component rather than by the reciprocal, consistent with fractal_noise_3d. */
+    sum = sum / make_float4(maxamp);
+    sum2 = sum2 / make_float4(maxamp + amp);
+    return (1.0f - rmd) * sum + rmd * sum2;
+  }
+  else {
+    return sum / make_float4(maxamp);
+  }
+}
+#endif
+
 /* The fractal_noise_[1-4] functions are all exactly the same except for the input type. */
 ccl_device_noinline float fractal_noise_4d(float4 p, float octaves, float roughness)
 {
@@ -103,17 +103,46 @@ ccl_device void noise_texture_3d(float3 co,
 {
   float3 p = co;
   if (distortion != 0.0f) {
+#ifdef __KERNEL_SSE2__
+    /* The three distortion lookups are evaluated as one packet. */
+    const float3 p0 = p + random_float3_offset(0.0f);
+    const float3 p1 = p + random_float3_offset(1.0f);
+    const float3 p2 = p + random_float3_offset(2.0f);
+    const float4 d = snoise_3d_x4(make_float4(p0.x, p1.x, p2.x, 0.0f),
+                                  make_float4(p0.y, p1.y, p2.y, 0.0f),
+                                  make_float4(p0.z, p1.z, p2.z, 0.0f));
+    p += make_float3(d.x * distortion, d.y * distortion, d.z * distortion);
+#else
     p += make_float3(snoise_3d(p + random_float3_offset(0.0f)) * distortion,
                      snoise_3d(p + random_float3_offset(1.0f)) * distortion,
                      snoise_3d(p + random_float3_offset(2.0f)) * distortion);
+#endif
   }
 
+#ifdef __KERNEL_SSE2__
+  if (color_is_needed) {
+    /* The value and the two remaining color channels are evaluated as one packet. */
+    const float3 p1 = p + random_float3_offset(3.0f);
+    const float3 p2 = p + random_float3_offset(4.0f);
+    const float4 r = fractal_noise_3d_x4(make_float4(p.x, p1.x, p2.x, 0.0f),
+                                         make_float4(p.y, p1.y, p2.y, 0.0f),
+                                         make_float4(p.z, p1.z, p2.z, 0.0f),
+                                         detail,
+                                         roughness);
+    *value = r.x;
+    *color = make_float3(r.x, r.y, r.z);
+  }
+  else {
+    *value = fractal_noise_3d(p, detail, roughness);
+  }
+#else
   *value = fractal_noise_3d(p, detail, roughness);
   if (color_is_needed) {
     *color = make_float3(*value,
                          fractal_noise_3d(p + random_float3_offset(3.0f), detail, roughness),
                          fractal_noise_3d(p + random_float3_offset(4.0f), detail, roughness));
   }
+#endif
 }
 
 ccl_device void noise_texture_4d(float4 co,
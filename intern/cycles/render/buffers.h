@@ -151,6 +151,9 @@ class RenderTile {
 
   RenderBuffers *buffers;
 
+  /* Time the tile was acquired, for statistics. */
+  double start_time;
+
   RenderTile();
 
   int4 bounds() const
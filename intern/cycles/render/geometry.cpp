@@ -40,6 +40,7 @@
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
+#include "util/util_string.h"
 #include "util/util_task.h"
 
 CCL_NAMESPACE_BEGIN
@@ -242,6 +243,7 @@ void Geometry::compute_bvh(
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
       bparams.curve_subdivisions = params->curve_subdivisions();
+      bparams.use_compact_geometry = params->use_compact_geometry;
 
       delete bvh;
       bvh = BVH::create(bparams, geometry, objects, device);
@@ -768,6 +770,37 @@ void GeometryManager::device_update_attributes(Device *device,
         memcpy(attr->buffer.data(), param.data(), param.datasize());
       }
     }
+
+    /* add values hoisted out of shader graphs, evaluated for this object */
+    foreach (Node *node, geom->get_used_shaders()) {
+      Shader *shader = static_cast<Shader *>(node);
+
+      if (shader->graph == NULL) {
+        continue;
+      }
+
+      foreach (ShaderGraphObjectValue &value, shader->graph->object_values) {
+        if (!geom_requests.find(value.attribute) || values.find(value.attribute)) {
+          continue;
+        }
+
+        float3 result;
+        if (!shader->graph->evaluate_object_value(scene, value, object, &result)) {
+          /* Should not happen, folding was verified when the value was hoisted. */
+          result = zero_float3();
+        }
+
+        attributes.add(value.attribute);
+
+        Attribute *attr = values.add(value.attribute, value.type, ATTR_ELEMENT_OBJECT);
+        if (value.type == TypeDesc::TypeFloat) {
+          attr->data_float()[0] = result.x;
+        }
+        else {
+          attr->data_float3()[0] = result;
+        }
+      }
+    }
   }
 
   /* mesh attribute are stored in a single array per data type. here we fill
@@ -1068,9 +1101,14 @@ void GeometryManager::device_update_mesh(
     }
   }
 
+  const bool use_compact_geometry = scene->params.use_compact_geometry;
+
   /* Create mapping from triangle to primitive triangle array. */
   vector<uint> tri_prim_index(tri_size);
-  if (for_displacement) {
+  if (use_compact_geometry) {
+    /* Triangle vertices are fetched through the vertex indices, mapping is unused. */
+  }
+  else if (for_displacement) {
     /* For displacement kernels we do some trickery to make them believe
      * we've got all required data ready. However, that data is different
      * from final render kernels since we don't have BVH yet, so can't
@@ -1103,12 +1141,15 @@ void GeometryManager::device_update_mesh(
     uint4 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
+    float4 *vert_positions = (use_compact_geometry) ? dscene->prim_tri_verts.alloc(vert_size) :
+                                                      NULL;
 
     const bool copy_all_data = dscene->tri_shader.need_realloc() ||
                                dscene->tri_vindex.need_realloc() ||
                                dscene->tri_vnormal.need_realloc() ||
                                dscene->tri_patch.need_realloc() ||
-                               dscene->tri_patch_uv.need_realloc();
+                               dscene->tri_patch_uv.need_realloc() ||
+                               (use_compact_geometry && dscene->prim_tri_verts.need_realloc());
 
     foreach (Geometry *geom, scene->geometry) {
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
@@ -1121,6 +1162,10 @@ void GeometryManager::device_update_mesh(
 
         if (mesh->verts_is_modified() || copy_all_data) {
           mesh->pack_normals(&vnormal[mesh->vert_offset]);
+
+          if (use_compact_geometry) {
+            mesh->pack_vertex_positions(&vert_positions[mesh->vert_offset]);
+          }
         }
 
         if (mesh->triangles_is_modified() || mesh->vert_patch_uv_is_modified() || copy_all_data) {
@@ -1145,6 +1190,20 @@ void GeometryManager::device_update_mesh(
     dscene->tri_vindex.copy_to_device_if_modified();
     dscene->tri_patch.copy_to_device_if_modified();
     dscene->tri_patch_uv.copy_to_device_if_modified();
+
+    if (use_compact_geometry) {
+      dscene->prim_tri_verts.copy_to_device_if_modified();
+
+      if (!for_displacement) {
+        /* Report against the per-triangle storage used without compact geometry. */
+        const size_t full_size = (tri_size * 3) * sizeof(float4) + tri_size * sizeof(uint);
+        const size_t compact_size = vert_size * sizeof(float4);
+        const size_t saved_size = (full_size > compact_size) ? full_size - compact_size : 0;
+        VLOG(1) << "Compact geometry: " << string_human_readable_size(compact_size)
+                << " of triangle vertex storage, saved " << string_human_readable_size(saved_size)
+                << ".";
+      }
+    }
   }
 
   if (curve_size != 0) {
@@ -1207,7 +1266,7 @@ void GeometryManager::device_update_mesh(
     dscene->patches.copy_to_device();
   }
 
-  if (for_displacement) {
+  if (for_displacement && !use_compact_geometry) {
     float4 *prim_tri_verts = dscene->prim_tri_verts.alloc(tri_size * 3);
     foreach (Geometry *geom, scene->geometry) {
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
@@ -1244,6 +1303,7 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
   bparams.curve_subdivisions = scene->params.curve_subdivisions();
+  bparams.use_compact_geometry = scene->params.use_compact_geometry;
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
@@ -1280,13 +1340,18 @@ void GeometryManager::device_update_bvh(Device *device,
   else {
     progress.set_status("Updating Scene BVH", "Packing BVH primitives");
 
+    /* With compact geometry triangle vertices are packed with the mesh data instead. */
+    const bool pack_triangles = !scene->params.use_compact_geometry;
+
     size_t num_prims = 0;
     size_t num_tri_verts = 0;
     foreach (Geometry *geom, scene->geometry) {
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
         num_prims += mesh->num_triangles();
-        num_tri_verts += 3 * mesh->num_triangles();
+        if (pack_triangles) {
+          num_tri_verts += 3 * mesh->num_triangles();
+        }
       }
       else if (geom->is_hair()) {
         Hair *hair = static_cast<Hair *>(geom);
@@ -1299,7 +1364,9 @@ void GeometryManager::device_update_bvh(Device *device,
     if (pack_flags != PackFlags::PACK_ALL) {
       /* if we do not need to recreate the BVH, then only the vertices are updated, so we can
        * safely retake the memory */
-      dscene->prim_tri_verts.give_data(pack.prim_tri_verts);
+      if (pack_triangles) {
+        dscene->prim_tri_verts.give_data(pack.prim_tri_verts);
+      }
 
       if ((pack_flags & PackFlags::PACK_VISIBILITY) != 0) {
         dscene->prim_visibility.give_data(pack.prim_visibility);
@@ -1308,8 +1375,10 @@ void GeometryManager::device_update_bvh(Device *device,
     else {
       /* It is not strictly necessary to skip those resizes we if do not have to repack, as the OS
        * will not allocate pages if we do not touch them, however it does help catching bugs. */
-      pack.prim_tri_index.resize(num_prims);
-      pack.prim_tri_verts.resize(num_tri_verts);
+      if (pack_triangles) {
+        pack.prim_tri_index.resize(num_prims);
+        pack.prim_tri_verts.resize(num_tri_verts);
+      }
       pack.prim_type.resize(num_prims);
       pack.prim_index.resize(num_prims);
       pack.prim_object.resize(num_prims);
@@ -1336,7 +1405,10 @@ void GeometryManager::device_update_bvh(Device *device,
        */
       PackFlags geom_pack_flags = pack_flags;
 
-      if (geom->is_modified()) {
+      if (!pack_triangles) {
+        geom_pack_flags = static_cast<PackFlags>(geom_pack_flags & ~PackFlags::PACK_VERTICES);
+      }
+      else if (geom->is_modified()) {
         geom_pack_flags |= PackFlags::PACK_VERTICES;
       }
 
@@ -1400,6 +1472,7 @@ void GeometryManager::device_update_bvh(Device *device,
 
   dscene->data.bvh.root = pack.root_index;
   dscene->data.bvh.use_bvh_steps = (scene->params.num_bvh_time_steps != 0);
+  dscene->data.bvh.use_compact_geometry = scene->params.use_compact_geometry;
   dscene->data.bvh.curve_subdivisions = scene->params.curve_subdivisions();
   /* The scene handle is set in 'CPUDevice::const_copy_to' and 'OptiXDevice::const_copy_to' */
   dscene->data.bvh.scene = 0;
@@ -18,6 +18,7 @@
 #include "render/attribute.h"
 #include "render/constant_fold.h"
 #include "render/nodes.h"
+#include "render/object.h"
 #include "render/scene.h"
 #include "render/shader.h"
 
@@ -53,6 +54,54 @@ bool check_node_inputs_traversed(const ShaderNode *node, const ShaderNodeSet &do
   return true;
 }
 
+/* Object Info outputs which are constant over an object. The location follows
+ * the object under motion blur, and the material index depends on the shader. */
+bool is_object_value_source(ShaderOutput *output)
+{
+  if (output->parent->type != ObjectInfoNode::get_node_type()) {
+    return false;
+  }
+
+  const ustring name = output->name();
+  return (name == "Color" || name == "Object Index" || name == "Random");
+}
+
+/* Nodes which may be evaluated per object, whether they constant fold is checked
+ * separately. */
+bool is_object_value_node(const ShaderNode *node)
+{
+  if (node->special_type != SHADER_SPECIAL_TYPE_NONE &&
+      node->special_type != SHADER_SPECIAL_TYPE_AUTOCONVERT) {
+    return false;
+  }
+
+  foreach (const ShaderInput *in, node->inputs) {
+    if (in->socket_type.type == SocketType::CLOSURE) {
+      return false;
+    }
+  }
+  foreach (const ShaderOutput *out, node->outputs) {
+    if (out->socket_type.type == SocketType::CLOSURE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool check_node_outputs_invariant(const ShaderNode *node, const set<ShaderOutput *> &invariant)
+{
+  bool has_links = false;
+  foreach (ShaderOutput *out, node->outputs) {
+    if (!out->links.empty()) {
+      if (invariant.find(out) == invariant.end()) {
+        return false;
+      }
+      has_links = true;
+    }
+  }
+  return has_links;
+}
+
 } /* namespace */
 
 /* Sockets */
@@ -221,11 +270,18 @@ ShaderGraph::ShaderGraph()
   finalized = false;
   simplified = false;
   num_node_ids = 0;
+  use_object_values = false;
+  num_folded_outputs = 0;
+  num_deduplicated_nodes = 0;
+  num_removed_nodes = 0;
   add(create_node<OutputNode>());
 }
 
 ShaderGraph::~ShaderGraph()
 {
+  foreach (ShaderGraphObjectValue &value, object_values) {
+    delete value.graph;
+  }
   clear_nodes();
 }
 
@@ -364,6 +420,9 @@ void ShaderGraph::simplify(Scene *scene)
     expand();
     default_inputs(scene->shader_manager->use_osl());
     clean(scene);
+    if (use_object_values) {
+      hoist_object_values(scene);
+    }
     refine_bump_nodes();
 
     simplified = true;
@@ -577,6 +636,10 @@ void ShaderGraph::constant_fold(Scene *scene)
       /* Optimize current node. */
       ConstantFolder folder(this, node, output, scene);
       node->constant_fold(folder);
+
+      if (output->links.size() == 0) {
+        num_folded_outputs++;
+      }
     }
   }
 
@@ -674,6 +737,8 @@ void ShaderGraph::deduplicate_nodes()
   if (num_deduplicated > 0) {
     VLOG(1) << "Deduplicated " << num_deduplicated << " nodes.";
   }
+
+  num_deduplicated_nodes += num_deduplicated;
 }
 
 /* Check whether volume output has meaningful nodes, otherwise
@@ -718,6 +783,278 @@ void ShaderGraph::verify_volume_output()
   }
 }
 
+/* Object values.
+ *
+ * Nodes which only depend on Object Info outputs that are constant over an object
+ * are evaluated on the host for every object instead of at every shading point. */
+
+void ShaderGraph::hoist_object_values(Scene *scene)
+{
+  /* Attribute lookups make a volume heterogeneous, which is slower than what
+   * hoisting would save. */
+  if (output()->input("Volume")->link) {
+    return;
+  }
+
+  /* Find outputs which are constant over an object, in dependency order. An output
+   * qualifies when all linked inputs of its node do and it constant folds once the
+   * Object Info outputs are known. */
+  set<ShaderOutput *> invariant;
+  ShaderNodeSet done, scheduled;
+  queue<ShaderNode *> traverse_queue;
+
+  foreach (ShaderNode *node, nodes) {
+    if (!check_node_inputs_has_links(node)) {
+      traverse_queue.push(node);
+      scheduled.insert(node);
+    }
+  }
+
+  while (!traverse_queue.empty()) {
+    ShaderNode *node = traverse_queue.front();
+    traverse_queue.pop();
+    done.insert(node);
+
+    foreach (ShaderOutput *output, node->outputs) {
+      foreach (ShaderInput *input, output->links) {
+        if (scheduled.find(input->parent) == scheduled.end() &&
+            check_node_inputs_traversed(input->parent, done)) {
+          traverse_queue.push(input->parent);
+          scheduled.insert(input->parent);
+        }
+      }
+    }
+
+    if (node->type == ObjectInfoNode::get_node_type()) {
+      foreach (ShaderOutput *output, node->outputs) {
+        if (is_object_value_source(output)) {
+          invariant.insert(output);
+        }
+      }
+      continue;
+    }
+
+    if (!check_node_inputs_has_links(node) || !is_object_value_node(node)) {
+      continue;
+    }
+
+    bool inputs_invariant = true;
+    foreach (ShaderInput *input, node->inputs) {
+      if (input->link && invariant.find(input->link) == invariant.end()) {
+        inputs_invariant = false;
+        break;
+      }
+    }
+
+    if (!inputs_invariant) {
+      continue;
+    }
+
+    foreach (ShaderOutput *output, node->outputs) {
+      if (output->links.empty()) {
+        continue;
+      }
+
+      /* Fold with two different sets of values, some nodes only fold for specific ones. */
+      ShaderGraph *graph = copy_object_value_graph(output);
+      float3 value;
+      if (graph->fold_object_value(scene, zero_float3(), 0.0f, 0.0f, &value) &&
+          graph->fold_object_value(scene, one_float3(), 1.0f, 0.5f, &value)) {
+        invariant.insert(output);
+      }
+      delete graph;
+    }
+  }
+
+  /* Hoist outputs at the boundary of the constant part of the graph. Object Info
+   * outputs themselves are already as cheap as an attribute lookup. */
+  vector<ShaderOutput *> hoisted;
+
+  foreach (ShaderNode *node, nodes) {
+    if (node->type == ObjectInfoNode::get_node_type()) {
+      continue;
+    }
+
+    foreach (ShaderOutput *output, node->outputs) {
+      if (invariant.find(output) == invariant.end()) {
+        continue;
+      }
+
+      foreach (ShaderInput *input, output->links) {
+        if (!check_node_outputs_invariant(input->parent, invariant)) {
+          hoisted.push_back(output);
+          break;
+        }
+      }
+    }
+  }
+
+  if (hoisted.empty()) {
+    return;
+  }
+
+  /* Copy all values before relinking, as hoisted outputs may depend on each other. */
+  vector<ShaderGraphObjectValue> values;
+
+  foreach (ShaderOutput *output, hoisted) {
+    ShaderGraphObjectValue value;
+    value.graph = copy_object_value_graph(output);
+
+    if (output->type() == SocketType::FLOAT) {
+      value.type = TypeDesc::TypeFloat;
+    }
+    else if (output->type() == SocketType::COLOR) {
+      value.type = TypeDesc::TypeColor;
+    }
+    else {
+      value.type = TypeDesc::TypeVector;
+    }
+
+    /* Name the attribute after the nodes it is computed from, so recompiling the
+     * shader or using the same nodes in another shader gives the same attribute. */
+    MD5Hash md5;
+    foreach (ShaderNode *node, value.graph->nodes) {
+      node->hash(md5);
+      foreach (ShaderInput *input, node->inputs) {
+        int link_id = (input->link) ? input->link->parent->id : 0;
+        md5.append((uint8_t *)&link_id, sizeof(link_id));
+        md5.append((input->link) ? input->link->name().c_str() : "");
+      }
+    }
+    value.attribute = ustring("object_value:" + md5.get_hex());
+
+    values.push_back(value);
+  }
+
+  for (size_t i = 0; i < hoisted.size(); i++) {
+    ShaderOutput *output = hoisted[i];
+    ShaderGraphObjectValue &value = values[i];
+
+    AttributeNode *attr = create_node<AttributeNode>();
+    attr->set_attribute(value.attribute);
+    add(attr);
+
+    const char *attr_output = (output->type() == SocketType::FLOAT) ?
+                                  "Fac" :
+                                  (output->type() == SocketType::COLOR) ? "Color" : "Vector";
+    relink(output, attr->output(attr_output));
+
+    object_values.push_back(value);
+  }
+
+  VLOG(1) << "Hoisted " << hoisted.size() << " per-object values.";
+
+  /* Remove nodes which are no longer used by the shader. */
+  clean(scene);
+}
+
+ShaderGraph *ShaderGraph::copy_object_value_graph(ShaderOutput *output)
+{
+  ShaderNodeSet dependencies;
+  foreach (ShaderInput *input, output->parent->inputs) {
+    find_dependencies(dependencies, input);
+  }
+  dependencies.insert(output->parent);
+
+  ShaderGraph *graph = new ShaderGraph();
+  ShaderNodeMap nodes_copy;
+  graph->copy_nodes(dependencies, nodes_copy);
+
+  foreach (NodePair &pair, nodes_copy) {
+    graph->add(pair.second);
+  }
+
+  /* Connect to an AOV output, so the value is kept by constant folding. */
+  OutputAOVNode *aov = graph->create_node<OutputAOVNode>();
+  graph->add(aov);
+
+  ShaderOutput *value_out = nodes_copy[output->parent]->output(output->name());
+  graph->connect(value_out, aov->input((output->type() == SocketType::FLOAT) ? "Value" : "Color"));
+
+  return graph;
+}
+
+bool ShaderGraph::fold_object_value(
+    Scene *scene, float3 color, float pass_id, float random, float3 *r_value)
+{
+  /* Fold a copy, to keep this graph intact for other objects. */
+  ShaderNodeSet value_nodes;
+  foreach (ShaderNode *node, nodes) {
+    if (node != output()) {
+      value_nodes.insert(node);
+    }
+  }
+
+  ShaderGraph graph;
+  ShaderNodeMap nodes_copy;
+  graph.copy_nodes(value_nodes, nodes_copy);
+
+  OutputAOVNode *aov = NULL;
+  bool is_float = false;
+
+  foreach (NodePair &pair, nodes_copy) {
+    ShaderNode *node = graph.add(pair.second);
+
+    if (node->special_type == SHADER_SPECIAL_TYPE_OUTPUT_AOV) {
+      aov = static_cast<OutputAOVNode *>(node);
+      is_float = (aov->input("Value")->link != NULL);
+    }
+    else if (node->type == ObjectInfoNode::get_node_type()) {
+      /* Substitute outputs with the values of the object. */
+      foreach (ShaderOutput *output, node->outputs) {
+        foreach (ShaderInput *input, output->links) {
+          if (output->name() == "Color") {
+            input->set(color);
+          }
+          else if (output->name() == "Object Index") {
+            input->set(pass_id);
+          }
+          else if (output->name() == "Random") {
+            input->set(random);
+          }
+        }
+        graph.disconnect(output);
+      }
+    }
+  }
+
+  assert(aov != NULL);
+
+  graph.constant_fold(scene);
+
+  if (aov->input("Value")->link || aov->input("Color")->link) {
+    return false;
+  }
+
+  *r_value = (is_float) ? make_float3(aov->get_value()) : aov->get_color();
+  return true;
+}
+
+bool ShaderGraph::evaluate_object_value(Scene *scene,
+                                        ShaderGraphObjectValue &value,
+                                        const Object *object,
+                                        float3 *r_value)
+{
+  /* Same values as stored in the kernel object data for the Object Info node. */
+  ShaderGraphObjectValue::Key key;
+  key.color = object->get_color();
+  key.pass_id = object->get_pass_id();
+  key.random = object->get_random_id() * (1.0f / (float)0xFFFFFFFF);
+
+  map<ShaderGraphObjectValue::Key, float3>::iterator it = value.cache.find(key);
+  if (it != value.cache.end()) {
+    *r_value = it->second;
+    return true;
+  }
+
+  if (!value.graph->fold_object_value(scene, key.color, key.pass_id, key.random, r_value)) {
+    return false;
+  }
+
+  value.cache[key] = *r_value;
+  return true;
+}
+
 void ShaderGraph::break_cycles(ShaderNode *node, vector<bool> &visited, vector<bool> &on_stack)
 {
   visited[node->id] = true;
@@ -819,10 +1156,13 @@ void ShaderGraph::clean(Scene *scene)
   list<ShaderNode *> newnodes;
 
   foreach (ShaderNode *node, nodes) {
-    if (visited[node->id])
+    if (visited[node->id]) {
       newnodes.push_back(node);
-    else
+    }
+    else {
       delete_node(node);
+      num_removed_nodes++;
+    }
   }
 
   nodes = newnodes;
@@ -43,6 +43,7 @@ class OSLCompiler;
 class OutputNode;
 class ConstantFolder;
 class MD5Hash;
+class Object;
 
 /* Bump
  *
@@ -307,6 +308,43 @@ class ShaderNodeIDComparator {
 typedef set<ShaderNode *, ShaderNodeIDComparator> ShaderNodeSet;
 typedef map<ShaderNode *, ShaderNode *, ShaderNodeIDComparator> ShaderNodeMap;
 
+/* Object Value
+ *
+ * Output of a part of the graph that only depends on Object Info outputs which
+ * are constant over an object. The shader reads it as an object attribute, and
+ * its value is computed on the host for every object by constant folding a copy
+ * of the nodes, kept in a small graph with the value connected to an AOV output. */
+
+class ShaderGraphObjectValue {
+ public:
+  /* Object Info outputs the value was folded for. */
+  struct Key {
+    float3 color;
+    float pass_id;
+    float random;
+
+    bool operator<(const Key &other) const
+    {
+      if (color.x != other.color.x)
+        return color.x < other.color.x;
+      if (color.y != other.color.y)
+        return color.y < other.color.y;
+      if (color.z != other.color.z)
+        return color.z < other.color.z;
+      if (pass_id != other.pass_id)
+        return pass_id < other.pass_id;
+      return random < other.random;
+    }
+  };
+
+  ustring attribute;
+  TypeDesc type;
+  ShaderGraph *graph;
+
+  /* Folding copies the graph, so results are kept for objects which are updated again. */
+  map<Key, float3> cache;
+};
+
 /* Graph
  *
  * Shader graph of nodes. Also does graph manipulations for default inputs,
@@ -320,6 +358,16 @@ class ShaderGraph : public NodeOwner {
   bool simplified;
   string displacement_hash;
 
+  /* Hoist parts of the graph which are constant per object into object attributes,
+   * only possible when the shader is never evaluated without an object. */
+  bool use_object_values;
+  vector<ShaderGraphObjectValue> object_values;
+
+  /* Statistics of the graph simplification, for compilation reports. */
+  int num_folded_outputs;
+  int num_deduplicated_nodes;
+  int num_removed_nodes;
+
   ShaderGraph();
   ~ShaderGraph();
 
@@ -343,6 +391,11 @@ class ShaderGraph : public NodeOwner {
 
   int get_num_closures();
 
+  bool evaluate_object_value(Scene *scene,
+                             ShaderGraphObjectValue &value,
+                             const Object *object,
+                             float3 *r_value);
+
   void dump_graph(const char *filename);
 
   /* This function is used to create a node of a specified type instead of
@@ -383,6 +436,14 @@ class ShaderGraph : public NodeOwner {
   void simplify_settings(Scene *scene);
   void deduplicate_nodes();
   void verify_volume_output();
+  void hoist_object_values(Scene *scene);
+
+  ShaderGraph *copy_object_value_graph(ShaderOutput *output);
+  bool fold_object_value(Scene *scene,
+                         float3 color,
+                         float pass_id,
+                         float random,
+                         float3 *r_value);
 };
 
 CCL_NAMESPACE_END
@@ -513,7 +513,10 @@ void Hair::pack_primitives(PackedBVH *pack, int object, uint visibility, PackFla
   }
 
   if ((pack_flags & PACK_GEOMETRY) != 0) {
-    unsigned int *prim_tri_index = &pack->prim_tri_index[optix_prim_offset];
+    /* Triangle index mapping is not packed with compact geometry. */
+    unsigned int *prim_tri_index = (pack->prim_tri_index.size()) ?
+                                       &pack->prim_tri_index[optix_prim_offset] :
+                                       NULL;
     int *prim_type = &pack->prim_type[optix_prim_offset];
     int *prim_index = &pack->prim_index[optix_prim_offset];
     int *prim_object = &pack->prim_object[optix_prim_offset];
@@ -529,7 +532,9 @@ void Hair::pack_primitives(PackedBVH *pack, int object, uint visibility, PackFla
     for (size_t j = 0; j < num_curves(); ++j) {
       Curve curve = get_curve(j);
       for (size_t k = 0; k < curve.num_segments(); ++k, ++index) {
-        prim_tri_index[index] = -1;
+        if (prim_tri_index != NULL) {
+          prim_tri_index[index] = -1;
+        }
         prim_type[index] = PRIMITIVE_PACK_SEGMENT(type, k);
         // Each curve segment points back to its curve index
         prim_index[index] = j + prim_offset;
@@ -81,6 +81,7 @@ NODE_DEFINE(Integrator)
   SOCKET_BOOLEAN(sample_all_lights_direct, "Sample All Lights Direct", true);
   SOCKET_BOOLEAN(sample_all_lights_indirect, "Sample All Lights Indirect", true);
   SOCKET_FLOAT(light_sampling_threshold, "Light Sampling Threshold", 0.05f);
+  SOCKET_BOOLEAN(use_light_tree, "Use Light Tree", false);
 
   static NodeEnum method_enum;
   method_enum.insert("path", PATH);
@@ -306,6 +307,10 @@ void Integrator::tag_update(Scene *scene, uint32_t flag)
     tag_sampling_pattern_modified();
   }
 
+  if (use_light_tree_is_modified() || method_is_modified()) {
+    scene->light_manager->tag_update(scene, LightManager::INTEGRATOR_MODIFIED);
+  }
+
   if (filter_glossy_is_modified()) {
     foreach (Shader *shader, scene->shaders) {
       if (shader->has_integrator_dependency) {
@@ -20,6 +20,7 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -30,6 +31,7 @@
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
+#include "util/util_map.h"
 #include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
@@ -284,6 +286,27 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Flags to exclude mesh light triangles from ray types the object is not visible to. */
+static int object_light_shader_flag(Object *object)
+{
+  int shader_flag = 0;
+
+  if (!(object->get_visibility() & PATH_RAY_DIFFUSE)) {
+    shader_flag |= SHADER_EXCLUDE_DIFFUSE;
+  }
+  if (!(object->get_visibility() & PATH_RAY_GLOSSY)) {
+    shader_flag |= SHADER_EXCLUDE_GLOSSY;
+  }
+  if (!(object->get_visibility() & PATH_RAY_TRANSMIT)) {
+    shader_flag |= SHADER_EXCLUDE_TRANSMIT;
+  }
+  if (!(object->get_visibility() & PATH_RAY_VOLUME_SCATTER)) {
+    shader_flag |= SHADER_EXCLUDE_SCATTER;
+  }
+
+  return shader_flag;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -355,22 +378,9 @@ void LightManager::device_update_distribution(Device *,
     bool transform_applied = mesh->transform_applied;
     Transform tfm = object->get_tfm();
     int object_id = j;
-    int shader_flag = 0;
+    int shader_flag = object_light_shader_flag(object);
 
-    if (!(object->get_visibility() & PATH_RAY_DIFFUSE)) {
-      shader_flag |= SHADER_EXCLUDE_DIFFUSE;
-      use_light_visibility = true;
-    }
-    if (!(object->get_visibility() & PATH_RAY_GLOSSY)) {
-      shader_flag |= SHADER_EXCLUDE_GLOSSY;
-      use_light_visibility = true;
-    }
-    if (!(object->get_visibility() & PATH_RAY_TRANSMIT)) {
-      shader_flag |= SHADER_EXCLUDE_TRANSMIT;
-      use_light_visibility = true;
-    }
-    if (!(object->get_visibility() & PATH_RAY_VOLUME_SCATTER)) {
-      shader_flag |= SHADER_EXCLUDE_SCATTER;
+    if (shader_flag != 0) {
       use_light_visibility = true;
     }
 
@@ -537,6 +547,273 @@ void LightManager::device_update_distribution(Device *,
   }
 }
 
+void LightManager::device_update_light_tree(Device *,
+                                            DeviceScene *dscene,
+                                            Scene *scene,
+                                            Progress &progress)
+{
+  KernelIntegrator *kintegrator = &dscene->data.integrator;
+
+  kintegrator->use_light_tree = false;
+  kintegrator->num_light_tree_emitters = 0;
+  kintegrator->num_distant_lights = 0;
+  kintegrator->light_tree_pdf = 0.0f;
+
+  /* The tree replaces picking a single light from the distribution, branched path
+   * tracing keeps sampling lights as before. */
+  if (!kintegrator->use_direct_light || !scene->integrator->get_use_light_tree() ||
+      scene->integrator->get_method() != Integrator::PATH) {
+    return;
+  }
+
+  progress.set_status("Updating Lights", "Building light tree");
+
+  vector<KernelLightTreeEmitter> emitters;
+  vector<LightTreePrimitive> prims;
+  map<Shader *, float> shader_energy;
+
+  /* Per object offset and primitive offset into the map from triangles to emitters,
+   * followed by the map itself. */
+  vector<int> triangles(scene->objects.size() * 2, -1);
+
+  for (size_t object_id = 0; object_id < scene->objects.size(); object_id++) {
+    if (progress.get_cancel())
+      return;
+
+    Object *object = scene->objects[object_id];
+
+    if (!object_usable_as_light(object)) {
+      continue;
+    }
+
+    Mesh *mesh = static_cast<Mesh *>(object->get_geometry());
+    bool transform_applied = mesh->transform_applied;
+    Transform tfm = object->get_tfm();
+    int shader_flag = object_light_shader_flag(object);
+
+    size_t mesh_num_triangles = mesh->num_triangles();
+    size_t offset = triangles.size();
+
+    triangles[object_id * 2] = offset;
+    triangles[object_id * 2 + 1] = mesh->prim_offset;
+    triangles.resize(offset + mesh_num_triangles, -1);
+
+    for (size_t i = 0; i < mesh_num_triangles; i++) {
+      int shader_index = mesh->get_shader()[i];
+      Shader *shader = (shader_index < mesh->get_used_shaders().size()) ?
+                           static_cast<Shader *>(mesh->get_used_shaders()[shader_index]) :
+                           scene->default_surface;
+
+      if (!(shader->get_use_mis() && shader->has_surface_emission)) {
+        continue;
+      }
+
+      Mesh::Triangle t = mesh->get_triangle(i);
+      if (!t.valid(&mesh->get_verts()[0])) {
+        continue;
+      }
+
+      float3 p1 = mesh->get_verts()[t.v[0]];
+      float3 p2 = mesh->get_verts()[t.v[1]];
+      float3 p3 = mesh->get_verts()[t.v[2]];
+
+      if (!transform_applied) {
+        p1 = transform_point(&tfm, p1);
+        p2 = transform_point(&tfm, p2);
+        p3 = transform_point(&tfm, p3);
+      }
+
+      float area = triangle_area(p1, p2, p3);
+      if (area == 0.0f) {
+        continue;
+      }
+
+      /* Estimate the emitted power from constant emission, otherwise only from area. */
+      if (shader_energy.find(shader) == shader_energy.end()) {
+        float3 emission;
+        shader_energy[shader] = shader->is_constant_emission(&emission) ?
+                                    fabsf(average(emission)) :
+                                    1.0f;
+      }
+
+      LightTreePrimitive prim;
+      prim.bbox = BoundBox::empty;
+      prim.bbox.grow(p1);
+      prim.bbox.grow(p2);
+      prim.bbox.grow(p3);
+      /* Mesh lights emit from both sides. */
+      prim.bcone.axis = safe_normalize(cross(p2 - p1, p3 - p1));
+      prim.bcone.theta_o = M_PI_F;
+      prim.bcone.theta_e = M_PI_2_F;
+      prim.energy = area * shader_energy[shader];
+      prim.index = emitters.size();
+      prims.push_back(prim);
+
+      KernelLightTreeEmitter kemitter;
+      kemitter.leaf_pdf = 0.0f;
+      kemitter.invarea = 1.0f / area;
+      kemitter.prim = i + mesh->prim_offset;
+      kemitter.shader_flag = shader_flag;
+      kemitter.object_id = object_id;
+      kemitter.leaf = -1;
+      kemitter.pad1 = 0;
+      kemitter.pad2 = 0;
+      emitters.push_back(kemitter);
+
+      triangles[offset + i] = prim.index;
+    }
+  }
+
+  /* Lights, distant and background lights can't be bounded and are kept out of the tree. */
+  vector<int> distant_lights;
+  int light_index = 0;
+
+  foreach (Light *light, scene->lights) {
+    if (!light->is_enabled)
+      continue;
+
+    if (light->light_type == LIGHT_DISTANT || light->light_type == LIGHT_BACKGROUND) {
+      distant_lights.push_back(light_index);
+      light_index++;
+      continue;
+    }
+
+    LightTreePrimitive prim;
+    prim.bbox = BoundBox::empty;
+
+    if (light->light_type == LIGHT_AREA) {
+      float3 axisu = light->axisu * (light->sizeu * light->size);
+      float3 axisv = light->axisv * (light->sizev * light->size);
+      prim.bbox.grow(light->co - 0.5f * axisu - 0.5f * axisv);
+      prim.bbox.grow(light->co - 0.5f * axisu + 0.5f * axisv);
+      prim.bbox.grow(light->co + 0.5f * axisu - 0.5f * axisv);
+      prim.bbox.grow(light->co + 0.5f * axisu + 0.5f * axisv);
+      /* Area lights are one sided. */
+      prim.bcone.axis = safe_normalize(light->dir);
+      prim.bcone.theta_o = 0.0f;
+      prim.bcone.theta_e = M_PI_2_F;
+    }
+    else {
+      prim.bbox.grow(light->co, light->size);
+
+      if (light->light_type == LIGHT_SPOT) {
+        prim.bcone.axis = safe_normalize(light->dir);
+        prim.bcone.theta_o = 0.0f;
+        prim.bcone.theta_e = min(0.5f * light->spot_angle, M_PI_2_F);
+      }
+      else {
+        prim.bcone.axis = make_float3(0.0f, 0.0f, 1.0f);
+        prim.bcone.theta_o = M_PI_F;
+        prim.bcone.theta_e = M_PI_2_F;
+      }
+    }
+
+    prim.energy = fabsf(average(light->strength));
+    prim.index = emitters.size();
+    prims.push_back(prim);
+
+    KernelLightTreeEmitter kemitter;
+    kemitter.leaf_pdf = 0.0f;
+    kemitter.invarea = 1.0f;
+    kemitter.prim = ~light_index;
+    kemitter.shader_flag = 0;
+    kemitter.object_id = -1;
+    kemitter.leaf = -1;
+    kemitter.pad1 = 0;
+    kemitter.pad2 = 0;
+    emitters.push_back(kemitter);
+
+    light_index++;
+  }
+
+  /* Build tree. */
+  LightTree tree(prims, 8);
+
+  const vector<KernelLightTreeNode> &tree_nodes = tree.get_nodes();
+  const vector<LightTreePrimitive> &tree_prims = tree.get_prims();
+  const int num_tree_emitters = tree_prims.size();
+  const int num_distant_lights = distant_lights.size();
+
+  if (progress.get_cancel())
+    return;
+
+  /* Emitters in the order of the tree leaves, followed by distant lights. */
+  KernelLightTreeEmitter *kemitters = dscene->light_tree_emitters.alloc(num_tree_emitters +
+                                                                        num_distant_lights);
+  vector<int> emitter_index(num_tree_emitters);
+
+  for (int i = 0; i < num_tree_emitters; i++) {
+    kemitters[i] = emitters[tree_prims[i].index];
+    emitter_index[tree_prims[i].index] = i;
+  }
+
+  for (int node = 0; node < tree_nodes.size(); node++) {
+    const KernelLightTreeNode &knode = tree_nodes[node];
+
+    for (int i = knode.child_index; i < knode.child_index + knode.num_emitters; i++) {
+      kemitters[i].leaf = node;
+      kemitters[i].leaf_pdf = (knode.energy > 0.0f) ? tree_prims[i].energy / knode.energy :
+                                                      1.0f / knode.num_emitters;
+    }
+  }
+
+  for (int i = 0; i < num_distant_lights; i++) {
+    KernelLightTreeEmitter &kemitter = kemitters[num_tree_emitters + i];
+    kemitter.leaf_pdf = 0.0f;
+    kemitter.invarea = 1.0f;
+    kemitter.prim = ~distant_lights[i];
+    kemitter.shader_flag = 0;
+    kemitter.object_id = -1;
+    kemitter.leaf = -1;
+    kemitter.pad1 = 0;
+    kemitter.pad2 = 0;
+  }
+
+  KernelLightTreeNode *knodes = dscene->light_tree_nodes.alloc(tree_nodes.size());
+  std::copy(tree_nodes.begin(), tree_nodes.end(), knodes);
+
+  for (size_t i = scene->objects.size() * 2; i < triangles.size(); i++) {
+    if (triangles[i] != -1) {
+      triangles[i] = emitter_index[triangles[i]];
+    }
+  }
+
+  int *ktriangles = dscene->light_tree_triangles.alloc(triangles.size());
+  std::copy(triangles.begin(), triangles.end(), ktriangles);
+
+  /* Let lights find their emitter, for multiple importance sampling. */
+  KernelLight *klights = dscene->lights.data();
+
+  for (size_t i = 0; i < dscene->lights.size(); i++) {
+    klights[i].light_tree_emitter = -1;
+  }
+  for (int i = 0; i < num_tree_emitters; i++) {
+    if (kemitters[i].prim < 0) {
+      klights[~kemitters[i].prim].light_tree_emitter = i;
+    }
+  }
+
+  dscene->light_tree_nodes.copy_to_device();
+  dscene->light_tree_emitters.copy_to_device();
+  dscene->light_tree_triangles.copy_to_device();
+  dscene->lights.copy_to_device();
+
+  /* Distant lights are picked uniformly, with the same probability as all lights together
+   * in the tree if there are both. */
+  kintegrator->use_light_tree = true;
+  kintegrator->num_light_tree_emitters = num_tree_emitters;
+  kintegrator->num_distant_lights = num_distant_lights;
+  kintegrator->light_tree_pdf = (num_tree_emitters == 0) ? 0.0f :
+                                (num_distant_lights == 0) ? 1.0f :
+                                                            0.5f;
+  kintegrator->pdf_lights = (num_distant_lights > 0) ?
+                                (1.0f - kintegrator->light_tree_pdf) / num_distant_lights :
+                                0.0f;
+
+  VLOG(1) << "Light tree with " << tree_nodes.size() << " nodes for " << num_tree_emitters
+          << " emitters and " << num_distant_lights << " distant lights.";
+}
+
 static void background_cdf(
     int start, int end, int res_x, int res_y, const vector<float3> *pixels, float2 *cond_cdf)
 {
@@ -1007,6 +1284,10 @@ void LightManager::device_update(Device *device,
   if (progress.get_cancel())
     return;
 
+  device_update_light_tree(device, dscene, scene, progress);
+  if (progress.get_cancel())
+    return;
+
   if (need_update_background) {
     device_update_background(device, dscene, scene, progress);
     if (progress.get_cancel())
@@ -1027,6 +1308,9 @@ void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_ba
 {
   dscene->light_distribution.free();
   dscene->lights.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_triangles.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
     dscene->light_background_conditional_cdf.free();
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Orientation Bounds */
+
+void OrientationBounds::grow(const OrientationBounds &other)
+{
+  if (other.is_empty()) {
+    return;
+  }
+  if (is_empty()) {
+    *this = other;
+    return;
+  }
+
+  /* Merge the cones, see "Importance Sampling of Many Lights with Adaptive Tree
+   * Splitting" by Conty Estevez and Kulla. */
+  const OrientationBounds &a = (theta_o >= other.theta_o) ? *this : other;
+  const OrientationBounds &b = (theta_o >= other.theta_o) ? other : *this;
+
+  OrientationBounds result;
+  result.theta_e = max(a.theta_e, b.theta_e);
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    /* Cone a already contains cone b. */
+    result.axis = a.axis;
+    result.theta_o = a.theta_o;
+  }
+  else {
+    const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+
+    if (theta_o >= M_PI_F) {
+      result.axis = a.axis;
+      result.theta_o = M_PI_F;
+    }
+    else {
+      /* Rotate the axis of cone a towards cone b. */
+      const float theta_r = theta_o - a.theta_o;
+      const float3 ortho = safe_normalize(b.axis - dot(a.axis, b.axis) * a.axis);
+
+      result.axis = normalize(cosf(theta_r) * a.axis + sinf(theta_r) * ortho);
+      result.theta_o = theta_o;
+    }
+  }
+
+  *this = result;
+}
+
+/* Light Tree */
+
+LightTree::LightTree(const vector<LightTreePrimitive> &prims_, int max_prims_in_leaf_)
+    : prims(prims_), max_prims_in_leaf(max_prims_in_leaf_)
+{
+  if (prims.empty()) {
+    return;
+  }
+
+  nodes.reserve(2 * prims.size() / max_prims_in_leaf + 1);
+  recursive_build(0, prims.size());
+}
+
+int LightTree::recursive_build(int start, int end)
+{
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bbox = BoundBox::empty;
+  OrientationBounds bcone = OrientationBounds::empty();
+  float energy = 0.0f;
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = prims[i];
+    bbox.grow(prim.bbox);
+    centroid_bbox.grow(prim.bbox.center());
+    bcone.grow(prim.bcone);
+    energy += prim.energy;
+  }
+
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  KernelLightTreeNode &knode = nodes[node_index];
+  knode.bbox_min[0] = bbox.min.x;
+  knode.bbox_min[1] = bbox.min.y;
+  knode.bbox_min[2] = bbox.min.z;
+  knode.bbox_max[0] = bbox.max.x;
+  knode.bbox_max[1] = bbox.max.y;
+  knode.bbox_max[2] = bbox.max.z;
+  knode.energy = energy;
+  knode.axis[0] = bcone.axis.x;
+  knode.axis[1] = bcone.axis.y;
+  knode.axis[2] = bcone.axis.z;
+  knode.theta_o = bcone.theta_o;
+  knode.theta_e = bcone.theta_e;
+  knode.parent = -1;
+  knode.pad = 0;
+
+  if (end - start <= max_prims_in_leaf) {
+    knode.child_index = start;
+    knode.num_emitters = end - start;
+    return node_index;
+  }
+
+  /* Median split along the largest extent of the centroids. When all centroids
+   * coincide, still split to keep leaves small. */
+  const int middle = (start + end) / 2;
+  const float3 extent = centroid_bbox.size();
+
+  if (max3(extent) > 0.0f) {
+    const int axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 :
+                     (extent.y >= extent.z)                         ? 1 :
+                                                                      2;
+    std::nth_element(prims.begin() + start,
+                     prims.begin() + middle,
+                     prims.begin() + end,
+                     [axis](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                       return a.bbox.center()[axis] < b.bbox.center()[axis];
+                     });
+  }
+
+  /* Note that the node reference may be invalidated by building children. */
+  const int left_index = recursive_build(start, middle);
+  const int right_index = recursive_build(middle, end);
+
+  nodes[node_index].child_index = right_index;
+  nodes[node_index].num_emitters = 0;
+  nodes[left_index].parent = node_index;
+  nodes[right_index].parent = node_index;
+
+  return node_index;
+}
+
+CCL_NAMESPACE_END
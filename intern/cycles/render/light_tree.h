@@ -0,0 +1,96 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Orientation Bounds
+ *
+ * Cone around an axis containing the normals of emitters within theta_o, where
+ * every emitter emits light within theta_e of its normal. */
+
+struct OrientationBounds {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  static OrientationBounds empty()
+  {
+    OrientationBounds bounds;
+    bounds.axis = make_float3(0.0f, 0.0f, 1.0f);
+    bounds.theta_o = -1.0f;
+    bounds.theta_e = 0.0f;
+    return bounds;
+  }
+
+  bool is_empty() const
+  {
+    return theta_o < 0.0f;
+  }
+
+  void grow(const OrientationBounds &other);
+};
+
+/* Light Tree Primitive
+ *
+ * Emitter to build the tree from, index refers to the list of emitters of the caller. */
+
+struct LightTreePrimitive {
+  BoundBox bbox;
+  OrientationBounds bcone;
+  float energy;
+  int index;
+};
+
+/* Light Tree
+ *
+ * Hierarchy of emitters for importance sampling many lights, stored in the layout
+ * used by the kernel. Primitives are reordered so that leaves reference contiguous
+ * ranges of them. */
+
+class LightTree {
+ public:
+  LightTree(const vector<LightTreePrimitive> &prims, int max_prims_in_leaf);
+
+  const vector<KernelLightTreeNode> &get_nodes() const
+  {
+    return nodes;
+  }
+
+  const vector<LightTreePrimitive> &get_prims() const
+  {
+    return prims;
+  }
+
+ protected:
+  int recursive_build(int start, int end);
+
+  vector<LightTreePrimitive> prims;
+  vector<KernelLightTreeNode> nodes;
+  int max_prims_in_leaf;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
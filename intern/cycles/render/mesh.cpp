@@ -729,6 +729,15 @@ void Mesh::pack_normals(float4 *vnormal)
   }
 }
 
+void Mesh::pack_vertex_positions(float4 *vert_positions)
+{
+  size_t verts_size = verts.size();
+
+  for (size_t i = 0; i < verts_size; i++) {
+    vert_positions[i] = float3_to_float4(verts[i]);
+  }
+}
+
 void Mesh::pack_verts(const vector<uint> &tri_prim_index,
                       uint4 *tri_vindex,
                       uint *tri_patch,
@@ -812,9 +821,6 @@ void Mesh::pack_primitives(ccl::PackedBVH *pack, int object, uint visibility, Pa
 
   const size_t num_prims = num_triangles();
 
-  /* Use prim_offset for indexing as it is computed per geometry type, and prim_tri_verts does not
-   * contain data for Hair geometries. */
-  float4 *prim_tri_verts = &pack->prim_tri_verts[prim_offset * 3];
   // 'pack->prim_time' is unused by Embree and OptiX
 
   uint type = has_motion_blur() ? PRIMITIVE_MOTION_TRIANGLE : PRIMITIVE_TRIANGLE;
@@ -829,14 +835,19 @@ void Mesh::pack_primitives(ccl::PackedBVH *pack, int object, uint visibility, Pa
 
   if ((pack_flags & PackFlags::PACK_GEOMETRY) != 0) {
     /* Use optix_prim_offset for indexing as those arrays also contain data for Hair geometries. */
-    unsigned int *prim_tri_index = &pack->prim_tri_index[optix_prim_offset];
+    /* Triangle index mapping is not packed with compact geometry. */
+    unsigned int *prim_tri_index = (pack->prim_tri_index.size()) ?
+                                       &pack->prim_tri_index[optix_prim_offset] :
+                                       NULL;
     int *prim_type = &pack->prim_type[optix_prim_offset];
     int *prim_index = &pack->prim_index[optix_prim_offset];
     int *prim_object = &pack->prim_object[optix_prim_offset];
 
     for (size_t k = 0; k < num_prims; ++k) {
       if ((pack_flags & PackFlags::PACK_GEOMETRY) != 0) {
-        prim_tri_index[k] = (prim_offset + k) * 3;
+        if (prim_tri_index != NULL) {
+          prim_tri_index[k] = (prim_offset + k) * 3;
+        }
         prim_type[k] = type;
         prim_index[k] = prim_offset + k;
         prim_object[k] = object;
@@ -845,6 +856,10 @@ void Mesh::pack_primitives(ccl::PackedBVH *pack, int object, uint visibility, Pa
   }
 
   if ((pack_flags & PackFlags::PACK_VERTICES) != 0) {
+    /* Use prim_offset for indexing as it is computed per geometry type, and prim_tri_verts does
+     * not contain data for Hair geometries. */
+    float4 *prim_tri_verts = &pack->prim_tri_verts[prim_offset * 3];
+
     for (size_t k = 0; k < num_prims; ++k) {
       const Mesh::Triangle t = get_triangle(k);
       prim_tri_verts[k * 3] = float3_to_float4(verts[t.v[0]]);
@@ -114,6 +114,9 @@ class DeviceScene {
   /* lights */
   device_vector<KernelLightDistribution> light_distribution;
   device_vector<KernelLight> lights;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<int> light_tree_triangles;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
 
@@ -176,6 +179,9 @@ class SceneParams {
   bool use_bvh_spatial_split;
   bool use_bvh_unaligned_nodes;
   int num_bvh_time_steps;
+  /* Store triangle vertices once per mesh vertex instead of once per triangle corner,
+   * trading some intersection speed for a much smaller memory footprint. */
+  bool use_compact_geometry;
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
@@ -190,6 +196,7 @@ class SceneParams {
     use_bvh_spatial_split = false;
     use_bvh_unaligned_nodes = true;
     num_bvh_time_steps = 0;
+    use_compact_geometry = false;
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
@@ -203,6 +210,7 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
+             use_compact_geometry == params.use_compact_geometry &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
              texture_limit == params.texture_limit);
   }
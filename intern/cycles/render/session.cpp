@@ -481,6 +481,7 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
   rtile.resolution = tile_manager.state.resolution_divider;
   rtile.tile_index = tile->index;
   rtile.stealing_state = RenderTile::NO_STEALING;
+  rtile.start_time = time_dt();
 
   if (tile->state == Tile::DENOISE) {
     rtile.task = RenderTile::DENOISE;
@@ -611,7 +612,7 @@ void Session::release_tile(RenderTile &rtile, const bool need_denoise)
     }
   }
 
-  progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
+  progress.add_finished_tile(rtile.task == RenderTile::DENOISE, time_dt() - rtile.start_time);
 
   bool delete_tile;
 
@@ -26,6 +26,7 @@
 #include "render/stats.h"
 #include "render/svm.h"
 
+#include "util/util_debug.h"
 #include "util/util_foreach.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
@@ -853,6 +854,19 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
   bool has_bump = (shader->get_displacement_method() != DISPLACE_TRUE) &&
                   output->input("Surface")->link && output->input("Displacement")->link;
 
+  /* Values that are constant per object can be hoisted into object attributes,
+   * which don't exist for the background and lights. */
+  if (!shader->graph->finalized) {
+    bool use_object_values = DebugFlags().shader_object_values && !background;
+    foreach (Light *light, scene->lights) {
+      if (light->get_shader() == shader) {
+        use_object_values = false;
+        break;
+      }
+    }
+    shader->graph->use_object_values = use_object_values;
+  }
+
   /* finalize */
   {
     scoped_timer timer((summary != NULL) ? &summary->time_finalize : NULL);
@@ -918,6 +932,10 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
     summary->time_total = time_dt() - time_start;
     summary->peak_stack_usage = max_stack_use;
     summary->num_svm_nodes = svm_nodes.size() - start_num_svm_nodes;
+    summary->num_folded_outputs = shader->graph->num_folded_outputs;
+    summary->num_deduplicated_nodes = shader->graph->num_deduplicated_nodes;
+    summary->num_removed_nodes = shader->graph->num_removed_nodes;
+    summary->num_object_values = shader->graph->object_values.size();
   }
 }
 
@@ -926,6 +944,10 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
 SVMCompiler::Summary::Summary()
     : num_svm_nodes(0),
       peak_stack_usage(0),
+      num_folded_outputs(0),
+      num_deduplicated_nodes(0),
+      num_removed_nodes(0),
+      num_object_values(0),
       time_finalize(0.0),
       time_generate_surface(0.0),
       time_generate_bump(0.0),
@@ -941,6 +963,12 @@ string SVMCompiler::Summary::full_report() const
   report += string_printf("Number of SVM nodes: %d\n", num_svm_nodes);
   report += string_printf("Peak stack usage:    %d\n", peak_stack_usage);
 
+  report += string_printf("Graph optimization:\n");
+  report += string_printf("  Folded outputs:    %d\n", num_folded_outputs);
+  report += string_printf("  Deduplicated:      %d\n", num_deduplicated_nodes);
+  report += string_printf("  Removed:           %d\n", num_removed_nodes);
+  report += string_printf("  Object values:     %d\n", num_object_values);
+
   report += string_printf("Time (in seconds):\n");
   report += string_printf("Finalize:            %f\n", time_finalize);
   report += string_printf("  Surface:           %f\n", time_generate_surface);
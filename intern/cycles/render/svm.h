@@ -72,6 +72,18 @@ class SVMCompiler {
     /* Peak stack usage during shader evaluation. */
     int peak_stack_usage;
 
+    /* Number of node outputs replaced by constant folding. */
+    int num_folded_outputs;
+
+    /* Number of nodes merged with identical nodes. */
+    int num_deduplicated_nodes;
+
+    /* Number of nodes removed from the graph as unused. */
+    int num_removed_nodes;
+
+    /* Number of values hoisted into per-object attributes. */
+    int num_object_values;
+
     /* Time spent on surface graph finalization. */
     double time_finalize;
 
@@ -120,7 +120,8 @@ void DebugFlags::OpenCL::reset()
   debug = (getenv("CYCLES_OPENCL_DEBUG") != NULL);
 }
 
-DebugFlags::DebugFlags() : viewport_static_bvh(false), running_inside_blender(false)
+DebugFlags::DebugFlags()
+    : viewport_static_bvh(false), shader_object_values(false), running_inside_blender(false)
 {
   /* Nothing for now. */
 }
@@ -128,6 +129,7 @@ DebugFlags::DebugFlags() : viewport_static_bvh(false), running_inside_blender(fa
 void DebugFlags::reset()
 {
   viewport_static_bvh = false;
+  shader_object_values = false;
   cpu.reset();
   cuda.reset();
   optix.reset();
@@ -33,6 +33,9 @@ class DebugFlags {
   /* Use static BVH in viewport, to match final render exactly. */
   bool viewport_static_bvh;
 
+  /* Hoist parts of shader graphs which are constant per object into object attributes. */
+  bool shader_object_values;
+
   bool running_inside_blender;
 
   /* Descriptor of CPU feature-set to be used. */
@@ -39,6 +39,8 @@ class Progress {
     current_tile_sample = 0;
     rendered_tiles = 0;
     denoised_tiles = 0;
+    render_tiles_time = 0.0;
+    denoise_tiles_time = 0.0;
     start_time = time_dt();
     render_start_time = time_dt();
     end_time = 0.0;
@@ -80,6 +82,8 @@ class Progress {
     current_tile_sample = 0;
     rendered_tiles = 0;
     denoised_tiles = 0;
+    render_tiles_time = 0.0;
+    denoise_tiles_time = 0.0;
     start_time = time_dt();
     render_start_time = time_dt();
     end_time = 0.0;
@@ -193,6 +197,8 @@ class Progress {
     current_tile_sample = 0;
     rendered_tiles = 0;
     denoised_tiles = 0;
+    render_tiles_time = 0.0;
+    denoise_tiles_time = 0.0;
   }
 
   void set_total_pixel_samples(uint64_t total_pixel_samples_)
@@ -226,18 +232,29 @@ class Progress {
     set_update();
   }
 
-  void add_finished_tile(bool denoised)
+  void add_finished_tile(bool denoised, double tile_time)
   {
     thread_scoped_lock lock(progress_mutex);
 
     if (denoised) {
       denoised_tiles++;
+      denoise_tiles_time += tile_time;
     }
     else {
       rendered_tiles++;
+      render_tiles_time += tile_time;
     }
   }
 
+  /* Time spent in tiles summed over all threads, so it can exceed the elapsed time. */
+  void get_tiles_time(double &render_time_, double &denoise_time_)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    render_time_ = render_tiles_time;
+    denoise_time_ = denoise_tiles_time;
+  }
+
   int get_current_sample()
   {
     thread_scoped_lock lock(progress_mutex);
@@ -367,6 +384,7 @@ class Progress {
    * Used to determine whether all but the last tile are finished rendering,
    * in which case the current_tile_sample is displayed. */
   int rendered_tiles, denoised_tiles;
+  double render_tiles_time, denoise_tiles_time;
 
   double start_time, render_start_time;
   /* End time written when render is done, so it doesn't keep increasing on redraws. */
@@ -288,6 +288,9 @@ void BKE_animsys_eval_driver(struct Depsgraph *depsgraph,
 
 void BKE_animsys_update_driver_array(struct ID *id);
 
+/* Free resolved paths of the active action F-Curves, cached by BKE_animsys_eval_animdata(). */
+void BKE_animsys_free_channel_bindings(struct AnimData *adt);
+
 /* ************************************* */
 
 #ifdef __cplusplus
@@ -74,6 +74,12 @@ typedef enum eCDAllocType {
   CD_REFERENCE = 3,
   /** Do a full copy of all layers, only allowed if source has same number of elements. */
   CD_DUPLICATE = 4,
+  /**
+   * Share the data of the source layers, which stay valid until all users are freed. Like
+   * referenced layers, shared layers have to be duplicated before they are modified. Layers that
+   * reference data they don't own are duplicated instead.
+   */
+  CD_SHARE = 5,
 } eCDAllocType;
 
 #define CD_TYPE_AS_MASK(_type) (CustomDataMask)((CustomDataMask)1 << (CustomDataMask)(_type))
@@ -105,7 +111,7 @@ bool CustomData_has_interp(const struct CustomData *data);
 bool CustomData_bmesh_has_free(const struct CustomData *data);
 
 /**
- * Checks if any of the customdata layers is referenced.
+ * Checks if any of the customdata layers is referenced or shared.
  */
 bool CustomData_has_referenced(const struct CustomData *data);
 
@@ -219,6 +225,7 @@ int CustomData_number_of_layers(const struct CustomData *data, int type);
 int CustomData_number_of_layers_typemask(const struct CustomData *data, CustomDataMask mask);
 
 /* duplicate data of a layer with flag NOFREE, and remove that flag.
+ * Shared layers are only duplicated when the data has other users.
  * returns the layer data */
 void *CustomData_duplicate_referenced_layer(struct CustomData *data,
                                             const int type,
@@ -231,6 +238,8 @@ void *CustomData_duplicate_referenced_layer_named(struct CustomData *data,
                                                   const int type,
                                                   const char *name,
                                                   const int totelem);
+/* duplicate the data of all shared layers that have other users */
+void CustomData_duplicate_shared_layers(struct CustomData *data, const int totelem);
 bool CustomData_is_referenced_layer(struct CustomData *data, int type);
 
 /* set the CD_FLAG_NOCOPY flag in custom data layers where the mask is
@@ -380,7 +389,9 @@ void CustomData_bmesh_set_n(
  */
 void CustomData_bmesh_set_layer_n(struct CustomData *data, void *block, int n, const void *source);
 
-/* set the pointer of to the first layer of type. the old data is not freed.
+/* set the pointer of to the first layer of type. the old data is not freed, unless the layer
+ * shares it (#CD_SHARE): then it is freed when no other layer uses it anymore. Callers that take
+ * over the old data have to call #CustomData_duplicate_referenced_layer first.
  * returns the value of ptr if the layer is found, NULL otherwise
  */
 void *CustomData_set_layer(const struct CustomData *data, int type, void *ptr);
@@ -32,6 +32,7 @@ extern "C" {
 struct ChannelDriver;
 struct FCM_EnvelopeData;
 struct FCurve;
+struct FCurveSegmentCache;
 struct FModifier;
 
 struct AnimData;
@@ -326,6 +327,14 @@ bool BKE_fcurve_is_empty(struct FCurve *fcu);
 float calculate_fcurve(struct PathResolvedRNA *anim_rna,
                        struct FCurve *fcu,
                        const struct AnimationEvalContext *anim_eval_context);
+float calculate_fcurve_with_segment_cache(struct PathResolvedRNA *anim_rna,
+                                          struct FCurve *fcu,
+                                          struct FCurveSegmentCache *segment_cache,
+                                          const struct AnimationEvalContext *anim_eval_context);
+
+/* Cache of per-keyframe-segment data for repeated evaluation of unchanged keyframes. */
+struct FCurveSegmentCache *BKE_fcurve_segment_cache_create(const struct FCurve *fcu);
+void BKE_fcurve_segment_cache_free(struct FCurveSegmentCache *segment_cache);
 
 /* ************* F-Curve Samples API ******************** */
 
@@ -350,6 +350,7 @@ class MeshComponent : public GeometryComponent {
 
   const Mesh *get_for_read() const;
   Mesh *get_for_write();
+  Mesh *get_for_write_keep_shared_layers();
 
   int attribute_domain_size(const AttributeDomain domain) const final;
   std::unique_ptr<blender::fn::GVArray> attribute_try_adapt_domain(
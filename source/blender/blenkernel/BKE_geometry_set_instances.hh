@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "BLI_function_ref.hh"
+
 #include "BKE_geometry_set.hh"
 
 namespace blender::bke {
@@ -49,6 +51,67 @@ void geometry_set_gather_instances(const GeometrySet &geometry_set,
 GeometrySet geometry_set_realize_mesh_for_modifier(const GeometrySet &geometry_set);
 GeometrySet geometry_set_realize_instances(const GeometrySet &geometry_set);
 
+/**
+ * Read-only view of the components of one type in all instances, as if the instances were
+ * realized. The elements of every instance are indexed after each other, in the order of the
+ * instance groups and their transforms. Unlike #geometry_set_realize_instances, no data is copied
+ * for every instance, so this should be used when the realized geometry is only read. The
+ * instance groups have to outlive the view and the virtual arrays created from it.
+ */
+class InstancesRealizedView {
+ private:
+  struct Group {
+    const GeometryComponent *component;
+    Span<float4x4> transforms;
+  };
+
+  /* Only groups that contain the component type are stored. */
+  Vector<Group> groups_;
+  int64_t instances_size_ = 0;
+
+ public:
+  InstancesRealizedView(Span<GeometryInstanceGroup> set_groups,
+                        GeometryComponentType component_type);
+
+  bool is_empty() const;
+  int64_t instances_size() const;
+  int64_t domain_size(AttributeDomain domain) const;
+
+  /**
+   * Virtual array of the attribute on all instances. Instances without the attribute use the
+   * default value. Positions are transformed, other attributes are passed through unchanged.
+   */
+  GVArrayPtr attribute_get_for_read(StringRef name,
+                                    AttributeDomain domain,
+                                    CustomDataType data_type,
+                                    const void *default_value = nullptr) const;
+
+  /**
+   * Same as above, but the caller provides the virtual array for every instanced component. The
+   * returned virtual array has to have the given domain and type.
+   */
+  GVArrayPtr attribute_get_for_read(
+      AttributeDomain domain,
+      const CPPType &type,
+      FunctionRef<GVArrayPtr(const GeometryComponent &component)> get_component_varray) const;
+
+  template<typename T>
+  fn::GVArray_Typed<T> attribute_get_for_read(StringRef name,
+                                              AttributeDomain domain,
+                                              const T &default_value) const
+  {
+    const CustomDataType type = cpp_type_to_custom_data_type(CPPType::get<T>());
+    return fn::GVArray_Typed<T>(this->attribute_get_for_read(name, domain, type, &default_value));
+  }
+
+ private:
+  GVArrayPtr attribute_get_for_read(
+      AttributeDomain domain,
+      const CPPType &type,
+      FunctionRef<GVArrayPtr(const GeometryComponent &component)> get_component_varray,
+      bool transform_positions) const;
+};
+
 struct AttributeKind {
   CustomDataType data_type;
   AttributeDomain domain;
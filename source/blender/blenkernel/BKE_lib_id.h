@@ -122,6 +122,11 @@ enum {
   LIB_ID_COPY_CD_REFERENCE = 1 << 20,
   /** Do not copy id->override_library, used by ID datablock override routines. */
   LIB_ID_COPY_NO_LIB_OVERRIDE = 1 << 21,
+  /**
+   * Mesh: Share CD data layers with the source, they are only copied when modified (see
+   * #CD_SHARE). Only for sources whose layers are never modified without being duplicated first.
+   */
+  LIB_ID_COPY_CD_SHARE = 1 << 22,
 
   /* *** XXX Hackish/not-so-nice specific behaviors needed for some corner cases. *** */
   /* *** Ideally we should not have those, but we need them for now... *** */
@@ -317,6 +322,7 @@ void BKE_id_blend_write(struct BlendWriter *writer, struct ID *id);
 
 /* lib_id_eval.c */
 void BKE_id_eval_properties_copy(struct ID *id_cow, struct ID *id);
+void BKE_id_eval_partial_copy(struct ID *id_cow, const struct ID *id, const int recalc);
 
 #ifdef __cplusplus
 }
@@ -124,6 +124,9 @@ void BKE_mesh_eval_delete(struct Mesh *mesh_eval);
 /* Performs copy for use during evaluation,
  * optional referencing original arrays to reduce memory. */
 struct Mesh *BKE_mesh_copy_for_eval(struct Mesh *source, bool reference);
+/* Performs copy for use during evaluation, sharing the custom data layers with the source until
+ * either of them is modified. */
+struct Mesh *BKE_mesh_copy_for_eval_shared(const struct Mesh *source);
 
 /* These functions construct a new Mesh,
  * contrary to BKE_mesh_from_nurbs which modifies ob itself. */
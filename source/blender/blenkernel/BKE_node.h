@@ -61,6 +61,7 @@ struct Main;
 struct Material;
 struct PointerRNA;
 struct RenderData;
+struct ReportList;
 struct Scene;
 struct SpaceNode;
 struct Tex;
@@ -525,6 +526,27 @@ void ntreeInterfaceTypeUpdate(struct bNodeTree *ntree);
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Node Execution Profiling
+ *
+ * Statistics of the last evaluation of geometry node trees by the active object and modifier,
+ * see `BKE_node_ui_storage.hh`.
+ * \{ */
+
+bool BKE_node_execution_info_get(const struct bContext *C,
+                                 const struct bNodeTree *ntree,
+                                 const struct bNode *node,
+                                 int *r_calls,
+                                 double *r_duration,
+                                 int64_t *r_output_geometry_size,
+                                 int64_t *r_memory_in_use);
+bool BKE_nodetree_execution_trace_write(const struct bContext *C,
+                                        const struct bNodeTree *root_ntree,
+                                        const char *filepath,
+                                        struct ReportList *reports);
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Generic API, Nodes
  * \{ */
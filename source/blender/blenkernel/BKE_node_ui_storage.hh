@@ -94,14 +94,50 @@ struct AvailableAttributeInfo {
   }
 };
 
+/**
+ * Measurements of the executions of a node during the last evaluation, to find out which nodes
+ * make the evaluation of a node tree slow.
+ */
+struct NodeExecutionInfo {
+  int calls = 0;
+  /** Total time spent executing the node in seconds. */
+  double duration = 0.0;
+  /** Number of points in all output geometries, summed over all calls. */
+  int64_t output_geometry_size = 0;
+  /**
+   * Memory in use by the guarded allocator right after the node was executed, the highest value
+   * of all calls. This is not the memory used by the node itself: it includes all other data, and
+   * memory allocated by nodes that are executed at the same time.
+   */
+  int64_t memory_in_use = 0;
+};
+
+/** A single execution of a node, used to write a timeline of the evaluation. */
+struct NodeExecutionEvent {
+  std::string tree_name;
+  std::string node_name;
+  /** Start and end of the execution in microseconds, relative to the start of the evaluation. */
+  int64_t start;
+  int64_t end;
+  /** Hash of the identifier of the thread that executed the node. */
+  uint64_t thread;
+};
+
 struct NodeUIStorage {
   blender::Vector<NodeWarning> warnings;
   blender::Set<AvailableAttributeInfo> attribute_hints;
+  NodeExecutionInfo execution_info;
 };
 
 struct NodeTreeUIStorage {
   std::mutex mutex;
   blender::Map<NodeTreeEvaluationContext, blender::Map<std::string, NodeUIStorage>> context_map;
+  /**
+   * Executions of all nodes during the last evaluation, including the nodes in nested groups.
+   * This is only stored for the root node tree of an evaluation.
+   */
+  blender::Map<NodeTreeEvaluationContext, blender::Vector<NodeExecutionEvent>>
+      execution_events_map;
 
   /**
    * Attribute search uses this to store the fake info for the string typed into a node, in order
@@ -131,3 +167,14 @@ void BKE_nodetree_attribute_hint_add(bNodeTree &ntree,
                                      const blender::StringRef attribute_name,
                                      const AttributeDomain domain,
                                      const CustomDataType data_type);
+
+void BKE_nodetree_node_execution_add(bNodeTree &ntree,
+                                     const NodeTreeEvaluationContext &context,
+                                     const bNode &node,
+                                     const double duration,
+                                     const int64_t output_geometry_size,
+                                     const int64_t memory_in_use);
+
+void BKE_nodetree_execution_event_add(bNodeTree &root_ntree,
+                                      const NodeTreeEvaluationContext &context,
+                                      NodeExecutionEvent event);
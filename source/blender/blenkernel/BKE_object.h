@@ -58,6 +58,7 @@ void BKE_object_workob_calc_parent(struct Depsgraph *depsgraph,
                                    struct Object *workob);
 
 void BKE_object_transform_copy(struct Object *ob_tar, const struct Object *ob_src);
+void BKE_object_transform_copy_for_eval(struct Object *ob_eval, const struct Object *ob_orig);
 void BKE_object_copy_softbody(struct Object *ob_dst, const struct Object *ob_src, const int flag);
 struct ParticleSystem *BKE_object_copy_particlesystem(struct ParticleSystem *psys, const int flag);
 void BKE_object_copy_particlesystems(struct Object *ob_dst,
@@ -0,0 +1,88 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <functional>
+#include <optional>
+
+#include "BLI_function_ref.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+struct Depsgraph;
+
+namespace blender::bke {
+
+/**
+ * Evaluates a sequence of frames for exporters, which need every frame of a range evaluated and
+ * handled in order.
+ *
+ * When the frames of the scene are independent of each other, several frames are evaluated at
+ * the same time, each on its own copy of the dependency graph. The copies are created on demand,
+ * as many as there are threads and as fit in the memory budget. The size of a copy is estimated
+ * from the memory used by the first one.
+ *
+ * Frames are considered dependent when the scene has a rigid body world or any object has a
+ * point cache (physics, particles), in which case all frames are evaluated one after another on
+ * the given dependency graph, like #BKE_scene_graph_update_for_newframe does.
+ *
+ * \note Frame change handlers are not called for frames which are evaluated on copies, and the
+ * frame of the original scene is not changed for them. Evaluation has to get the frame from the
+ * dependency graph (#DEG_get_ctime) or from the evaluated scene.
+ */
+class SceneFramesEvaluator {
+ public:
+  /** Builds the relations of a new dependency graph the same way as the given one was built. */
+  using BuildFn = std::function<void(Depsgraph *depsgraph)>;
+  /** Is called in frame order. Returning false stops evaluation of the remaining frames. */
+  using FrameFn = FunctionRef<bool(Depsgraph *depsgraph, double frame)>;
+
+ private:
+  Depsgraph *depsgraph_;
+  BuildFn build_fn_;
+  int64_t memory_budget_;
+  bool use_copies_;
+  bool copies_created_ = false;
+  /* The given dependency graph followed by its copies. */
+  Vector<Depsgraph *> depsgraphs_;
+  /* Frame at which each of the graphs is evaluated, if it is known. */
+  Vector<std::optional<double>> evaluated_frames_;
+
+ public:
+  /**
+   * \param depsgraph: Fully evaluated dependency graph, which is used for the first frames.
+   * \param memory_budget: Bytes which may be used by the copies, zero disables parallel frames.
+   */
+  SceneFramesEvaluator(Depsgraph *depsgraph, BuildFn build_fn, int64_t memory_budget);
+  ~SceneFramesEvaluator();
+
+  SceneFramesEvaluator(const SceneFramesEvaluator &other) = delete;
+  SceneFramesEvaluator &operator=(const SceneFramesEvaluator &other) = delete;
+
+  /** Evaluate the frames, which are expected to be sorted, and pass them to the callback. */
+  void foreach_frame(Span<double> frames, FrameFn frame_fn);
+
+ private:
+  void create_copies(double first_frame, int64_t frames_num);
+  void foreach_frame_sequential(Span<double> frames, FrameFn frame_fn);
+};
+
+}  // namespace blender::bke
@@ -71,6 +71,8 @@
 
 #include "BLO_read_write.h"
 
+#include "atomic_ops.h"
+
 #include "CLG_log.h"
 
 static CLG_LogRef LOG = {"bke.action"};
@@ -92,6 +94,13 @@ static CLG_LogRef LOG = {"bke.action"};
 
 /*********************** Armature Datablock ***********************/
 
+/* Unique value for #bAction.fcurves_generation of new copies. */
+static unsigned int action_fcurves_generation_next(void)
+{
+  static unsigned int generation = 0;
+  return atomic_add_and_fetch_u(&generation, 1);
+}
+
 /**
  * Only copy internal data of Action ID from source
  * to already allocated/initialized destination.
@@ -143,6 +152,7 @@ static void action_copy_data(Main *UNUSED(bmain), ID *id_dst, const ID *id_src,
       }
     }
   }
+  action_dst->fcurves_generation = action_fcurves_generation_next();
 
   if (flag & LIB_ID_COPY_NO_PREVIEW) {
     action_dst->preview = NULL;
@@ -769,6 +769,140 @@ void animsys_evaluate_action(PointerRNA *ptr,
   animsys_evaluate_fcurves(ptr, &act->curves, anim_eval_context, flush_to_original);
 }
 
+/* ***************************************** */
+/* Channel Bindings
+ *
+ * Resolving RNA path of an F-Curve involves parsing of the path and property lookups. Doing this
+ * for every F-Curve on every evaluation is a big part of the playback time of rigs with many
+ * animated channels. For the dependency graph evaluation the resolved paths of the active action
+ * are stored in the evaluated AnimData, and evaluation goes over a flat array of F-Curves.
+ *
+ * The bindings are freed together with the AnimData, which happens when the ID is copied for
+ * evaluation again. Changes of the action itself are detected using its F-Curves generation.
+ *
+ * Since the keyframes can not change while the bindings are valid, they also hold a segment cache
+ * of every keyframed F-Curve. */
+
+typedef struct AnimChannelBinding {
+  FCurve *fcu;
+  PathResolvedRNA anim_rna;
+  /* Resolved path in the original ID, used for flushing values back. */
+  PathResolvedRNA orig_anim_rna;
+  bool has_orig_anim_rna;
+  struct FCurveSegmentCache *segment_cache;
+} AnimChannelBinding;
+
+typedef struct AnimChannelBindings {
+  /* Action the bindings were created for. */
+  const bAction *action;
+  unsigned int fcurves_generation;
+  /* Paths in the original ID are only resolved when values are to be flushed back. */
+  bool has_orig;
+
+  AnimChannelBinding *bindings;
+  int num_bindings;
+} AnimChannelBindings;
+
+void BKE_animsys_free_channel_bindings(AnimData *adt)
+{
+  AnimChannelBindings *channel_bindings = adt->channel_bindings;
+  if (channel_bindings == NULL) {
+    return;
+  }
+  for (int i = 0; i < channel_bindings->num_bindings; i++) {
+    BKE_fcurve_segment_cache_free(channel_bindings->bindings[i].segment_cache);
+  }
+  MEM_SAFE_FREE(channel_bindings->bindings);
+  MEM_freeN(channel_bindings);
+  adt->channel_bindings = NULL;
+}
+
+static bool animsys_channel_bindings_is_valid(const AnimChannelBindings *channel_bindings,
+                                              const bAction *act,
+                                              const bool flush_to_original)
+{
+  if (channel_bindings == NULL) {
+    return false;
+  }
+  if (channel_bindings->action != act ||
+      channel_bindings->fcurves_generation != act->fcurves_generation) {
+    return false;
+  }
+  return channel_bindings->has_orig || !flush_to_original;
+}
+
+static AnimChannelBindings *animsys_channel_bindings_ensure(PointerRNA *ptr,
+                                                            AnimData *adt,
+                                                            bAction *act,
+                                                            const bool flush_to_original)
+{
+  if (animsys_channel_bindings_is_valid(adt->channel_bindings, act, flush_to_original)) {
+    return adt->channel_bindings;
+  }
+  BKE_animsys_free_channel_bindings(adt);
+
+  PointerRNA ptr_orig;
+  const bool use_orig = flush_to_original && animsys_construct_orig_pointer_rna(ptr, &ptr_orig);
+
+  AnimChannelBindings *channel_bindings = MEM_callocN(sizeof(AnimChannelBindings), __func__);
+  channel_bindings->action = act;
+  channel_bindings->fcurves_generation = act->fcurves_generation;
+  channel_bindings->has_orig = flush_to_original;
+
+  const int num_fcurves = BLI_listbase_count(&act->curves);
+  if (num_fcurves != 0) {
+    channel_bindings->bindings = MEM_malloc_arrayN(
+        num_fcurves, sizeof(AnimChannelBinding), __func__);
+  }
+  LISTBASE_FOREACH (FCurve *, fcu, &act->curves) {
+    if (!is_fcurve_evaluatable(fcu)) {
+      continue;
+    }
+    AnimChannelBinding *binding = &channel_bindings->bindings[channel_bindings->num_bindings];
+    if (!BKE_animsys_rna_path_resolve(ptr, fcu->rna_path, fcu->array_index, &binding->anim_rna)) {
+      continue;
+    }
+    binding->fcu = fcu;
+    binding->has_orig_anim_rna = use_orig &&
+                                 BKE_animsys_rna_path_resolve(&ptr_orig,
+                                                              fcu->rna_path,
+                                                              fcu->array_index,
+                                                              &binding->orig_anim_rna);
+    binding->segment_cache = (fcu->driver == NULL) ? BKE_fcurve_segment_cache_create(fcu) : NULL;
+    channel_bindings->num_bindings++;
+  }
+
+  adt->channel_bindings = channel_bindings;
+  return channel_bindings;
+}
+
+/* Same as animsys_evaluate_action(), but uses bindings cached in the AnimData. Only to be used for
+ * the evaluated IDs, from the dependency graph evaluation. */
+static void animsys_evaluate_action_bindings(PointerRNA *ptr,
+                                             AnimData *adt,
+                                             const AnimationEvalContext *anim_eval_context,
+                                             const bool flush_to_original)
+{
+  bAction *act = adt->action;
+  if (act == NULL) {
+    return;
+  }
+
+  action_idcode_patch_check(ptr->owner_id, act);
+
+  const AnimChannelBindings *channel_bindings = animsys_channel_bindings_ensure(
+      ptr, adt, act, flush_to_original);
+  for (int i = 0; i < channel_bindings->num_bindings; i++) {
+    AnimChannelBinding *binding = &channel_bindings->bindings[i];
+    const float curval = calculate_fcurve_with_segment_cache(
+        &binding->anim_rna, binding->fcu, binding->segment_cache, anim_eval_context);
+    BKE_animsys_write_to_rna_path(&binding->anim_rna, curval);
+    if (flush_to_original && binding->has_orig_anim_rna) {
+      BKE_animsys_write_to_rna_path(&binding->orig_anim_rna, curval);
+    }
+  }
+}
+
 /* ***************************************** */
 /* NLA System - Evaluation */
 
@@ -3154,11 +3288,12 @@ static void animsys_evaluate_overrides(PointerRNA *ptr, AnimData *adt)
  * and that the flags for which parts of the anim-data settings need to be recalculated
  * have been set already by the depsgraph. Now, we use the recalc
  */
-void BKE_animsys_evaluate_animdata(ID *id,
-                                   AnimData *adt,
-                                   const AnimationEvalContext *anim_eval_context,
-                                   eAnimData_Recalc recalc,
-                                   const bool flush_to_original)
+static void animsys_evaluate_animdata(ID *id,
+                                      AnimData *adt,
+                                      const AnimationEvalContext *anim_eval_context,
+                                      eAnimData_Recalc recalc,
+                                      const bool flush_to_original,
+                                      const bool use_channel_bindings)
 {
   PointerRNA id_ptr;
 
@@ -3185,7 +3320,12 @@ void BKE_animsys_evaluate_animdata(ID *id,
     }
     /* evaluate Active Action only */
     else if (adt->action) {
-      animsys_evaluate_action(&id_ptr, adt->action, anim_eval_context, flush_to_original);
+      if (use_channel_bindings) {
+        animsys_evaluate_action_bindings(&id_ptr, adt, anim_eval_context, flush_to_original);
+      }
+      else {
+        animsys_evaluate_action(&id_ptr, adt->action, anim_eval_context, flush_to_original);
+      }
     }
   }
 
@@ -3207,6 +3347,15 @@ void BKE_animsys_evaluate_animdata(ID *id,
   animsys_evaluate_overrides(&id_ptr, adt);
 }
 
+void BKE_animsys_evaluate_animdata(ID *id,
+                                   AnimData *adt,
+                                   const AnimationEvalContext *anim_eval_context,
+                                   eAnimData_Recalc recalc,
+                                   const bool flush_to_original)
+{
+  animsys_evaluate_animdata(id, adt, anim_eval_context, recalc, flush_to_original, false);
+}
+
 /* Evaluation of all ID-blocks with Animation Data blocks - Animation Data Only
  *
  * This will evaluate only the animation info available in the animation data-blocks
@@ -3376,7 +3525,10 @@ void BKE_animsys_eval_animdata(Depsgraph *depsgraph, ID *id)
 
   const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(depsgraph,
                                                                                     ctime);
-  BKE_animsys_evaluate_animdata(id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original);
+  /* The evaluated ID is only animated by this operation, so it is safe to cache resolved paths
+   * in its animation data. */
+  animsys_evaluate_animdata(
+      id, adt, &anim_eval_context, ADT_RECALC_ANIM, flush_to_original, DEG_is_evaluated_id(id));
 }
 
 void BKE_animsys_update_driver_array(ID *id)
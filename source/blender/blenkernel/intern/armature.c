@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "BLT_translation.h"
 
@@ -2821,6 +2822,148 @@ void BKE_pose_where_is_bone(struct Depsgraph *depsgraph,
   BKE_pose_where_is_bone_tail(pchan);
 }
 
+/* Parallel solving of constraint-free poses. Only used by #BKE_pose_where_is(), which operators,
+ * drawing and exporters call outside of depsgraph evaluation. The depsgraph evaluates every bone
+ * as a separate operation and schedules independent bones in parallel itself, so animation
+ * playback does not go through this code. */
+
+/* Poses with less channels than this are solved serially, threading overhead is not worth it. */
+#define POSE_PARALLEL_MIN_CHANNELS 256
+/* Number of independent bone subtrees to split the hierarchy into before solving in parallel. */
+#define POSE_PARALLEL_MIN_SUBTREES 32
+
+typedef struct PoseSolveData {
+  struct Depsgraph *depsgraph;
+  Scene *scene;
+  Object *ob;
+  float ctime;
+  bPoseChannel **subtree_roots;
+} PoseSolveData;
+
+/* Solve the pose channel and compute its deform matrix (stored in chan_mat). Only valid when
+ * there are no constraints, so that the result only depends on the parent channel. */
+static void pose_solve_channel(const PoseSolveData *data, bPoseChannel *pchan)
+{
+  float imat[4][4];
+
+  BKE_pose_where_is_bone(data->depsgraph, data->scene, data->ob, pchan, data->ctime, true);
+
+  invert_m4_m4(imat, pchan->bone->arm_mat);
+  mul_m4_m4m4(pchan->chan_mat, pchan->pose_mat, imat);
+}
+
+static void pose_solve_subtree(const PoseSolveData *data, bPoseChannel *pchan)
+{
+  pose_solve_channel(data, pchan);
+
+  LISTBASE_FOREACH (Bone *, child_bone, &pchan->bone->childbase) {
+    bPoseChannel *child = BKE_pose_channel_find_name(data->ob->pose, child_bone->name);
+    if (child != NULL) {
+      pose_solve_subtree(data, child);
+    }
+  }
+}
+
+static void pose_solve_subtree_task(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const PoseSolveData *data = userdata;
+  pose_solve_subtree(data, data->subtree_roots[index]);
+}
+
+/* Bones of different subtrees only depend on each other via constraints and IK (which is a
+ * constraint as well), so without them the hierarchy can be solved in parallel. Constraints on
+ * any channel disable it for the whole pose. */
+static bool pose_can_solve_parallel(bPose *pose)
+{
+  int channels_len = 0;
+
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &pose->chanbase) {
+    if (pchan->bone == NULL || pchan->constraints.first != NULL) {
+      return false;
+    }
+    channels_len++;
+  }
+
+  return channels_len >= POSE_PARALLEL_MIN_CHANNELS;
+}
+
+/* Solve all channels and compute their deform matrices, by splitting the bone hierarchy into
+ * independent subtrees which are then solved in parallel. */
+static void pose_solve_parallel(struct Depsgraph *depsgraph, Scene *scene, Object *ob, float ctime)
+{
+  const int channels_len = BLI_listbase_count(&ob->pose->chanbase);
+  bPoseChannel **subtree_roots = MEM_malloc_arrayN(channels_len, sizeof(*subtree_roots), __func__);
+  bPoseChannel **children = MEM_malloc_arrayN(channels_len, sizeof(*children), __func__);
+  int subtree_roots_len = 0;
+
+  PoseSolveData data = {
+      .depsgraph = depsgraph,
+      .scene = scene,
+      .ob = ob,
+      .ctime = ctime,
+  };
+
+  /* Lookups of child channels from the tasks rely on the hash. */
+  BKE_pose_channels_hash_ensure(ob->pose);
+
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &ob->pose->chanbase) {
+    if (pchan->parent == NULL) {
+      subtree_roots[subtree_roots_len++] = pchan;
+    }
+  }
+
+  /* Rigs typically have a single root bone: solve the top of the hierarchy level by level until
+   * it branches into enough subtrees. */
+  while (subtree_roots_len > 0 && subtree_roots_len < POSE_PARALLEL_MIN_SUBTREES) {
+    int children_len = 0;
+
+    for (int i = 0; i < subtree_roots_len; i++) {
+      bPoseChannel *pchan = subtree_roots[i];
+      pose_solve_channel(&data, pchan);
+
+      LISTBASE_FOREACH (Bone *, child_bone, &pchan->bone->childbase) {
+        bPoseChannel *child = BKE_pose_channel_find_name(ob->pose, child_bone->name);
+        if (child != NULL) {
+          children[children_len++] = child;
+        }
+      }
+    }
+
+    SWAP(bPoseChannel **, subtree_roots, children);
+    subtree_roots_len = children_len;
+  }
+
+  data.subtree_roots = subtree_roots;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, subtree_roots_len, &data, pose_solve_subtree_task, &settings);
+
+  MEM_freeN(subtree_roots);
+  MEM_freeN(children);
+}
+
+/* Solve the pose and compute the deform matrices of all channels in parallel when possible.
+ * Returns false if the pose has to be solved by the regular loop. */
+static bool pose_where_is_parallel(struct Depsgraph *depsgraph,
+                                   Scene *scene,
+                                   Object *ob,
+                                   float ctime)
+{
+  if (!pose_can_solve_parallel(ob->pose)) {
+    return false;
+  }
+  /* Without constraints there are no IK trees either, only the flags need to be cleared. */
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &ob->pose->chanbase) {
+    pchan->flag &= ~(POSE_DONE | POSE_CHAIN | POSE_IKTREE | POSE_IKSPLINE);
+  }
+  pose_solve_parallel(depsgraph, scene, ob, ctime);
+  return true;
+}
+
 /* This only reads anim data from channels, and writes to channels */
 /* This is the only function adding poses */
 void BKE_pose_where_is(struct Depsgraph *depsgraph, Scene *scene, Object *ob)
@@ -2859,6 +3002,10 @@ void BKE_pose_where_is(struct Depsgraph *depsgraph, Scene *scene, Object *ob)
   else {
     invert_m4_m4(ob->imat, ob->obmat); /* imat is needed */
 
+    if (pose_where_is_parallel(depsgraph, scene, ob, ctime)) {
+      return;
+    }
+
     /* 1. clear flags */
     for (pchan = ob->pose->chanbase.first; pchan; pchan = pchan->next) {
       pchan->flag &= ~(POSE_DONE | POSE_CHAIN | POSE_IKTREE | POSE_IKSPLINE);
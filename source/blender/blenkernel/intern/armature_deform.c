@@ -35,6 +35,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_armature_types.h"
@@ -231,6 +232,99 @@ static void pchan_bone_deform(bPoseChannel *pchan,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Skinning Weights Cache
+ *
+ * Copy of the vertex weights of an evaluated mesh, stored contiguously in its runtime data.
+ * Deforming by an armature then reads the weights of consecutive vertices from one array instead
+ * of following the separately allocated #MDeformVert.dw of each vertex. The cache is kept until
+ * the geometry of the evaluated mesh is cleared, so it is reused while only the pose changes.
+ * \{ */
+
+typedef struct ArmatureSkinWeights {
+  /** Deform vertices the weights were copied from. */
+  const MDeformVert *dverts;
+  int dverts_len;
+  /** Weights of vertex `i` are `weights[offsets[i]]` up to `weights[offsets[i + 1]]`. */
+  int *offsets;
+  MDeformWeight *weights;
+} ArmatureSkinWeights;
+
+void BKE_armature_deform_skin_weights_discard(Mesh *mesh)
+{
+  ArmatureSkinWeights *skin_weights = mesh->runtime.skin_weights;
+
+  if (skin_weights != NULL) {
+    MEM_freeN(skin_weights->offsets);
+    MEM_SAFE_FREE(skin_weights->weights);
+    MEM_freeN(skin_weights);
+    mesh->runtime.skin_weights = NULL;
+  }
+}
+
+static ArmatureSkinWeights *armature_skin_weights_create(const MDeformVert *dverts,
+                                                         const int dverts_len)
+{
+  ArmatureSkinWeights *skin_weights = MEM_mallocN(sizeof(*skin_weights), __func__);
+  int *offsets = MEM_malloc_arrayN(dverts_len + 1, sizeof(*offsets), __func__);
+  int weights_len = 0;
+
+  for (int i = 0; i < dverts_len; i++) {
+    offsets[i] = weights_len;
+    weights_len += dverts[i].totweight;
+  }
+  offsets[dverts_len] = weights_len;
+
+  MDeformWeight *weights = NULL;
+  if (weights_len != 0) {
+    weights = MEM_malloc_arrayN(weights_len, sizeof(*weights), __func__);
+    for (int i = 0; i < dverts_len; i++) {
+      if (dverts[i].totweight != 0) {
+        memcpy(&weights[offsets[i]], dverts[i].dw, sizeof(*weights) * dverts[i].totweight);
+      }
+    }
+  }
+
+  skin_weights->dverts = dverts;
+  skin_weights->dverts_len = dverts_len;
+  skin_weights->offsets = offsets;
+  skin_weights->weights = weights;
+  return skin_weights;
+}
+
+/* Get the cached weights of an evaluated mesh, or NULL when the mesh does not own a cache. */
+static const ArmatureSkinWeights *armature_skin_weights_ensure(const Mesh *mesh)
+{
+  /* Only the copy-on-write mesh is kept unchanged across evaluations, original meshes are edited
+   * in-place and results of modifier evaluation are not reused. */
+  if (mesh->dvert == NULL || (mesh->id.tag & LIB_TAG_COPIED_ON_WRITE) == 0 ||
+      (mesh->id.tag & LIB_TAG_COPIED_ON_WRITE_EVAL_RESULT) != 0 ||
+      mesh->runtime.eval_mutex == NULL) {
+    return NULL;
+  }
+
+  Mesh_Runtime *runtime = (Mesh_Runtime *)&mesh->runtime;
+  ThreadMutex *mesh_eval_mutex = (ThreadMutex *)runtime->eval_mutex;
+  BLI_mutex_lock(mesh_eval_mutex);
+
+  ArmatureSkinWeights *skin_weights = runtime->skin_weights;
+  if (skin_weights != NULL &&
+      (skin_weights->dverts != mesh->dvert || skin_weights->dverts_len != mesh->totvert)) {
+    BKE_armature_deform_skin_weights_discard((Mesh *)mesh);
+    skin_weights = NULL;
+  }
+  if (skin_weights == NULL) {
+    skin_weights = armature_skin_weights_create(mesh->dvert, mesh->totvert);
+    runtime->skin_weights = skin_weights;
+  }
+
+  BLI_mutex_unlock(mesh_eval_mutex);
+
+  return skin_weights;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Armature Deform #BKE_armature_deform_coords API
  *
@@ -255,6 +349,9 @@ typedef struct ArmatureUserdata {
   const MDeformVert *dverts;
   int dverts_len;
 
+  /** Cached copy of the weights of `me_target` or `dverts`, when available. */
+  const ArmatureSkinWeights *skin_weights;
+
   bPoseChannel **pchan_from_defbase;
   int defbase_len;
 
@@ -420,6 +517,16 @@ static void armature_vert_task(void *__restrict userdata,
 {
   const ArmatureUserdata *data = userdata;
   const MDeformVert *dvert;
+  if (data->skin_weights != NULL && i < data->skin_weights->dverts_len) {
+    const ArmatureSkinWeights *skin_weights = data->skin_weights;
+    const int offset = skin_weights->offsets[i];
+    const MDeformVert dvert_cached = {
+        .dw = skin_weights->weights + offset,
+        .totweight = skin_weights->offsets[i + 1] - offset,
+    };
+    armature_vert_task_with_dvert(data, i, &dvert_cached);
+    return;
+  }
   if (data->use_dverts || data->armature_def_nr != -1) {
     if (data->me_target) {
       BLI_assert(i < data->me_target->totvert);
@@ -487,6 +594,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   bool use_dverts = false;
   int armature_def_nr;
   int cd_dvert_offset = -1;
+  const Mesh *me_weights = NULL;
 
   /* in editmode, or not an armature */
   if (arm->edbo || (ob_arm->pose == NULL)) {
@@ -513,6 +621,8 @@ static void armature_deform_coords_impl(const Object *ob_arm,
         if (dverts) {
           dverts_len = me->totvert;
         }
+        /* Same as the weights used by #armature_vert_task. */
+        me_weights = (me_target != NULL) ? me_target : me;
       }
     }
     else if (ob_target->type == OB_LATTICE) {
@@ -586,6 +696,10 @@ static void armature_deform_coords_impl(const Object *ob_arm,
           },
   };
 
+  if (me_weights != NULL && (use_dverts || armature_def_nr != -1)) {
+    data.skin_weights = armature_skin_weights_ensure(me_weights);
+  }
+
   float obinv[4][4];
   invert_m4_m4(obinv, ob_target->obmat);
 
@@ -0,0 +1,260 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_armature.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_action_types.h"
+#include "DNA_armature_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+
+#include "BLI_listbase.h"
+#include "BLI_math.h"
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_timeit.hh"
+
+namespace blender::bke::tests {
+
+struct ArmatureDeformTestContext {
+  bArmature arm;
+  bPose pose;
+  Object ob_arm;
+  Mesh mesh;
+  Object ob_mesh;
+  Bone *bones;
+  bPoseChannel *pchans;
+  bDeformGroup *defgroups;
+  int bones_num;
+};
+
+/* Every vertex is deformed by 4 random bones, with the weights allocated per vertex like the
+ * weights of a mesh read from a file. */
+static void test_armature_deform_init(ArmatureDeformTestContext *ctx,
+                                      RandomNumberGenerator *rng,
+                                      const int bones_num,
+                                      const int verts_num)
+{
+  ctx->bones_num = bones_num;
+  ctx->bones = static_cast<Bone *>(MEM_calloc_arrayN(bones_num, sizeof(Bone), __func__));
+  ctx->pchans = static_cast<bPoseChannel *>(
+      MEM_calloc_arrayN(bones_num, sizeof(bPoseChannel), __func__));
+  ctx->defgroups = static_cast<bDeformGroup *>(
+      MEM_calloc_arrayN(bones_num, sizeof(bDeformGroup), __func__));
+
+  for (int i = 0; i < bones_num; i++) {
+    Bone *bone = &ctx->bones[i];
+    bPoseChannel *pchan = &ctx->pchans[i];
+    BLI_snprintf(bone->name, sizeof(bone->name), "Bone.%d", i);
+    BLI_strncpy(pchan->name, bone->name, sizeof(pchan->name));
+    BLI_strncpy(ctx->defgroups[i].name, bone->name, sizeof(ctx->defgroups[i].name));
+    pchan->bone = bone;
+
+    const float axis[3] = {rng->get_float(), rng->get_float(), rng->get_float()};
+    float rot[3][3];
+    axis_angle_to_mat3(rot, axis, rng->get_float());
+    copy_m4_m3(pchan->chan_mat, rot);
+    pchan->chan_mat[3][0] = rng->get_float();
+    pchan->chan_mat[3][1] = rng->get_float();
+    pchan->chan_mat[3][2] = rng->get_float();
+    unit_m4(bone->arm_mat);
+    mat4_to_dquat(&pchan->runtime.deform_dual_quat, bone->arm_mat, pchan->chan_mat);
+
+    BLI_addtail(&ctx->arm.bonebase, bone);
+    BLI_addtail(&ctx->pose.chanbase, pchan);
+    BLI_addtail(&ctx->ob_mesh.defbase, &ctx->defgroups[i]);
+  }
+
+  ctx->ob_arm.type = OB_ARMATURE;
+  ctx->ob_arm.data = &ctx->arm;
+  ctx->ob_arm.pose = &ctx->pose;
+  unit_m4(ctx->ob_arm.obmat);
+
+  ctx->ob_mesh.type = OB_MESH;
+  ctx->ob_mesh.data = &ctx->mesh;
+  unit_m4(ctx->ob_mesh.obmat);
+
+  ctx->mesh.totvert = verts_num;
+  ctx->mesh.dvert = static_cast<MDeformVert *>(
+      MEM_calloc_arrayN(verts_num, sizeof(MDeformVert), __func__));
+  for (int i = 0; i < verts_num; i++) {
+    MDeformVert *dvert = &ctx->mesh.dvert[i];
+    dvert->totweight = 4;
+    dvert->dw = static_cast<MDeformWeight *>(
+        MEM_calloc_arrayN(dvert->totweight, sizeof(MDeformWeight), __func__));
+    for (int j = 0; j < dvert->totweight; j++) {
+      dvert->dw[j].def_nr = rng->get_int32(bones_num);
+      dvert->dw[j].weight = rng->get_float();
+    }
+  }
+  ctx->mesh.runtime.eval_mutex = BLI_mutex_alloc();
+}
+
+static void test_armature_deform_free(ArmatureDeformTestContext *ctx)
+{
+  BKE_armature_deform_skin_weights_discard(&ctx->mesh);
+  BLI_mutex_free(static_cast<ThreadMutex *>(ctx->mesh.runtime.eval_mutex));
+  for (int i = 0; i < ctx->mesh.totvert; i++) {
+    MEM_freeN(ctx->mesh.dvert[i].dw);
+  }
+  MEM_freeN(ctx->mesh.dvert);
+  MEM_freeN(ctx->defgroups);
+  MEM_freeN(ctx->pchans);
+  MEM_freeN(ctx->bones);
+}
+
+static float (*test_armature_deform_coords(RandomNumberGenerator *rng, const int verts_num))[3]
+{
+  float(*coords)[3] = static_cast<float(*)[3]>(
+      MEM_malloc_arrayN(verts_num, sizeof(float[3]), __func__));
+  for (int i = 0; i < verts_num; i++) {
+    coords[i][0] = (rng->get_float() - 0.5f) * 10;
+    coords[i][1] = (rng->get_float() - 0.5f) * 10;
+    coords[i][2] = (rng->get_float() - 0.5f) * 10;
+  }
+  return coords;
+}
+
+static void test_armature_deform(ArmatureDeformTestContext *ctx,
+                                 float (*coords)[3],
+                                 float (*deform_mats)[3][3],
+                                 const int deformflag)
+{
+  BKE_armature_deform_coords_with_mesh(&ctx->ob_arm,
+                                       &ctx->ob_mesh,
+                                       coords,
+                                       deform_mats,
+                                       ctx->mesh.totvert,
+                                       deformflag,
+                                       nullptr,
+                                       nullptr,
+                                       &ctx->mesh);
+}
+
+/* Only evaluated copies of meshes cache their weights, which has to give the same result as
+ * reading the weights of the mesh. */
+static void test_armature_deform_cached_matches(const int deformflag)
+{
+  const int verts_num = 1000;
+  ArmatureDeformTestContext ctx = {{{nullptr}}};
+  RandomNumberGenerator rng;
+  test_armature_deform_init(&ctx, &rng, 16, verts_num);
+
+  float(*coords)[3] = test_armature_deform_coords(&rng, verts_num);
+  float(*coords_cached)[3] = static_cast<float(*)[3]>(MEM_dupallocN(coords));
+  float(*deform_mats)[3][3] = static_cast<float(*)[3][3]>(
+      MEM_malloc_arrayN(verts_num, sizeof(float[3][3]), __func__));
+  float(*deform_mats_cached)[3][3] = static_cast<float(*)[3][3]>(
+      MEM_malloc_arrayN(verts_num, sizeof(float[3][3]), __func__));
+  for (int i = 0; i < verts_num; i++) {
+    unit_m3(deform_mats[i]);
+    unit_m3(deform_mats_cached[i]);
+  }
+
+  test_armature_deform(&ctx, coords, deform_mats, deformflag);
+  EXPECT_EQ(ctx.mesh.runtime.skin_weights, nullptr);
+
+  ctx.mesh.id.tag |= LIB_TAG_COPIED_ON_WRITE;
+  test_armature_deform(&ctx, coords_cached, deform_mats_cached, deformflag);
+  EXPECT_NE(ctx.mesh.runtime.skin_weights, nullptr);
+
+  for (int i = 0; i < verts_num; i++) {
+    EXPECT_V3_NEAR(coords_cached[i], coords[i], 0.0f);
+    EXPECT_M3_NEAR(deform_mats_cached[i], deform_mats[i], 0.0f);
+  }
+
+  MEM_freeN(coords);
+  MEM_freeN(coords_cached);
+  MEM_freeN(deform_mats);
+  MEM_freeN(deform_mats_cached);
+  test_armature_deform_free(&ctx);
+}
+
+TEST(armature_deform, cached_weights_match)
+{
+  test_armature_deform_cached_matches(ARM_DEF_VGROUP);
+}
+
+TEST(armature_deform, cached_weights_match_quaternion)
+{
+  test_armature_deform_cached_matches(ARM_DEF_VGROUP | ARM_DEF_QUATERNION);
+}
+
+/* Changing the weights of the mesh replaces the cache. */
+TEST(armature_deform, cached_weights_replaced)
+{
+  const int verts_num = 100;
+  ArmatureDeformTestContext ctx = {{{nullptr}}};
+  RandomNumberGenerator rng;
+  test_armature_deform_init(&ctx, &rng, 4, verts_num);
+  ctx.mesh.id.tag |= LIB_TAG_COPIED_ON_WRITE;
+
+  float(*coords)[3] = test_armature_deform_coords(&rng, verts_num);
+  test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  const ArmatureSkinWeights *skin_weights = ctx.mesh.runtime.skin_weights;
+  EXPECT_NE(skin_weights, nullptr);
+
+  test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  EXPECT_EQ(ctx.mesh.runtime.skin_weights, skin_weights);
+
+  MDeformVert *dverts = static_cast<MDeformVert *>(MEM_dupallocN(ctx.mesh.dvert));
+  MEM_freeN(ctx.mesh.dvert);
+  ctx.mesh.dvert = dverts;
+  test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  EXPECT_NE(ctx.mesh.runtime.skin_weights, nullptr);
+
+  MEM_freeN(coords);
+  test_armature_deform_free(&ctx);
+}
+
+static void test_armature_deform_performance(const int verts_num)
+{
+  ArmatureDeformTestContext ctx = {{{nullptr}}};
+  RandomNumberGenerator rng;
+  test_armature_deform_init(&ctx, &rng, 64, verts_num);
+  float(*coords)[3] = test_armature_deform_coords(&rng, verts_num);
+
+  {
+    SCOPED_TIMER("armature deform, mesh weights");
+    test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  }
+  ctx.mesh.id.tag |= LIB_TAG_COPIED_ON_WRITE;
+  {
+    SCOPED_TIMER("armature deform, creating cached weights");
+    test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  }
+  {
+    SCOPED_TIMER("armature deform, cached weights");
+    test_armature_deform(&ctx, coords, nullptr, ARM_DEF_VGROUP);
+  }
+
+  MEM_freeN(coords);
+  test_armature_deform_free(&ctx);
+}
+
+TEST(armature_deform_performance, performance_1000000)
+{
+  test_armature_deform_performance(1000000);
+}
+
+}  // namespace blender::bke::tests
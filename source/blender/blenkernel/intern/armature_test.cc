@@ -18,8 +18,22 @@
  */
 
 #include "BKE_armature.h"
+#include "BKE_idtype.h"
+#include "BKE_main.h"
+#include "BKE_object.h"
 
+#include "BLI_float4x4.hh"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_string.h"
+#include "BLI_vector.hh"
+
+#include "DNA_action_types.h"
+#include "DNA_armature_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "MEM_guardedalloc.h"
 
 #include "testing/testing.h"
 
@@ -157,4 +171,97 @@ TEST(vec_roll_to_mat3_normalized, Rotationmatrix)
   }
 }
 
+class PoseWhereIsTest : public testing::Test {
+ protected:
+  Main *bmain_;
+  bArmature *arm_;
+  Object *ob_;
+  int bones_len_ = 0;
+
+  void SetUp() override
+  {
+    BKE_idtype_init();
+    bmain_ = BKE_main_new();
+    arm_ = BKE_armature_add(bmain_, "Armature");
+    ob_ = BKE_object_add_only_object(bmain_, OB_ARMATURE, "Armature");
+    ob_->data = arm_;
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+  }
+
+  Bone *add_bone(Bone *parent, const float tail_x, const float roll)
+  {
+    Bone *bone = static_cast<Bone *>(MEM_callocN(sizeof(Bone), __func__));
+    BLI_snprintf(bone->name, sizeof(bone->name), "Bone.%d", bones_len_++);
+    const float tail[3] = {tail_x, 1.0f, 0.0f};
+    copy_v3_v3(bone->tail, tail);
+    bone->roll = roll;
+    bone->parent = parent;
+    BLI_addtail((parent) ? &parent->childbase : &arm_->bonebase, bone);
+    return bone;
+  }
+
+  /* A root bone which branches into 8 and then 64 chains of 4 bones, more than the pose needs to
+   * be solved in parallel subtrees. */
+  void build_rig()
+  {
+    Bone *root = this->add_bone(nullptr, 0.0f, 0.0f);
+    for (int i = 0; i < 8; i++) {
+      Bone *branch = this->add_bone(root, 0.1f * i, 0.2f);
+      for (int j = 0; j < 8; j++) {
+        Bone *bone = branch;
+        for (int k = 0; k < 4; k++) {
+          bone = this->add_bone(bone, -0.05f * j, 0.1f * k);
+        }
+      }
+    }
+    BKE_armature_where_is(arm_);
+    BKE_pose_ensure(bmain_, ob_, arm_, false);
+
+    int index = 0;
+    LISTBASE_FOREACH (bPoseChannel *, pchan, &ob_->pose->chanbase) {
+      pchan->rotmode = ROT_MODE_XYZ;
+      const float eul[3] = {0.01f * index, -0.02f * index, 0.03f};
+      copy_v3_v3(pchan->eul, eul);
+      pchan->loc[2] = 0.1f;
+      index++;
+    }
+  }
+};
+
+/* Channels without constraints are solved in parallel subtrees, which has to give the same result
+ * as solving them one by one in hierarchical order. */
+TEST_F(PoseWhereIsTest, ParallelMatchesSerial)
+{
+  Scene scene = {{nullptr}};
+  this->build_rig();
+  ASSERT_GE(BLI_listbase_count(&ob_->pose->chanbase), 256);
+
+  BKE_pose_where_is(nullptr, &scene, ob_);
+
+  Vector<float4x4> pose_mats;
+  Vector<float4x4> chan_mats;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &ob_->pose->chanbase) {
+    pose_mats.append(float4x4(pchan->pose_mat));
+    chan_mats.append(float4x4(pchan->chan_mat));
+    zero_m4(pchan->pose_mat);
+    zero_m4(pchan->chan_mat);
+  }
+
+  int index = 0;
+  LISTBASE_FOREACH (bPoseChannel *, pchan, &ob_->pose->chanbase) {
+    float imat[4][4];
+    BKE_pose_where_is_bone(nullptr, &scene, ob_, pchan, 0.0f, true);
+    invert_m4_m4(imat, pchan->bone->arm_mat);
+    mul_m4_m4m4(pchan->chan_mat, pchan->pose_mat, imat);
+
+    EXPECT_M4_NEAR(pchan->pose_mat, pose_mats[index].values, FLT_EPSILON);
+    EXPECT_M4_NEAR(pchan->chan_mat, chan_mats[index].values, FLT_EPSILON);
+    index++;
+  }
+}
+
 }  // namespace blender::bke::tests
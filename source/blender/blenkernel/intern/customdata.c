@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 /* Since we have versioning code here (CustomData_verify_versions()). */
 #define DNA_DEPRECATED_ALLOW
 
@@ -2093,6 +2095,96 @@ static bool customdata_typemap_is_valid(const CustomData *data)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/** \name Shared Layers
+ *
+ * Layers added with #CD_SHARE use the same data as the source layer. The data is freed when the
+ * last layer using it is freed, and copied when a layer using it is about to be modified while
+ * there are other users.
+ * \{ */
+
+typedef struct CustomDataSharing {
+  /* Number of layers that use the data. */
+  int users;
+} CustomDataSharing;
+
+static void customData_layer_free_data(CustomDataLayer *layer, int totelem)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+  if (typeInfo->free) {
+    typeInfo->free(layer->data, totelem, typeInfo->size);
+  }
+  MEM_freeN(layer->data);
+}
+
+static void *customData_layer_copy_data(const CustomDataLayer *layer, int totelem)
+{
+  /* MEM_dupallocN won't work in case of complex layers, like e.g.
+   * CD_MDEFORMVERT, which has pointers to allocated data...
+   * So in case a custom copy function is defined, use it!
+   */
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+  if (typeInfo->copy) {
+    void *dst_data = MEM_malloc_arrayN((size_t)totelem, typeInfo->size, "CD duplicate ref layer");
+    typeInfo->copy(layer->data, dst_data, totelem);
+    return dst_data;
+  }
+  return MEM_dupallocN(layer->data);
+}
+
+/**
+ * Add a user to the data of the layer. The layer is only modified when it wasn't shared before,
+ * which is done atomically, because the same source may be shared from multiple threads.
+ */
+static CustomDataSharing *customData_layer_add_sharing_user(CustomDataLayer *layer)
+{
+  if (layer->sharing == NULL) {
+    CustomDataSharing *sharing = MEM_callocN(sizeof(CustomDataSharing), __func__);
+    sharing->users = 1;
+    if (atomic_cas_ptr((void **)&layer->sharing, NULL, sharing) != NULL) {
+      MEM_freeN(sharing);
+    }
+  }
+  atomic_add_and_fetch_int32(&layer->sharing->users, 1);
+  return layer->sharing;
+}
+
+/** Remove the user of the layer, returns true if it was the last user of the data. */
+static bool customData_layer_remove_sharing_user(CustomDataLayer *layer)
+{
+  CustomDataSharing *sharing = layer->sharing;
+  layer->sharing = NULL;
+  if (atomic_sub_and_fetch_int32(&sharing->users, 1) == 0) {
+    MEM_freeN(sharing);
+    return true;
+  }
+  return false;
+}
+
+/** Make sure that the data of a shared layer is only used by this layer. */
+static void customData_layer_ensure_unshared(CustomDataLayer *layer, int totelem)
+{
+  if (layer->sharing == NULL) {
+    return;
+  }
+  if (layer->sharing->users == 1) {
+    /* This is the only user, so no other layer can add a user while it is modified. */
+    MEM_freeN(layer->sharing);
+    layer->sharing = NULL;
+    return;
+  }
+  void *data_old = layer->data;
+  layer->data = customData_layer_copy_data(layer, totelem);
+  CustomDataLayer layer_old = *layer;
+  layer_old.data = data_old;
+  if (customData_layer_remove_sharing_user(layer)) {
+    /* The other users were freed in the mean time. */
+    customData_layer_free_data(&layer_old, totelem);
+  }
+}
+
+/** \} */
+
 bool CustomData_merge(const struct CustomData *source,
                       struct CustomData *dest,
                       CustomDataMask mask,
@@ -2143,6 +2235,7 @@ bool CustomData_merge(const struct CustomData *source,
       case CD_ASSIGN:
       case CD_REFERENCE:
       case CD_DUPLICATE:
+      case CD_SHARE:
         data = layer->data;
         break;
       default:
@@ -2154,8 +2247,23 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
+    else if (alloctype == CD_SHARE) {
+      /* Data that is not owned by the source can't be shared, because it may be freed before the
+       * new layer. */
+      const bool can_share = !(flag & CD_FLAG_NOFREE) && data != NULL;
+      newlayer = customData_add_layer__internal(
+          dest, type, can_share ? CD_ASSIGN : CD_DUPLICATE, data, totelem, layer->name);
+      if (newlayer && can_share) {
+        newlayer->sharing = customData_layer_add_sharing_user(layer);
+      }
+    }
     else {
       newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
+      if (newlayer && alloctype == CD_ASSIGN) {
+        /* Transfer the ownership of the shared data. */
+        newlayer->sharing = layer->sharing;
+        layer->sharing = NULL;
+      }
     }
 
     if (newlayer) {
@@ -2184,6 +2292,11 @@ void CustomData_realloc(CustomData *data, int totelem)
       continue;
     }
     typeInfo = layerType_getInfo(layer->type);
+    if (layer->sharing) {
+      /* Shared data can't be reallocated in place, the number of elements is not passed in. */
+      customData_layer_ensure_unshared(layer,
+                                       (int)(MEM_allocN_len(layer->data) / typeInfo->size));
+    }
     layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
   }
 }
@@ -2205,18 +2318,15 @@ void CustomData_copy(const struct CustomData *source,
 
 static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
 {
-  const LayerTypeInfo *typeInfo;
-
-  if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
-    typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->free) {
-      typeInfo->free(layer->data, totelem, typeInfo->size);
+  if (layer->sharing) {
+    if (!customData_layer_remove_sharing_user(layer)) {
+      /* The data is still used by other layers. */
+      return;
     }
+  }
 
-    if (layer->data) {
-      MEM_freeN(layer->data);
-    }
+  if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+    customData_layer_free_data(layer, totelem);
   }
 }
 
@@ -2581,6 +2691,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].sharing = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2761,24 +2872,12 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
   CustomDataLayer *layer = &data->layers[layer_index];
 
   if (layer->flag & CD_FLAG_NOFREE) {
-    /* MEM_dupallocN won't work in case of complex layers, like e.g.
-     * CD_MDEFORMVERT, which has pointers to allocated data...
-     * So in case a custom copy function is defined, use it!
-     */
-    const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->copy) {
-      void *dst_data = MEM_malloc_arrayN(
-          (size_t)totelem, typeInfo->size, "CD duplicate ref layer");
-      typeInfo->copy(layer->data, dst_data, totelem);
-      layer->data = dst_data;
-    }
-    else {
-      layer->data = MEM_dupallocN(layer->data);
-    }
-
+    layer->data = customData_layer_copy_data(layer, totelem);
     layer->flag &= ~CD_FLAG_NOFREE;
   }
+  else {
+    customData_layer_ensure_unshared(layer, totelem);
+  }
 
   return layer->data;
 }
@@ -2813,6 +2912,13 @@ void *CustomData_duplicate_referenced_layer_named(CustomData *data,
   return customData_duplicate_referenced_layer_index(data, layer_index, totelem);
 }
 
+void CustomData_duplicate_shared_layers(CustomData *data, const int totelem)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    customData_layer_ensure_unshared(&data->layers[i], totelem);
+  }
+}
+
 bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 {
   /* get the layer index of the first layer of type */
@@ -2823,7 +2929,7 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
   CustomDataLayer *layer = &data->layers[layer_index];
 
-  return (layer->flag & CD_FLAG_NOFREE) != 0;
+  return (layer->flag & CD_FLAG_NOFREE) != 0 || layer->sharing != NULL;
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -3257,6 +3363,22 @@ const char *CustomData_get_layer_name(const CustomData *data, int type, int n)
   return (layer_index == -1) ? NULL : data->layers[layer_index].name;
 }
 
+/**
+ * The caller of #CustomData_set_layer takes care of the old data, except when it is shared: the
+ * caller can't know whether other layers still use it. So shared data stays with the other users,
+ * or is freed here when this layer was the last one using it.
+ */
+static void customData_layer_release_for_set(CustomDataLayer *layer)
+{
+  if (layer->sharing == NULL) {
+    return;
+  }
+  if (customData_layer_remove_sharing_user(layer) && layer->data) {
+    const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+    customData_layer_free_data(layer, (int)(MEM_allocN_len(layer->data) / typeInfo->size));
+  }
+}
+
 void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
 {
   /* get the layer index of the first layer of type */
@@ -3266,6 +3388,7 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
     return NULL;
   }
 
+  customData_layer_release_for_set(&data->layers[layer_index]);
   data->layers[layer_index].data = ptr;
 
   return ptr;
@@ -3279,6 +3402,7 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
     return NULL;
   }
 
+  customData_layer_release_for_set(&data->layers[layer_index]);
   data->layers[layer_index].data = ptr;
 
   return ptr;
@@ -3871,7 +3995,7 @@ bool CustomData_has_interp(const struct CustomData *data)
 bool CustomData_has_referenced(const struct CustomData *data)
 {
   for (int i = 0; i < data->totlayer; i++) {
-    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+    if ((data->layers[i].flag & CD_FLAG_NOFREE) || data->layers[i].sharing != NULL) {
       return true;
     }
   }
@@ -5189,6 +5313,7 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, int count)
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->sharing = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       BLO_read_data_address(reader, &layer->data);
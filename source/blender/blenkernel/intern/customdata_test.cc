@@ -0,0 +1,135 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+
+#include "DNA_customdata_types.h"
+
+namespace blender::bke::tests {
+
+class CustomDataSharingTest : public testing::Test {
+ protected:
+  static constexpr int totelem = 4;
+
+  CustomData source_;
+  unsigned int blocks_in_use_;
+
+  void SetUp() override
+  {
+    blocks_in_use_ = MEM_get_memory_blocks_in_use();
+
+    CustomData_reset(&source_);
+    float *values = static_cast<float *>(
+        CustomData_add_layer(&source_, CD_PROP_FLOAT, CD_CALLOC, nullptr, totelem));
+    for (int i = 0; i < totelem; i++) {
+      values[i] = float(i);
+    }
+  }
+
+  void TearDown() override
+  {
+    /* All data has to be freed exactly once when the last user is gone. */
+    EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use_);
+  }
+
+  float *source_values()
+  {
+    return static_cast<float *>(CustomData_get_layer(&source_, CD_PROP_FLOAT));
+  }
+};
+
+TEST_F(CustomDataSharingTest, CopySharesData)
+{
+  CustomData copy;
+  CustomData_copy(&source_, &copy, CD_MASK_PROP_FLOAT, CD_SHARE, totelem);
+
+  EXPECT_EQ(CustomData_get_layer(&copy, CD_PROP_FLOAT), this->source_values());
+  EXPECT_TRUE(CustomData_is_referenced_layer(&source_, CD_PROP_FLOAT));
+  EXPECT_TRUE(CustomData_is_referenced_layer(&copy, CD_PROP_FLOAT));
+
+  CustomData_free(&copy, totelem);
+  CustomData_free(&source_, totelem);
+}
+
+TEST_F(CustomDataSharingTest, FreeSourceFirst)
+{
+  CustomData copy;
+  CustomData_copy(&source_, &copy, CD_MASK_PROP_FLOAT, CD_SHARE, totelem);
+  CustomData_free(&source_, totelem);
+
+  /* The data stays valid for the remaining user. */
+  const float *values = static_cast<const float *>(CustomData_get_layer(&copy, CD_PROP_FLOAT));
+  EXPECT_EQ(values[3], 3.0f);
+
+  CustomData_free(&copy, totelem);
+}
+
+TEST_F(CustomDataSharingTest, DuplicateBeforeWrite)
+{
+  CustomData copy;
+  CustomData_copy(&source_, &copy, CD_MASK_PROP_FLOAT, CD_SHARE, totelem);
+
+  float *values = static_cast<float *>(
+      CustomData_duplicate_referenced_layer(&copy, CD_PROP_FLOAT, totelem));
+  EXPECT_NE(values, this->source_values());
+  EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_PROP_FLOAT));
+  values[0] = 10.0f;
+  EXPECT_EQ(this->source_values()[0], 0.0f);
+
+  /* The source is the only user left, so it doesn't have to copy. */
+  float *source_values = this->source_values();
+  EXPECT_EQ(CustomData_duplicate_referenced_layer(&source_, CD_PROP_FLOAT, totelem),
+            source_values);
+  EXPECT_FALSE(CustomData_is_referenced_layer(&source_, CD_PROP_FLOAT));
+
+  CustomData_free(&copy, totelem);
+  CustomData_free(&source_, totelem);
+}
+
+TEST_F(CustomDataSharingTest, SetLayerKeepsOtherUsers)
+{
+  CustomData copy;
+  CustomData_copy(&source_, &copy, CD_MASK_PROP_FLOAT, CD_SHARE, totelem);
+
+  float *new_values = static_cast<float *>(MEM_calloc_arrayN(totelem, sizeof(float), __func__));
+  CustomData_set_layer(&copy, CD_PROP_FLOAT, new_values);
+  EXPECT_FALSE(CustomData_is_referenced_layer(&copy, CD_PROP_FLOAT));
+
+  /* The source is still valid and now the only user of its data. */
+  EXPECT_EQ(this->source_values()[3], 3.0f);
+  CustomData_free(&source_, totelem);
+
+  CustomData_free(&copy, totelem);
+}
+
+TEST_F(CustomDataSharingTest, SetLayerFreesLastUser)
+{
+  CustomData copy;
+  CustomData_copy(&source_, &copy, CD_MASK_PROP_FLOAT, CD_SHARE, totelem);
+  CustomData_free(&source_, totelem);
+
+  /* The replaced data is not used by any other layer anymore, so it is freed. */
+  CustomData_set_layer(&copy, CD_PROP_FLOAT, nullptr);
+
+  CustomData_free(&copy, totelem);
+}
+
+}  // namespace blender::bke::tests
@@ -1773,6 +1773,98 @@ bool BKE_fcurve_bezt_subdivide_handles(struct BezTriple *bezt,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name F-Curve Segment Cache
+ *
+ * Evaluating a Bezier segment involves correcting its handles and setting up the polynomials
+ * before the root finding, and finding the segment needs a binary search. When the same keyframes
+ * are evaluated over and over (playback of the evaluated copy of an action) this is done once per
+ * segment, and the segment of the last evaluation is tried first.
+ *
+ * The cache does not own or observe the keyframes: it is up to the owner to free it when they
+ * change. As an extra safety the cache is not used once the keyframe array is reallocated.
+ * \{ */
+
+typedef struct FCurveSegment {
+  /* Start of the X polynomial and its coefficients, as computed by findzero(). */
+  float x_start;
+  float x_coeffs[3];
+  /* Coefficients of the Y polynomial, as computed by berekeny(). */
+  float y_coeffs[4];
+  /* All handles are on the same value, the segment is a flat line. */
+  bool is_flat;
+} FCurveSegment;
+
+typedef struct FCurveSegmentCache {
+  const BezTriple *bezt;
+  int totvert;
+  /* Segment `i` goes from keyframe `i` to keyframe `i + 1`. */
+  FCurveSegment *segments;
+  /* Index of the keyframe at the end of the last evaluated segment, 0 when unknown. */
+  int last_segment_end;
+} FCurveSegmentCache;
+
+FCurveSegmentCache *BKE_fcurve_segment_cache_create(const FCurve *fcu)
+{
+  if (fcu->bezt == NULL || fcu->totvert < 2) {
+    return NULL;
+  }
+
+  FCurveSegmentCache *segment_cache = MEM_mallocN(sizeof(*segment_cache), __func__);
+  segment_cache->bezt = fcu->bezt;
+  segment_cache->totvert = fcu->totvert;
+  segment_cache->segments = MEM_malloc_arrayN(
+      fcu->totvert - 1, sizeof(*segment_cache->segments), __func__);
+  segment_cache->last_segment_end = 0;
+
+  for (int i = 0; i < fcu->totvert - 1; i++) {
+    const BezTriple *prevbezt = &fcu->bezt[i];
+    const BezTriple *bezt = &fcu->bezt[i + 1];
+    FCurveSegment *segment = &segment_cache->segments[i];
+    float v1[2], v2[2], v3[2], v4[2];
+
+    copy_v2_v2(v1, prevbezt->vec[1]);
+    copy_v2_v2(v2, prevbezt->vec[2]);
+    copy_v2_v2(v3, bezt->vec[0]);
+    copy_v2_v2(v4, bezt->vec[1]);
+
+    segment->is_flat = fabsf(v1[1] - v4[1]) < FLT_EPSILON && fabsf(v2[1] - v3[1]) < FLT_EPSILON &&
+                       fabsf(v3[1] - v4[1]) < FLT_EPSILON;
+
+    BKE_fcurve_correct_bezpart(v1, v2, v3, v4);
+
+    segment->x_start = v1[0];
+    segment->x_coeffs[0] = 3.0f * (v2[0] - v1[0]);
+    segment->x_coeffs[1] = 3.0f * (v1[0] - 2.0f * v2[0] + v3[0]);
+    segment->x_coeffs[2] = v4[0] - v1[0] + 3.0f * (v2[0] - v3[0]);
+
+    segment->y_coeffs[0] = v1[1];
+    segment->y_coeffs[1] = 3.0f * (v2[1] - v1[1]);
+    segment->y_coeffs[2] = 3.0f * (v1[1] - 2.0f * v2[1] + v3[1]);
+    segment->y_coeffs[3] = v4[1] - v1[1] + 3.0f * (v2[1] - v3[1]);
+  }
+
+  return segment_cache;
+}
+
+void BKE_fcurve_segment_cache_free(FCurveSegmentCache *segment_cache)
+{
+  if (segment_cache == NULL) {
+    return;
+  }
+  MEM_freeN(segment_cache->segments);
+  MEM_freeN(segment_cache);
+}
+
+static bool fcurve_segment_cache_is_valid(const FCurveSegmentCache *segment_cache,
+                                          const FCurve *fcu)
+{
+  return segment_cache != NULL && segment_cache->bezt == fcu->bezt &&
+         segment_cache->totvert == fcu->totvert;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name F-Curve Evaluation
  * \{ */
@@ -1824,18 +1916,13 @@ static float fcurve_eval_keyframes_extrapolate(
   return endpoint_bezt->vec[1][1] - (fac * dx);
 }
 
-static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, float evaltime)
+static float fcurve_eval_keyframes_interpolate(FCurve *fcu,
+                                               BezTriple *bezts,
+                                               FCurveSegmentCache *segment_cache,
+                                               float evaltime)
 {
   const float eps = 1.e-8f;
-  BezTriple *bezt, *prevbezt;
-  unsigned int a;
-
-  /* Evaltime occurs somewhere in the middle of the curve. */
-  bool exact = false;
-
-  /* Use binary search to find appropriate keyframes...
-   *
-   * The threshold here has the following constraints:
+  /* The threshold for the binary search has the following constraints:
    * - 0.001 is too coarse:
    *   We get artifacts with 2cm driver movements at 1BU = 1m (see T40332).
    *
@@ -1843,7 +1930,31 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
    *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
    *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
    */
-  a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+  const float threshold = 0.0001f;
+  BezTriple *bezt, *prevbezt;
+  unsigned int a = 0;
+
+  /* Evaltime occurs somewhere in the middle of the curve. */
+  bool exact = false;
+
+  /* Try the segment of the previous evaluation first. Only accept it when the binary search would
+   * find it as well: strictly inside the segment, and not within threshold of either keyframe. */
+  if (segment_cache != NULL && segment_cache->last_segment_end > 0) {
+    const int end = segment_cache->last_segment_end;
+    if (evaltime - bezts[end - 1].vec[1][0] > threshold &&
+        bezts[end].vec[1][0] - evaltime > threshold) {
+      a = end;
+    }
+  }
+
+  /* Use binary search to find appropriate keyframes... */
+  if (a == 0) {
+    a = BKE_fcurve_bezt_binarysearch_index_ex(bezts, evaltime, fcu->totvert, threshold, &exact);
+
+    if (segment_cache != NULL && !exact && a > 0 && a < fcu->totvert) {
+      segment_cache->last_segment_end = a;
+    }
+  }
   bezt = bezts + a;
 
   if (exact) {
@@ -1895,6 +2006,24 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
     case BEZT_IPO_BEZ: {
       float v1[2], v2[2], v3[2], v4[2], opl[32];
 
+      if (segment_cache != NULL && a > 0) {
+        /* Same as below, with the handle correction and polynomials already computed. */
+        const FCurveSegment *segment = &segment_cache->segments[a - 1];
+        if (segment->is_flat) {
+          return prevbezt->vec[1][1];
+        }
+        if (!solve_cubic(segment->x_start - evaltime,
+                         segment->x_coeffs[0],
+                         segment->x_coeffs[1],
+                         segment->x_coeffs[2],
+                         opl)) {
+          return 0.0f;
+        }
+        const float t = opl[0];
+        const float *c = segment->y_coeffs;
+        return c[0] + t * c[1] + t * t * c[2] + t * t * t * c[3];
+      }
+
       /* Bezier interpolation. */
       /* (v1, v2) are the first keyframe and its 2nd handle. */
       v1[0] = prevbezt->vec[1][0];
@@ -2086,7 +2215,10 @@ static float fcurve_eval_keyframes_interpolate(FCurve *fcu, BezTriple *bezts, fl
 }
 
 /* Calculate F-Curve value for 'evaltime' using #BezTriple keyframes. */
-static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime)
+static float fcurve_eval_keyframes(FCurve *fcu,
+                                   BezTriple *bezts,
+                                   FCurveSegmentCache *segment_cache,
+                                   float evaltime)
 {
   if (evaltime <= bezts->vec[1][0]) {
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, 0, +1);
@@ -2097,7 +2229,7 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
     return fcurve_eval_keyframes_extrapolate(fcu, bezts, evaltime, fcu->totvert - 1, -1);
   }
 
-  return fcurve_eval_keyframes_interpolate(fcu, bezts, evaltime);
+  return fcurve_eval_keyframes_interpolate(fcu, bezts, segment_cache, evaltime);
 }
 
 /* Calculate F-Curve value for 'evaltime' using #FPoint samples. */
@@ -2146,7 +2278,10 @@ static float fcurve_eval_samples(FCurve *fcu, FPoint *fpts, float evaltime)
 /* Evaluate and return the value of the given F-Curve at the specified frame ("evaltime")
  * Note: this is also used for drivers.
  */
-static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
+static float evaluate_fcurve_ex(FCurve *fcu,
+                                FCurveSegmentCache *segment_cache,
+                                float evaltime,
+                                float cvalue)
 {
   float devaltime;
 
@@ -2163,7 +2298,10 @@ static float evaluate_fcurve_ex(FCurve *fcu, float evaltime, float cvalue)
    *   F-Curve modifier on the stack requested the curve to be evaluated at.
    */
   if (fcu->bezt) {
-    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, devaltime);
+    if (!fcurve_segment_cache_is_valid(segment_cache, fcu)) {
+      segment_cache = NULL;
+    }
+    cvalue = fcurve_eval_keyframes(fcu, fcu->bezt, segment_cache, devaltime);
   }
   else if (fcu->fpt) {
     cvalue = fcurve_eval_samples(fcu, fcu->fpt, devaltime);
@@ -2186,7 +2324,7 @@ float evaluate_fcurve(FCurve *fcu, float evaltime)
 {
   BLI_assert(fcu->driver == NULL);
 
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, NULL, evaltime, 0.0);
 }
 
 float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
@@ -2194,7 +2332,7 @@ float evaluate_fcurve_only_curve(FCurve *fcu, float evaltime)
   /* Can be used to evaluate the (keyframed) fcurve only.
    * Also works for driver-fcurves when the driver itself is not relevant.
    * E.g. when inserting a keyframe in a driver fcurve. */
-  return evaluate_fcurve_ex(fcu, evaltime, 0.0);
+  return evaluate_fcurve_ex(fcu, NULL, evaltime, 0.0);
 }
 
 float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
@@ -2242,7 +2380,7 @@ float evaluate_fcurve_driver(PathResolvedRNA *anim_rna,
     }
   }
 
-  return evaluate_fcurve_ex(fcu, evaltime, cvalue);
+  return evaluate_fcurve_ex(fcu, NULL, evaltime, cvalue);
 }
 
 /* Checks if the curve has valid keys, drivers or modifiers that produce an actual curve. */
@@ -2256,6 +2394,15 @@ bool BKE_fcurve_is_empty(FCurve *fcu)
 float calculate_fcurve(PathResolvedRNA *anim_rna,
                        FCurve *fcu,
                        const AnimationEvalContext *anim_eval_context)
+{
+  return calculate_fcurve_with_segment_cache(anim_rna, fcu, NULL, anim_eval_context);
+}
+
+/* Same as calculate_fcurve(), using a segment cache created for the F-Curve (can be NULL). */
+float calculate_fcurve_with_segment_cache(PathResolvedRNA *anim_rna,
+                                          FCurve *fcu,
+                                          FCurveSegmentCache *segment_cache,
+                                          const AnimationEvalContext *anim_eval_context)
 {
   /* Only calculate + set curval (overriding the existing value) if curve has
    * any data which warrants this...
@@ -2270,7 +2417,7 @@ float calculate_fcurve(PathResolvedRNA *anim_rna,
     curval = evaluate_fcurve_driver(anim_rna, fcu, fcu->driver, anim_eval_context);
   }
   else {
-    curval = evaluate_fcurve(fcu, anim_eval_context->eval_time);
+    curval = evaluate_fcurve_ex(fcu, segment_cache, anim_eval_context->eval_time, 0.0f);
   }
   fcu->curval = curval; /* Debug display only, not thread safe! */
   return curval;
@@ -19,6 +19,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BKE_animsys.h"
 #include "BKE_fcurve.h"
 
 #include "ED_keyframing.h"
@@ -212,6 +213,40 @@ TEST(evaluate_fcurve, ExtrapolationBezierKeys)
   BKE_fcurve_free(fcu);
 }
 
+TEST(evaluate_fcurve, SegmentCache)
+{
+  FCurve *fcu = BKE_fcurve_create();
+
+  insert_vert_fcurve(fcu, 1.0f, 7.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  insert_vert_fcurve(fcu, 2.0f, 13.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  insert_vert_fcurve(fcu, 3.0f, 13.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  insert_vert_fcurve(fcu, 5.0f, -4.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  insert_vert_fcurve(fcu, 6.0f, 2.0f, BEZT_KEYTYPE_KEYFRAME, INSERTKEY_NO_USERPREF);
+  fcu->bezt[3].ipo = BEZT_IPO_LIN;
+
+  /* Overlapping handles, corrected during evaluation. */
+  fcu->bezt[0].vec[2][0] = 2.5f;
+  fcu->bezt[1].vec[0][0] = 0.5f;
+
+  FCurveSegmentCache *segment_cache = BKE_fcurve_segment_cache_create(fcu);
+  ASSERT_NE(segment_cache, nullptr);
+
+  /* Going back and forth and close to the keys, to exercise the last segment hint. */
+  const float times[] = {0.5f, 1.25f, 1.5f, 1.75f, 1.99995f, 2.0001f, 2.5f, 3.0f, 2.9f,
+                         4.0f, 1.1f,  5.5f, 4.99f, 5.0f,     6.0f,    7.0f, 3.5f, 3.6f};
+  for (const float time : times) {
+    const AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(nullptr,
+                                                                                      time);
+    EXPECT_FLOAT_EQ(
+        calculate_fcurve_with_segment_cache(nullptr, fcu, segment_cache, &anim_eval_context),
+        evaluate_fcurve(fcu, time))
+        << "at time " << time;
+  }
+
+  BKE_fcurve_segment_cache_free(segment_cache);
+  BKE_fcurve_free(fcu);
+}
+
 TEST(fcurve_subdivide, BKE_fcurve_bezt_subdivide_handles)
 {
   FCurve *fcu = BKE_fcurve_create();
@@ -198,9 +198,9 @@ static PointIndices lookup_point_indices(Span<int> offsets, const int index)
  * However, doing that makes the implementation simpler, and this can be optimized in the future if
  * only some values are required.
  */
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_curve_domain_point_to_spline_impl(const CurveEval &curve,
-                                                    const VArray<T> &old_values,
+                                                    const VArrayT &old_values,
                                                     MutableSpan<T> r_values)
 {
   const int splines_len = curve.splines().size();
@@ -227,7 +227,9 @@ static GVArrayPtr adapt_curve_domain_point_to_spline(const CurveEval &curve, GVA
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(curve.splines().size());
-      adapt_curve_domain_point_to_spline_impl<T>(curve, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_curve_domain_point_to_spline_impl<T>(curve, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
@@ -47,11 +47,27 @@ MeshComponent::~MeshComponent()
   this->clear();
 }
 
+static void mesh_duplicate_shared_layers(Mesh &mesh)
+{
+  CustomData_duplicate_shared_layers(&mesh.vdata, mesh.totvert);
+  CustomData_duplicate_shared_layers(&mesh.edata, mesh.totedge);
+  CustomData_duplicate_shared_layers(&mesh.ldata, mesh.totloop);
+  CustomData_duplicate_shared_layers(&mesh.pdata, mesh.totpoly);
+  BKE_mesh_update_customdata_pointers(&mesh, false);
+}
+
 GeometryComponent *MeshComponent::copy() const
 {
   MeshComponent *new_component = new MeshComponent();
   if (mesh_ != nullptr) {
-    new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    if (ownership_ == GeometryOwnershipType::Owned) {
+      /* The layers are only modified through #get_for_write or the attribute API, which duplicate
+       * shared layers first, so they don't have to be copied now. */
+      new_component->mesh_ = BKE_mesh_copy_for_eval_shared(mesh_);
+    }
+    else {
+      new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    }
     new_component->ownership_ = GeometryOwnershipType::Owned;
     new_component->vertex_group_names_ = blender::Map(vertex_group_names_);
   }
@@ -107,6 +123,10 @@ Mesh *MeshComponent::release()
 {
   BLI_assert(this->is_mutable());
   Mesh *mesh = mesh_;
+  if (mesh != nullptr && ownership_ == GeometryOwnershipType::Owned) {
+    /* Code outside of geometry sets may modify the layers without duplicating them first. */
+    mesh_duplicate_shared_layers(*mesh);
+  }
   mesh_ = nullptr;
   return mesh;
 }
@@ -143,6 +163,23 @@ const Mesh *MeshComponent::get_for_read() const
 /* Get the mesh from this component. This method can only be used when the component is mutable,
  * i.e. it is not shared. The returned mesh can be modified. No ownership is transferred. */
 Mesh *MeshComponent::get_for_write()
+{
+  BLI_assert(this->is_mutable());
+  if (ownership_ == GeometryOwnershipType::ReadOnly) {
+    mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    ownership_ = GeometryOwnershipType::Owned;
+  }
+  else if (mesh_ != nullptr) {
+    /* The caller may modify any layer directly. */
+    mesh_duplicate_shared_layers(*mesh_);
+  }
+  return mesh_;
+}
+
+/* Like #get_for_write, but the custom data layers may still be shared with other meshes. Every
+ * layer has to be duplicated with #CustomData_duplicate_referenced_layer before it is modified,
+ * like the attribute API does. This avoids copying layers that are not modified. */
+Mesh *MeshComponent::get_for_write_keep_shared_layers()
 {
   BLI_assert(this->is_mutable());
   if (ownership_ == GeometryOwnershipType::ReadOnly) {
@@ -199,9 +236,12 @@ int MeshComponent::attribute_domain_size(const AttributeDomain domain) const
 
 namespace blender::bke {
 
-template<typename T>
+/* The interpolation functions below are templated on the type of the virtual array, so that the
+ * per-element virtual method call can be avoided for spans and single values. */
+
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_corner_to_point_impl(const Mesh &mesh,
-                                                   const VArray<T> &old_values,
+                                                   const VArrayT &old_values,
                                                    MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totvert);
@@ -225,16 +265,18 @@ static GVArrayPtr adapt_mesh_domain_corner_to_point(const Mesh &mesh, GVArrayPtr
       /* We compute all interpolated values at once, because for this interpolation, one has to
        * iterate over all loops anyway. */
       Array<T> values(mesh.totvert);
-      adapt_mesh_domain_corner_to_point_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_corner_to_point_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_point_to_corner_impl(const Mesh &mesh,
-                                                   const VArray<T> &old_values,
+                                                   const VArrayT &old_values,
                                                    MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totloop);
@@ -255,7 +297,9 @@ static GVArrayPtr adapt_mesh_domain_point_to_corner(const Mesh &mesh, GVArrayPtr
      * when an algorithm only accesses very few of the corner values. However, for the algorithms
      * we currently have, precomputing the array is fine. Also, it is easier to implement. */
     Array<T> values(mesh.totloop);
-    adapt_mesh_domain_point_to_corner_impl<T>(mesh, varray->typed<T>(), values);
+    devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+      adapt_mesh_domain_point_to_corner_impl<T>(mesh, old_values, values);
+    });
     new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
   });
   return new_varray;
@@ -266,9 +310,9 @@ static GVArrayPtr adapt_mesh_domain_point_to_corner(const Mesh &mesh, GVArrayPtr
  * However, doing that makes the implementation simpler, and this can be optimized in the future if
  * only some values are required.
  */
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_corner_to_face_impl(const Mesh &mesh,
-                                                  const VArray<T> &old_values,
+                                                  const VArrayT &old_values,
                                                   MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totpoly);
@@ -292,16 +336,18 @@ static GVArrayPtr adapt_mesh_domain_corner_to_face(const Mesh &mesh, GVArrayPtr
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_corner_to_face_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_corner_to_face_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_corner_to_edge_impl(const Mesh &mesh,
-                                                  const VArray<T> &old_values,
+                                                  const VArrayT &old_values,
                                                   MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totedge);
@@ -330,16 +376,18 @@ static GVArrayPtr adapt_mesh_domain_corner_to_edge(const Mesh &mesh, GVArrayPtr
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totedge);
-      adapt_mesh_domain_corner_to_edge_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_corner_to_edge_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 void adapt_mesh_domain_face_to_point_impl(const Mesh &mesh,
-                                          const VArray<T> &old_values,
+                                          const VArrayT &old_values,
                                           MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totvert);
@@ -365,16 +413,18 @@ static GVArrayPtr adapt_mesh_domain_face_to_point(const Mesh &mesh, GVArrayPtr v
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totvert);
-      adapt_mesh_domain_face_to_point_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_face_to_point_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 void adapt_mesh_domain_face_to_corner_impl(const Mesh &mesh,
-                                           const VArray<T> &old_values,
+                                           const VArrayT &old_values,
                                            MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totloop);
@@ -393,16 +443,18 @@ static GVArrayPtr adapt_mesh_domain_face_to_corner(const Mesh &mesh, GVArrayPtr
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totloop);
-      adapt_mesh_domain_face_to_corner_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_face_to_corner_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 void adapt_mesh_domain_face_to_edge_impl(const Mesh &mesh,
-                                         const VArray<T> &old_values,
+                                         const VArrayT &old_values,
                                          MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totedge);
@@ -426,7 +478,9 @@ static GVArrayPtr adapt_mesh_domain_face_to_edge(const Mesh &mesh, GVArrayPtr va
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totedge);
-      adapt_mesh_domain_face_to_edge_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_face_to_edge_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
@@ -438,9 +492,9 @@ static GVArrayPtr adapt_mesh_domain_face_to_edge(const Mesh &mesh, GVArrayPtr va
  * However, doing that makes the implementation simpler, and this can be optimized in the future if
  * only some values are required.
  */
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_point_to_face_impl(const Mesh &mesh,
-                                                 const VArray<T> &old_values,
+                                                 const VArrayT &old_values,
                                                  MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totpoly);
@@ -464,7 +518,9 @@ static GVArrayPtr adapt_mesh_domain_point_to_face(const Mesh &mesh, GVArrayPtr v
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_point_to_face_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_point_to_face_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
@@ -476,9 +532,9 @@ static GVArrayPtr adapt_mesh_domain_point_to_face(const Mesh &mesh, GVArrayPtr v
  * However, doing that makes the implementation simpler, and this can be optimized in the future if
  * only some values are required.
  */
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_point_to_edge_impl(const Mesh &mesh,
-                                                 const VArray<T> &old_values,
+                                                 const VArrayT &old_values,
                                                  MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totedge);
@@ -500,16 +556,18 @@ static GVArrayPtr adapt_mesh_domain_point_to_edge(const Mesh &mesh, GVArrayPtr v
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totedge);
-      adapt_mesh_domain_point_to_edge_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_point_to_edge_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 void adapt_mesh_domain_edge_to_corner_impl(const Mesh &mesh,
-                                           const VArray<T> &old_values,
+                                           const VArrayT &old_values,
                                            MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totloop);
@@ -538,16 +596,18 @@ static GVArrayPtr adapt_mesh_domain_edge_to_corner(const Mesh &mesh, GVArrayPtr
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totloop);
-      adapt_mesh_domain_edge_to_corner_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_edge_to_corner_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
   return new_varray;
 }
 
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_edge_to_point_impl(const Mesh &mesh,
-                                                 const VArray<T> &old_values,
+                                                 const VArrayT &old_values,
                                                  MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totvert);
@@ -570,7 +630,9 @@ static GVArrayPtr adapt_mesh_domain_edge_to_point(const Mesh &mesh, GVArrayPtr v
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totvert);
-      adapt_mesh_domain_edge_to_point_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_edge_to_point_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
@@ -582,9 +644,9 @@ static GVArrayPtr adapt_mesh_domain_edge_to_point(const Mesh &mesh, GVArrayPtr v
  * However, doing that makes the implementation simpler, and this can be optimized in the future if
  * only some values are required.
  */
-template<typename T>
+template<typename T, typename VArrayT>
 static void adapt_mesh_domain_edge_to_face_impl(const Mesh &mesh,
-                                                const VArray<T> &old_values,
+                                                const VArrayT &old_values,
                                                 MutableSpan<T> r_values)
 {
   BLI_assert(r_values.size() == mesh.totpoly);
@@ -608,7 +670,9 @@ static GVArrayPtr adapt_mesh_domain_edge_to_face(const Mesh &mesh, GVArrayPtr va
     using T = decltype(dummy);
     if constexpr (!std::is_void_v<attribute_math::DefaultMixer<T>>) {
       Array<T> values(mesh.totpoly);
-      adapt_mesh_domain_edge_to_face_impl<T>(mesh, varray->typed<T>(), values);
+      devirtualize_varray<T>(varray->typed<T>(), [&](const auto &old_values) {
+        adapt_mesh_domain_edge_to_face_impl<T>(mesh, old_values, values);
+      });
       new_varray = std::make_unique<fn::GVArray_For_ArrayContainer<Array<T>>>(std::move(values));
     }
   });
@@ -696,7 +760,7 @@ static Mesh *get_mesh_from_component_for_write(GeometryComponent &component)
 {
   BLI_assert(component.type() == GEO_COMPONENT_TYPE_MESH);
   MeshComponent &mesh_component = static_cast<MeshComponent &>(component);
-  return mesh_component.get_for_write();
+  return mesh_component.get_for_write_keep_shared_layers();
 }
 
 static const Mesh *get_mesh_from_component_for_read(const GeometryComponent &component)
@@ -885,7 +949,7 @@ class VertexGroupsAttributeProvider final : public DynamicAttributesProvider {
   {
     BLI_assert(component.type() == GEO_COMPONENT_TYPE_MESH);
     MeshComponent &mesh_component = static_cast<MeshComponent &>(component);
-    Mesh *mesh = mesh_component.get_for_write();
+    Mesh *mesh = mesh_component.get_for_write_keep_shared_layers();
     if (mesh == nullptr) {
       return {};
     }
@@ -919,13 +983,15 @@ class VertexGroupsAttributeProvider final : public DynamicAttributesProvider {
     if (vertex_group_index < 0) {
       return false;
     }
-    Mesh *mesh = mesh_component.get_for_write();
+    Mesh *mesh = mesh_component.get_for_write_keep_shared_layers();
     if (mesh == nullptr) {
       return true;
     }
     if (mesh->dvert == nullptr) {
       return true;
     }
+    mesh->dvert = (MDeformVert *)CustomData_duplicate_referenced_layer(
+        &mesh->vdata, CD_MDEFORMVERT, mesh->totvert);
     for (MDeformVert &dvert : MutableSpan(mesh->dvert, mesh->totvert)) {
       MDeformWeight *weight = BKE_defvert_find_index(&dvert, vertex_group_index);
       BKE_defvert_remove_group(&dvert, weight);
@@ -742,4 +742,175 @@ GeometrySet geometry_set_realize_instances(const GeometrySet &geometry_set)
   return new_geometry_set;
 }
 
+/**
+ * Virtual array that concatenates the values of a component for every instance. The values of
+ * all instances in a group come from the same source virtual array.
+ */
+class GVArray_For_RealizedInstances final : public GVArray {
+ public:
+  struct Group {
+    GVArrayPtr source;
+    Span<float4x4> transforms;
+    int64_t first_instance;
+  };
+
+ private:
+  Vector<Group> groups_;
+  /* Start of every instance in the realized indices, with the total size as last element. */
+  Array<int64_t> instance_offsets_;
+  Array<int64_t> instance_groups_;
+  bool transform_positions_;
+
+ public:
+  GVArray_For_RealizedInstances(const CPPType &type,
+                                Vector<Group> groups,
+                                Array<int64_t> instance_offsets,
+                                const bool transform_positions)
+      : GVArray(type, instance_offsets.last()),
+        groups_(std::move(groups)),
+        instance_offsets_(std::move(instance_offsets)),
+        instance_groups_(instance_offsets_.size() - 1),
+        transform_positions_(transform_positions)
+  {
+    for (const int64_t group_index : groups_.index_range()) {
+      const Group &group = groups_[group_index];
+      instance_groups_.as_mutable_span()
+          .slice(group.first_instance, group.transforms.size())
+          .fill(group_index);
+    }
+  }
+
+ private:
+  int64_t find_instance(const int64_t index) const
+  {
+    const int64_t *offset = std::upper_bound(
+        instance_offsets_.begin(), instance_offsets_.end(), index);
+    return (offset - instance_offsets_.begin()) - 1;
+  }
+
+  void get_in_instance(const int64_t instance, const int64_t index, void *r_value) const
+  {
+    const Group &group = groups_[instance_groups_[instance]];
+    group.source->get_to_uninitialized(index - instance_offsets_[instance], r_value);
+    if (transform_positions_) {
+      const float4x4 &transform = group.transforms[instance - group.first_instance];
+      float3 &position = *static_cast<float3 *>(r_value);
+      position = transform * position;
+    }
+  }
+
+  void get_to_uninitialized_impl(const int64_t index, void *r_value) const override
+  {
+    this->get_in_instance(this->find_instance(index), index, r_value);
+  }
+
+  void materialize_to_uninitialized_impl(const IndexMask mask, void *dst) const override
+  {
+    if (mask.is_empty()) {
+      return;
+    }
+    /* The mask is sorted, so the instance only has to be searched once. */
+    int64_t instance = this->find_instance(mask[0]);
+    for (const int64_t i : mask) {
+      while (i >= instance_offsets_[instance + 1]) {
+        instance++;
+      }
+      this->get_in_instance(instance, i, POINTER_OFFSET(dst, type_->size() * i));
+    }
+  }
+
+  void materialize_impl(const IndexMask mask, void *dst) const override
+  {
+    /* Values are only assigned in #get_in_instance, so destruct them first. */
+    type_->destruct_indices(dst, mask);
+    this->materialize_to_uninitialized_impl(mask, dst);
+  }
+};
+
+InstancesRealizedView::InstancesRealizedView(Span<GeometryInstanceGroup> set_groups,
+                                             const GeometryComponentType component_type)
+{
+  for (const GeometryInstanceGroup &set_group : set_groups) {
+    const GeometryComponent *component = set_group.geometry_set.get_component_for_read(
+        component_type);
+    if (component == nullptr || component->is_empty() || set_group.transforms.is_empty()) {
+      continue;
+    }
+    groups_.append({component, set_group.transforms});
+    instances_size_ += set_group.transforms.size();
+  }
+}
+
+bool InstancesRealizedView::is_empty() const
+{
+  return groups_.is_empty();
+}
+
+int64_t InstancesRealizedView::instances_size() const
+{
+  return instances_size_;
+}
+
+int64_t InstancesRealizedView::domain_size(const AttributeDomain domain) const
+{
+  int64_t size = 0;
+  for (const Group &group : groups_) {
+    size += group.component->attribute_domain_size(domain) * group.transforms.size();
+  }
+  return size;
+}
+
+GVArrayPtr InstancesRealizedView::attribute_get_for_read(const StringRef name,
+                                                         const AttributeDomain domain,
+                                                         const CustomDataType data_type,
+                                                         const void *default_value) const
+{
+  const CPPType *type = custom_data_type_to_cpp_type(data_type);
+  BLI_assert(type != nullptr);
+  if (default_value == nullptr) {
+    default_value = type->default_value();
+  }
+  const bool transform_positions = name == "position" && data_type == CD_PROP_FLOAT3;
+  return this->attribute_get_for_read(
+      domain,
+      *type,
+      [&](const GeometryComponent &component) {
+        return component.attribute_get_for_read(name, domain, data_type, default_value);
+      },
+      transform_positions);
+}
+
+GVArrayPtr InstancesRealizedView::attribute_get_for_read(
+    const AttributeDomain domain,
+    const CPPType &type,
+    FunctionRef<GVArrayPtr(const GeometryComponent &component)> get_component_varray) const
+{
+  return this->attribute_get_for_read(domain, type, get_component_varray, false);
+}
+
+GVArrayPtr InstancesRealizedView::attribute_get_for_read(
+    const AttributeDomain domain,
+    const CPPType &type,
+    FunctionRef<GVArrayPtr(const GeometryComponent &component)> get_component_varray,
+    const bool transform_positions) const
+{
+  Vector<GVArray_For_RealizedInstances::Group> groups;
+  Array<int64_t> instance_offsets(instances_size_ + 1);
+  int64_t instance = 0;
+  int64_t offset = 0;
+  for (const Group &group : groups_) {
+    groups.append({get_component_varray(*group.component), group.transforms, instance});
+    const int64_t size = group.component->attribute_domain_size(domain);
+    for (const int64_t UNUSED(i) : group.transforms.index_range()) {
+      instance_offsets[instance] = offset;
+      offset += size;
+      instance++;
+    }
+  }
+  instance_offsets.last() = offset;
+
+  return std::make_unique<GVArray_For_RealizedInstances>(
+      type, std::move(groups), std::move(instance_offsets), transform_positions);
+}
+
 }  // namespace blender::bke
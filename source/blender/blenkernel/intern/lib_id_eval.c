@@ -23,11 +23,13 @@
 
 #include "DNA_ID.h"
 #include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
 
 #include "BLI_utildefines.h"
 
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
+#include "BKE_object.h"
 
 /**
  * Copy relatives parameters, from `id` to `id_cow`.
@@ -46,3 +48,23 @@ void BKE_id_eval_properties_copy(ID *id_cow, ID *id)
     BLI_assert_unreachable();
   }
 }
+
+/**
+ * Copy the data affected by the `recalc` flags from `id` to `id_cow`, which is already expanded.
+ * Used instead of a full copy-on-write update when all the flags the ID was tagged with are in
+ * #ID_TYPE_PARTIAL_COW_RECALC.
+ */
+void BKE_id_eval_partial_copy(ID *id_cow, const ID *id, const int recalc)
+{
+  const ID_Type id_type = GS(id->name);
+  BLI_assert((id_cow->tag & LIB_TAG_COPIED_ON_WRITE) && !(id->tag & LIB_TAG_COPIED_ON_WRITE));
+  BLI_assert((recalc & ~ID_TYPE_PARTIAL_COW_RECALC(id_type)) == 0);
+  if (id_type == ID_OB) {
+    if (recalc & ID_RECALC_TRANSFORM_ONLY) {
+      BKE_object_transform_copy_for_eval((Object *)id_cow, (const Object *)id);
+    }
+  }
+  else {
+    BLI_assert_unreachable();
+  }
+}
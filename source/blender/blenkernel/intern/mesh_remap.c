@@ -82,6 +82,50 @@ static bool mesh_remap_bvhtree_query_nearest(BVHTreeFromMesh *treedata,
   return false;
 }
 
+/**
+ * Batched version of #mesh_remap_bvhtree_query_nearest for all destination vertices, which are
+ * converted to tree coordinates first if needed (returned in \a r_vcos_dst).
+ * Results which are not within \a max_dist_sq get an index of -1.
+ */
+static BVHTreeNearest *mesh_remap_bvhtree_query_nearest_verts(
+    BVHTreeFromMesh *treedata,
+    const MVert *verts_dst,
+    const int numverts_dst,
+    const SpaceTransform *space_transform,
+    const float max_dist_sq,
+    float (**r_vcos_dst)[3])
+{
+  float(*vcos_dst)[3] = MEM_malloc_arrayN((size_t)numverts_dst, sizeof(*vcos_dst), __func__);
+  BVHTreeNearest *nearest = MEM_malloc_arrayN((size_t)numverts_dst, sizeof(*nearest), __func__);
+
+  for (int i = 0; i < numverts_dst; i++) {
+    copy_v3_v3(vcos_dst[i], verts_dst[i].co);
+    /* Convert the vertex to tree coordinates, if needed. */
+    if (space_transform) {
+      BLI_space_transform_apply(space_transform, vcos_dst[i]);
+    }
+    nearest[i].index = -1;
+    nearest[i].dist_sq = max_dist_sq;
+  }
+
+  BLI_bvhtree_find_nearest_batch(treedata->tree,
+                                 (const float(*)[3])vcos_dst,
+                                 numverts_dst,
+                                 nearest,
+                                 treedata->nearest_callback,
+                                 treedata,
+                                 0);
+
+  for (int i = 0; i < numverts_dst; i++) {
+    if (nearest[i].dist_sq > max_dist_sq) {
+      nearest[i].index = -1;
+    }
+  }
+
+  *r_vcos_dst = vcos_dst;
+  return nearest;
+}
+
 static bool mesh_remap_bvhtree_query_raycast(BVHTreeFromMesh *treedata,
                                              BVHTreeRayHit *rayhit,
                                              const float co[3],
@@ -530,43 +574,41 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
 
     if (mode == MREMAP_MODE_VERT_NEAREST) {
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_VERTS, 2);
-      nearest.index = -1;
 
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
-
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+      float(*vcos_dst)[3];
+      BVHTreeNearest *nearest_dst = mesh_remap_bvhtree_query_nearest_verts(
+          &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &vcos_dst);
 
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
-          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest.index, &full_weight);
+      for (i = 0; i < numverts_dst; i++) {
+        if (nearest_dst[i].index != -1) {
+          hit_dist = sqrtf(nearest_dst[i].dist_sq);
+          mesh_remap_item_define(r_map, i, hit_dist, 0, 1, &nearest_dst[i].index, &full_weight);
         }
         else {
           /* No source for this dest vertex! */
           BKE_mesh_remap_item_define_invalid(r_map, i);
         }
       }
+
+      MEM_freeN(vcos_dst);
+      MEM_freeN(nearest_dst);
     }
     else if (ELEM(mode, MREMAP_MODE_VERT_EDGE_NEAREST, MREMAP_MODE_VERT_EDGEINTERP_NEAREST)) {
       MEdge *edges_src = me_src->medge;
       float(*vcos_src)[3] = BKE_mesh_vert_coords_alloc(me_src, NULL);
 
       BKE_bvhtree_from_mesh_get(&treedata, me_src, BVHTREE_FROM_EDGES, 2);
-      nearest.index = -1;
 
-      for (i = 0; i < numverts_dst; i++) {
-        copy_v3_v3(tmp_co, verts_dst[i].co);
+      float(*vcos_dst)[3];
+      BVHTreeNearest *nearest_dst = mesh_remap_bvhtree_query_nearest_verts(
+          &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &vcos_dst);
 
-        /* Convert the vertex to tree coordinates, if needed. */
-        if (space_transform) {
-          BLI_space_transform_apply(space_transform, tmp_co);
-        }
+      for (i = 0; i < numverts_dst; i++) {
+        copy_v3_v3(tmp_co, vcos_dst[i]);
+        nearest = nearest_dst[i];
 
-        if (mesh_remap_bvhtree_query_nearest(
-                &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
+        if (nearest.index != -1) {
+          hit_dist = sqrtf(nearest.dist_sq);
           MEdge *me = &edges_src[nearest.index];
           const float *v1cos = vcos_src[me->v1];
           const float *v2cos = vcos_src[me->v2];
@@ -599,6 +641,8 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
       }
 
       MEM_freeN(vcos_src);
+      MEM_freeN(vcos_dst);
+      MEM_freeN(nearest_dst);
     }
     else if (ELEM(mode,
                   MREMAP_MODE_VERT_POLY_NEAREST,
@@ -651,18 +695,15 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
         }
       }
       else {
-        nearest.index = -1;
+        float(*vcos_dst)[3];
+        BVHTreeNearest *nearest_dst = mesh_remap_bvhtree_query_nearest_verts(
+            &treedata, verts_dst, numverts_dst, space_transform, max_dist_sq, &vcos_dst);
 
         for (i = 0; i < numverts_dst; i++) {
-          copy_v3_v3(tmp_co, verts_dst[i].co);
+          nearest = nearest_dst[i];
 
-          /* Convert the vertex to tree coordinates, if needed. */
-          if (space_transform) {
-            BLI_space_transform_apply(space_transform, tmp_co);
-          }
-
-          if (mesh_remap_bvhtree_query_nearest(
-                  &treedata, &nearest, tmp_co, max_dist_sq, &hit_dist)) {
+          if (nearest.index != -1) {
+            hit_dist = sqrtf(nearest.dist_sq);
             const MLoopTri *lt = &treedata.looptri[nearest.index];
             MPoly *mp = &polys_src[lt->poly];
 
@@ -703,6 +744,9 @@ void BKE_mesh_remap_calc_verts_from_mesh(const int mode,
             BKE_mesh_remap_item_define_invalid(r_map, i);
           }
         }
+
+        MEM_freeN(vcos_dst);
+        MEM_freeN(nearest_dst);
       }
 
       MEM_freeN(vcos_src);
@@ -33,6 +33,7 @@
 #include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "BKE_armature.h"
 #include "BKE_bvhutils.h"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
@@ -68,6 +69,7 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  runtime->skin_weights = NULL;
 
   mesh->runtime.eval_mutex = MEM_mallocN(sizeof(ThreadMutex), "mesh runtime eval_mutex");
   BLI_mutex_init(mesh->runtime.eval_mutex);
@@ -244,6 +246,7 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.subdiv_ccg = NULL;
   }
   BKE_shrinkwrap_discard_boundary_data(mesh);
+  BKE_armature_deform_skin_weights_discard(mesh);
 }
 
 /** \} */
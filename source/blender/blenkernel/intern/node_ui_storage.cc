@@ -16,7 +16,9 @@
 
 #include "CLG_log.h"
 
+#include <fstream>
 #include <mutex>
+#include <optional>
 
 #include "BLI_map.hh"
 #include "BLI_string_ref.hh"
@@ -26,8 +28,10 @@
 #include "DNA_object_types.h"
 
 #include "BKE_context.h"
+#include "BKE_node.h"
 #include "BKE_node_ui_storage.hh"
 #include "BKE_object.h"
+#include "BKE_report.h"
 
 static CLG_LogRef LOG = {"bke.node_ui_storage"};
 
@@ -53,6 +57,21 @@ static NodeTreeUIStorage &ui_storage_ensure(bNodeTree &ntree)
   return *ntree.ui_storage;
 }
 
+static std::optional<NodeTreeEvaluationContext> active_evaluation_context(const bContext *C)
+{
+  const Object *active_object = CTX_data_active_object(C);
+  if (active_object == nullptr) {
+    return std::nullopt;
+  }
+
+  const ModifierData *active_modifier = BKE_object_active_modifier(active_object);
+  if (active_modifier == nullptr) {
+    return std::nullopt;
+  }
+
+  return NodeTreeEvaluationContext(*active_object, *active_modifier);
+}
+
 const NodeUIStorage *BKE_node_tree_ui_storage_get_from_context(const bContext *C,
                                                                const bNodeTree &ntree,
                                                                const bNode &node)
@@ -62,18 +81,12 @@ const NodeUIStorage *BKE_node_tree_ui_storage_get_from_context(const bContext *C
     return nullptr;
   }
 
-  const Object *active_object = CTX_data_active_object(C);
-  if (active_object == nullptr) {
+  const std::optional<NodeTreeEvaluationContext> context = active_evaluation_context(C);
+  if (!context) {
     return nullptr;
   }
 
-  const ModifierData *active_modifier = BKE_object_active_modifier(active_object);
-  if (active_modifier == nullptr) {
-    return nullptr;
-  }
-
-  const NodeTreeEvaluationContext context(*active_object, *active_modifier);
-  const Map<std::string, NodeUIStorage> *storage = ui_storage->context_map.lookup_ptr(context);
+  const Map<std::string, NodeUIStorage> *storage = ui_storage->context_map.lookup_ptr(*context);
   if (storage == nullptr) {
     return nullptr;
   }
@@ -93,6 +106,7 @@ void BKE_nodetree_ui_storage_free_for_context(bNodeTree &ntree,
   if (ui_storage != nullptr) {
     std::lock_guard<std::mutex> lock(ui_storage->mutex);
     ui_storage->context_map.remove(context);
+    ui_storage->execution_events_map.remove(context);
   }
 }
 
@@ -167,3 +181,116 @@ void BKE_nodetree_attribute_hint_add(bNodeTree &ntree,
   node_ui_storage.attribute_hints.add_as(
       AvailableAttributeInfo{attribute_name, domain, data_type});
 }
+
+void BKE_nodetree_node_execution_add(bNodeTree &ntree,
+                                     const NodeTreeEvaluationContext &context,
+                                     const bNode &node,
+                                     const double duration,
+                                     const int64_t output_geometry_size,
+                                     const int64_t memory_in_use)
+{
+  NodeTreeUIStorage &ui_storage = ui_storage_ensure(ntree);
+  std::lock_guard lock{ui_storage.mutex};
+
+  NodeUIStorage &node_ui_storage = node_ui_storage_ensure(ui_storage, context, node);
+  NodeExecutionInfo &info = node_ui_storage.execution_info;
+  info.calls++;
+  info.duration += duration;
+  info.output_geometry_size += output_geometry_size;
+  info.memory_in_use = std::max(info.memory_in_use, memory_in_use);
+}
+
+void BKE_nodetree_execution_event_add(bNodeTree &root_ntree,
+                                      const NodeTreeEvaluationContext &context,
+                                      NodeExecutionEvent event)
+{
+  NodeTreeUIStorage &ui_storage = ui_storage_ensure(root_ntree);
+  std::lock_guard lock{ui_storage.mutex};
+
+  ui_storage.execution_events_map.lookup_or_add_default(context).append(std::move(event));
+}
+
+bool BKE_node_execution_info_get(const bContext *C,
+                                 const bNodeTree *ntree,
+                                 const bNode *node,
+                                 int *r_calls,
+                                 double *r_duration,
+                                 int64_t *r_output_geometry_size,
+                                 int64_t *r_memory_in_use)
+{
+  const NodeUIStorage *node_ui_storage = BKE_node_tree_ui_storage_get_from_context(
+      C, *ntree, *node);
+  const NodeExecutionInfo info = (node_ui_storage == nullptr) ? NodeExecutionInfo() :
+                                                                node_ui_storage->execution_info;
+  *r_calls = info.calls;
+  *r_duration = info.duration;
+  *r_output_geometry_size = info.output_geometry_size;
+  *r_memory_in_use = info.memory_in_use;
+  return node_ui_storage != nullptr;
+}
+
+static std::string json_escape(StringRef str)
+{
+  std::string result;
+  for (const char c : str) {
+    if (ELEM(c, '"', '\\')) {
+      result += '\\';
+    }
+    if (static_cast<unsigned char>(c) < ' ') {
+      /* Control characters are not allowed in JSON strings. */
+      continue;
+    }
+    result += c;
+  }
+  return result;
+}
+
+/**
+ * Write the node executions of the last evaluation of the node tree in the active object and
+ * modifier as Chrome trace event JSON, which can be opened in `chrome://tracing` or Perfetto.
+ * Returns false and reports why when there are no executions or the file can't be written.
+ */
+bool BKE_nodetree_execution_trace_write(const bContext *C,
+                                        const bNodeTree *root_ntree,
+                                        const char *filepath,
+                                        ReportList *reports)
+{
+  NodeTreeUIStorage *ui_storage = root_ntree->ui_storage;
+  const std::optional<NodeTreeEvaluationContext> context = active_evaluation_context(C);
+  const Vector<NodeExecutionEvent> *events = nullptr;
+  std::unique_lock<std::mutex> lock;
+  if (ui_storage != nullptr && context) {
+    lock = std::unique_lock{ui_storage->mutex};
+    events = ui_storage->execution_events_map.lookup_ptr(*context);
+  }
+  if (events == nullptr) {
+    BKE_reportf(reports,
+                RPT_ERROR,
+                "No evaluation of \"%s\" by the active modifier to write",
+                root_ntree->id.name + 2);
+    return false;
+  }
+
+  std::ofstream file(filepath);
+  if (!file) {
+    BKE_reportf(reports, RPT_ERROR, "Could not open \"%s\" for writing", filepath);
+    return false;
+  }
+
+  /* Use small thread numbers that are easier to read than the hashes. */
+  Map<uint64_t, int> thread_numbers;
+
+  file << "{\"traceEvents\": [\n";
+  for (const int i : events->index_range()) {
+    const NodeExecutionEvent &event = (*events)[i];
+    const int thread = thread_numbers.lookup_or_add(event.thread, thread_numbers.size());
+    file << "  {\"name\": \"" << json_escape(event.node_name) << "\", \"cat\": \""
+         << json_escape(event.tree_name) << "\", \"ph\": \"X\", \"ts\": " << event.start
+         << ", \"dur\": " << event.end - event.start << ", \"pid\": 0, \"tid\": " << thread
+         << "}";
+    file << ((i < events->size() - 1) ? ",\n" : "\n");
+  }
+  file << "]}\n";
+
+  return true;
+}
@@ -2614,6 +2614,35 @@ void BKE_object_transform_copy(Object *ob_tar, const Object *ob_src)
   copy_v3_v3(ob_tar->scale, ob_src->scale);
 }
 
+/**
+ * Copy all the settings which affect the evaluation of the object transform, to update an
+ * evaluated object tagged with #ID_RECALC_TRANSFORM_ONLY without copying the whole object.
+ */
+void BKE_object_transform_copy_for_eval(Object *ob_eval, const Object *ob_orig)
+{
+  BKE_object_transform_copy(ob_eval, ob_orig);
+
+  copy_v3_v3(ob_eval->dloc, ob_orig->dloc);
+  copy_v3_v3(ob_eval->drot, ob_orig->drot);
+  copy_v4_v4(ob_eval->dquat, ob_orig->dquat);
+  copy_v3_v3(ob_eval->drotAxis, ob_orig->drotAxis);
+  ob_eval->drotAngle = ob_orig->drotAngle;
+  copy_v3_v3(ob_eval->dscale, ob_orig->dscale);
+
+  copy_m4_m4(ob_eval->parentinv, ob_orig->parentinv);
+  ob_eval->par1 = ob_orig->par1;
+  ob_eval->par2 = ob_orig->par2;
+  ob_eval->par3 = ob_orig->par3;
+  BLI_strncpy(ob_eval->parsubstr, ob_orig->parsubstr, sizeof(ob_eval->parsubstr));
+
+  ob_eval->trackflag = ob_orig->trackflag;
+  ob_eval->upflag = ob_orig->upflag;
+  ob_eval->protectflag = ob_orig->protectflag;
+  ob_eval->transflag = ob_orig->transflag;
+  ob_eval->instance_faces_scale = ob_orig->instance_faces_scale;
+  ob_eval->dt = ob_orig->dt;
+}
+
 /**
  * Perform deep-copy of object and its 'children' data-blocks (obdata, materials, actions, etc.).
  *
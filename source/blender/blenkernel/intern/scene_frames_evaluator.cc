@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_index_range.hh"
+#include "BLI_task.hh"
+#include "BLI_threads.h"
+
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_pointcache.h"
+#include "BKE_scene.h"
+#include "BKE_scene_frames_evaluator.hh"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_query.h"
+
+namespace blender::bke {
+
+/* Simulations need the previous frame to be evaluated first. */
+static bool frames_are_independent(Depsgraph *depsgraph)
+{
+  Scene *scene = DEG_get_input_scene(depsgraph);
+  if (scene->rigidbody_world != nullptr) {
+    return false;
+  }
+
+  bool is_independent = true;
+  DEG_OBJECT_ITER_BEGIN (depsgraph,
+                         object,
+                         DEG_ITER_OBJECT_FLAG_LINKED_DIRECTLY |
+                             DEG_ITER_OBJECT_FLAG_LINKED_VIA_SET) {
+    if (is_independent && BKE_ptcache_object_has(scene, DEG_get_original_object(object), 0)) {
+      is_independent = false;
+    }
+  }
+  DEG_OBJECT_ITER_END;
+  return is_independent;
+}
+
+/* Evaluate the dependency graph at the given frame without touching the frame of the original
+ * scene, so that graphs can be evaluated at different frames at the same time. */
+static void evaluate_frame(Depsgraph *depsgraph, const double frame)
+{
+  const Scene *scene = DEG_get_input_scene(depsgraph);
+  DEG_graph_relations_update(depsgraph);
+  DEG_evaluate_on_framechange(depsgraph, static_cast<float>(frame) * scene->r.framelen);
+  DEG_ids_clear_recalc(depsgraph, false);
+}
+
+SceneFramesEvaluator::SceneFramesEvaluator(Depsgraph *depsgraph,
+                                           BuildFn build_fn,
+                                           const int64_t memory_budget)
+    : depsgraph_(depsgraph), build_fn_(std::move(build_fn)), memory_budget_(memory_budget)
+{
+  use_copies_ = memory_budget_ > 0 && frames_are_independent(depsgraph_);
+  depsgraphs_.append(depsgraph_);
+  evaluated_frames_.append(std::nullopt);
+}
+
+SceneFramesEvaluator::~SceneFramesEvaluator()
+{
+  for (Depsgraph *depsgraph : depsgraphs_.as_span().drop_front(1)) {
+    DEG_graph_free(depsgraph);
+  }
+}
+
+void SceneFramesEvaluator::create_copies(const double first_frame, const int64_t frames_num)
+{
+  copies_created_ = true;
+
+  const int64_t max_depsgraphs = std::min<int64_t>(BLI_system_thread_count(), frames_num);
+  Main *bmain = DEG_get_bmain(depsgraph_);
+  Scene *scene = DEG_get_input_scene(depsgraph_);
+  ViewLayer *view_layer = DEG_get_input_view_layer(depsgraph_);
+  const eEvaluationMode mode = DEG_get_mode(depsgraph_);
+
+  int64_t copy_size = 0;
+  while (depsgraphs_.size() < max_depsgraphs) {
+    if (copy_size * depsgraphs_.size() > memory_budget_) {
+      break;
+    }
+    const int64_t memory_before = static_cast<int64_t>(MEM_get_memory_in_use());
+    Depsgraph *copy = DEG_graph_new(bmain, scene, view_layer, mode);
+    build_fn_(copy);
+    std::optional<double> evaluated_frame;
+    if (copy_size == 0) {
+      /* Most of the memory is used by evaluated data, so the first copy is evaluated to know the
+       * size of a copy. It is used for that frame then, instead of evaluating it again. */
+      evaluate_frame(copy, first_frame);
+      evaluated_frame = first_frame;
+      copy_size = std::max<int64_t>(
+          static_cast<int64_t>(MEM_get_memory_in_use()) - memory_before, 1);
+      if (copy_size > memory_budget_) {
+        DEG_graph_free(copy);
+        break;
+      }
+    }
+    depsgraphs_.append(copy);
+    evaluated_frames_.append(evaluated_frame);
+  }
+}
+
+void SceneFramesEvaluator::foreach_frame(Span<double> frames, FrameFn frame_fn)
+{
+  if (use_copies_ && !copies_created_ && frames.size() > 1) {
+    create_copies(frames[1], frames.size());
+  }
+  if (depsgraphs_.size() < 2) {
+    foreach_frame_sequential(frames, frame_fn);
+    return;
+  }
+
+  for (int64_t start = 0; start < frames.size(); start += depsgraphs_.size()) {
+    const int64_t batch_size = std::min(depsgraphs_.size(), frames.size() - start);
+    threading::parallel_for(IndexRange(batch_size), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        const double frame = frames[start + i];
+        if (evaluated_frames_[i] == frame) {
+          continue;
+        }
+        /* Keep the evaluation of one graph from picking up tasks of the others while waiting. */
+        threading::isolate_task([&]() { evaluate_frame(depsgraphs_[i], frame); });
+        evaluated_frames_[i] = frame;
+      }
+    });
+    for (const int64_t i : IndexRange(batch_size)) {
+      if (!frame_fn(depsgraphs_[i], frames[start + i])) {
+        return;
+      }
+    }
+  }
+}
+
+void SceneFramesEvaluator::foreach_frame_sequential(Span<double> frames, FrameFn frame_fn)
+{
+  Scene *scene = DEG_get_input_scene(depsgraph_);
+  for (const double frame : frames) {
+    scene->r.cfra = static_cast<int>(frame);
+    scene->r.subframe = frame - scene->r.cfra;
+    BKE_scene_graph_update_for_newframe(depsgraph_);
+    if (!frame_fn(depsgraph_, frame)) {
+      return;
+    }
+  }
+}
+
+}  // namespace blender::bke
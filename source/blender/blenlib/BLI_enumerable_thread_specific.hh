@@ -51,6 +51,15 @@ template<typename T> class EnumerableThreadSpecific : NonCopyable, NonMovable {
     return values_.local();
   }
 
+  /* Call the function for the values of all threads which used #local() before. Is not
+   * thread-safe with calls to #local(). */
+  template<typename Func> void foreach_value(const Func &func)
+  {
+    for (T &value : values_) {
+      func(value);
+    }
+  }
+
 #else /* WITH_TBB */
 
  private:
@@ -67,6 +76,14 @@ template<typename T> class EnumerableThreadSpecific : NonCopyable, NonMovable {
     return *values_.lookup_or_add_cb(thread_id, []() { return std::make_unique<T>(); });
   }
 
+  template<typename Func> void foreach_value(const Func &func)
+  {
+    std::lock_guard lock{mutex_};
+    for (std::unique_ptr<T> &value : values_.values()) {
+      func(*value);
+    }
+  }
+
 #endif /* WITH_TBB */
 };
 
@@ -39,6 +39,7 @@
 
 #include "BLI_index_range.hh"
 #include "BLI_span.hh"
+#include "BLI_vector.hh"
 
 namespace blender {
 
@@ -204,6 +205,35 @@ class IndexMask {
   {
     return indices_.size();
   }
+
+  bool is_empty() const
+  {
+    return indices_.is_empty();
+  }
+
+  IndexMask slice(int64_t start, int64_t size) const
+  {
+    return IndexMask(indices_.slice(start, size));
+  }
+
+  IndexMask slice(IndexRange slice) const
+  {
+    return IndexMask(indices_.slice(slice));
+  }
+
+  /**
+   * Create a sub-mask that is shifted so that its first index is zero. This allows working with
+   * arrays that only contain the elements referenced by the sub-mask, instead of arrays as large
+   * as the original mask requires.
+   *
+   * The returned mask might reference indices that have been appended to #r_new_indices.
+   *
+   * Example:
+   * this:   [2, 3, 5, 7, 8, 9, 10]
+   * slice:      ^--------^
+   * output: [0, 2, 4, 5]
+   */
+  IndexMask slice_and_offset(IndexRange slice, Vector<int64_t> &r_new_indices) const;
 };
 
 }  // namespace blender
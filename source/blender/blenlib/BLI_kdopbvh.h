@@ -233,6 +233,27 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+/* Batched queries: all queries are done in parallel, in an order that keeps spatially close
+ * queries together, which improves cache coherence. The callback has to be thread-safe.
+ * Like for the single queries, the results have to be initialized by the caller, their index and
+ * distance are used as initial upper bound. */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag);
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                int ray_len,
+                                float radius,
+                                BVHTreeRayHit *r_hit,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
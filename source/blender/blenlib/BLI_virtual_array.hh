@@ -37,6 +37,10 @@
  * see of the increased compile time and binary size is worth it.
  */
 
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 #include "BLI_array.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_span.hh"
@@ -659,4 +663,76 @@ inline void devirtualize_varray2(const VArray<T1> &varray1,
   func(varray1, varray2);
 }
 
+namespace varray_devirtualize_detail {
+
+template<typename Func> inline void devirtualize_span_or_single(const Func &func)
+{
+  func();
+}
+
+template<typename Func, typename T, typename... Ts>
+inline void devirtualize_span_or_single(const Func &func,
+                                        const VArray<T> &varray,
+                                        const VArray<Ts> &...varrays)
+{
+  if (varray.is_single()) {
+    const VArray_For_Single<T> varray_single{varray.get_internal_single(), varray.size()};
+    devirtualize_span_or_single(
+        [&](const auto &...devirtualized) { func(varray_single, devirtualized...); },
+        varrays...);
+  }
+  else {
+    const VArray_For_Span<T> varray_span{varray.get_internal_span()};
+    devirtualize_span_or_single(
+        [&](const auto &...devirtualized) { func(varray_span, devirtualized...); }, varrays...);
+  }
+}
+
+template<typename Func, typename... Ts>
+inline void devirtualize_varrays_impl(const Func &func, bool enable, const VArray<Ts> &...varrays)
+{
+  /* Support disabling the devirtualization to simplify benchmarking. */
+  if (enable && (... && (varrays.is_span() || varrays.is_single()))) {
+    devirtualize_span_or_single(func, varrays...);
+    return;
+  }
+  func(varrays...);
+}
+
+template<typename ArgsTuple, size_t... I>
+inline void devirtualize_varrays_unpack(const ArgsTuple &args,
+                                        bool enable,
+                                        std::index_sequence<I...> /*indices*/)
+{
+  constexpr size_t func_index = sizeof...(I);
+  devirtualize_varrays_impl(std::get<func_index>(args), enable, std::get<I>(args)...);
+}
+
+}  // namespace varray_devirtualize_detail
+
+/**
+ * Same as `devirtualize_varray2`, but for an arbitrary number of virtual arrays, which are
+ * followed by the function and optionally by the `enable` flag:
+ * `devirtualize_varrays(varray1, varray2, varray3, func, enable = true)`.
+ *
+ * When every virtual array is a span or a single value, the function is called with the
+ * devirtualized arrays. Otherwise it is called with the original virtual arrays. This instantiates
+ * the function 2^n + 1 times for n virtual arrays, so it should only be used with a small number
+ * of arrays.
+ */
+template<typename... Args> inline void devirtualize_varrays(const Args &...args)
+{
+  using LastArg = std::tuple_element_t<sizeof...(Args) - 1, std::tuple<Args...>>;
+  constexpr bool has_enable = std::is_same_v<LastArg, bool>;
+  constexpr size_t varrays_num = sizeof...(Args) - (has_enable ? 2 : 1);
+
+  const std::tuple<const Args &...> args_tuple{args...};
+  bool enable = true;
+  if constexpr (has_enable) {
+    enable = std::get<varrays_num + 1>(args_tuple);
+  }
+  varray_devirtualize_detail::devirtualize_varrays_unpack(
+      args_tuple, enable, std::make_index_sequence<varrays_num>());
+}
+
 }  // namespace blender
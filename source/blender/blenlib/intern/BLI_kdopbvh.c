@@ -2077,6 +2077,240 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_find_nearest_batch / BLI_bvhtree_ray_cast_batch
+ *
+ * Many queries are done in parallel. They are processed in the order of a Z-order curve through
+ * their positions, so that consecutive queries of a thread traverse mostly the same nodes.
+ * \{ */
+
+/* Number of queries below which no threads are used. */
+#define KDOPBVH_BATCH_THREAD_THRESHOLD 256
+/* Number of consecutive nearest point queries which reuse the result of the previous query. */
+#define KDOPBVH_BATCH_NEAREST_BLOCK_SIZE 64
+
+/* Spread the lower 10 bits so that there are two zero bits between each of them. */
+static uint bvhtree_batch_morton_spread(uint x)
+{
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+/**
+ * Return the query indices sorted by the grid cell that contains them, with cells ordered along a
+ * Z-order curve. Uses a counting sort, the grid resolution is chosen so that there are a few
+ * queries in every cell on average.
+ */
+static int *bvhtree_batch_spatial_order(const float (*co)[3], const int co_len)
+{
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < co_len; i++) {
+    minmax_v3v3_v3(min, max, co[i]);
+  }
+
+  int bits = 1;
+  while (bits < 7 && (8 << (3 * (bits + 1))) <= co_len) {
+    bits++;
+  }
+  const int cells_per_axis = 1 << bits;
+  const int keys_len = 1 << (3 * bits);
+
+  float scale[3];
+  for (int axis = 0; axis < 3; axis++) {
+    const float size = max[axis] - min[axis];
+    scale[axis] = (size > 0.0f) ? (float)cells_per_axis / size : 0.0f;
+  }
+
+  uint *keys = MEM_malloc_arrayN((size_t)co_len, sizeof(*keys), __func__);
+  int *offsets = MEM_calloc_arrayN((size_t)keys_len + 1, sizeof(*offsets), __func__);
+  for (int i = 0; i < co_len; i++) {
+    uint key = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      const float f = (co[i][axis] - min[axis]) * scale[axis];
+      /* Also handles NAN. */
+      const int cell = (f > 0.0f) ? ((f < (float)cells_per_axis) ? (int)f : cells_per_axis - 1) :
+                                    0;
+      key |= bvhtree_batch_morton_spread((uint)cell) << axis;
+    }
+    keys[i] = key;
+    offsets[key + 1]++;
+  }
+  for (int key = 0; key < keys_len; key++) {
+    offsets[key + 1] += offsets[key];
+  }
+
+  int *order = MEM_malloc_arrayN((size_t)co_len, sizeof(*order), __func__);
+  for (int i = 0; i < co_len; i++) {
+    order[offsets[keys[i]]++] = i;
+  }
+
+  MEM_freeN(keys);
+  MEM_freeN(offsets);
+  return order;
+}
+
+typedef struct BVHNearestBatchData {
+  BVHTree *tree;
+  const float (*co)[3];
+  int co_len;
+  const int *order;
+  BVHTreeNearest *nearest;
+  BVHTree_NearestPointCallback callback;
+  void *userdata;
+  int flag;
+} BVHNearestBatchData;
+
+static void bvhtree_find_nearest_batch_task_cb(void *__restrict userdata,
+                                               const int block,
+                                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHNearestBatchData *data = userdata;
+  /* Result of the previous query in the block, which is likely close to the current one. It only
+   * depends on the block, so that results don't depend on how the blocks are scheduled. */
+  BVHTreeNearest last;
+  last.index = -1;
+
+  const int iter_start = block * KDOPBVH_BATCH_NEAREST_BLOCK_SIZE;
+  const int iter_end = min_ii(iter_start + KDOPBVH_BATCH_NEAREST_BLOCK_SIZE, data->co_len);
+  for (int iter = iter_start; iter < iter_end; iter++) {
+    const int i = data->order[iter];
+    const float *co = data->co[i];
+    BVHTreeNearest *nearest = &data->nearest[i];
+
+    /* The previous result is a valid candidate for this query as well, using its distance as
+     * upper bound allows skipping most nodes right away. */
+    if (last.index != -1) {
+      const float dist_sq = len_squared_v3v3(co, last.co);
+      if (dist_sq < nearest->dist_sq) {
+        *nearest = last;
+        nearest->dist_sq = dist_sq;
+      }
+    }
+
+    BLI_bvhtree_find_nearest_ex(
+        data->tree, co, nearest, data->callback, data->userdata, data->flag);
+
+    if (nearest->index != -1) {
+      last = *nearest;
+    }
+  }
+}
+
+/**
+ * Find the nearest node for every coordinate, see #BLI_bvhtree_find_nearest_ex.
+ *
+ * \note When several nodes are at the same distance, the one that is found may differ from the
+ * one that #BLI_bvhtree_find_nearest_ex finds for the same coordinate. It does not depend on the
+ * number of threads though.
+ */
+void BLI_bvhtree_find_nearest_batch(BVHTree *tree,
+                                    const float (*co)[3],
+                                    int co_len,
+                                    BVHTreeNearest *r_nearest,
+                                    BVHTree_NearestPointCallback callback,
+                                    void *userdata,
+                                    int flag)
+{
+  if (co_len == 0) {
+    return;
+  }
+
+  BVHNearestBatchData data = {
+      .tree = tree,
+      .co = co,
+      .co_len = co_len,
+      .order = bvhtree_batch_spatial_order(co, co_len),
+      .nearest = r_nearest,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+
+  const int blocks_len = (int)divide_ceil_u((uint)co_len, KDOPBVH_BATCH_NEAREST_BLOCK_SIZE);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (co_len > KDOPBVH_BATCH_THREAD_THRESHOLD);
+  settings.min_iter_per_thread = KDOPBVH_BATCH_THREAD_THRESHOLD / KDOPBVH_BATCH_NEAREST_BLOCK_SIZE;
+  BLI_task_parallel_range(0, blocks_len, &data, bvhtree_find_nearest_batch_task_cb, &settings);
+
+  MEM_freeN((void *)data.order);
+}
+
+typedef struct BVHRayCastBatchData {
+  BVHTree *tree;
+  const float (*co)[3];
+  const float (*dir)[3];
+  const int *order;
+  float radius;
+  BVHTreeRayHit *hit;
+  BVHTree_RayCastCallback callback;
+  void *userdata;
+  int flag;
+} BVHRayCastBatchData;
+
+static void bvhtree_ray_cast_batch_task_cb(void *__restrict userdata,
+                                           const int iter,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHRayCastBatchData *data = userdata;
+  const int i = data->order[iter];
+  BLI_bvhtree_ray_cast_ex(data->tree,
+                          data->co[i],
+                          data->dir[i],
+                          data->radius,
+                          &data->hit[i],
+                          data->callback,
+                          data->userdata,
+                          data->flag);
+}
+
+/**
+ * Cast a ray for every origin and direction pair, see #BLI_bvhtree_ray_cast_ex.
+ * The rays are ordered by their origin.
+ */
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                int ray_len,
+                                float radius,
+                                BVHTreeRayHit *r_hit,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  if (ray_len == 0) {
+    return;
+  }
+
+  BVHRayCastBatchData data = {
+      .tree = tree,
+      .co = co,
+      .dir = dir,
+      .order = bvhtree_batch_spatial_order(co, ray_len),
+      .radius = radius,
+      .hit = r_hit,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (ray_len > KDOPBVH_BATCH_THREAD_THRESHOLD);
+  settings.min_iter_per_thread = KDOPBVH_BATCH_THREAD_THRESHOLD;
+  BLI_task_parallel_range(0, ray_len, &data, bvhtree_ray_cast_batch_task_cb, &settings);
+
+  MEM_freeN((void *)data.order);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
@@ -111,6 +111,10 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "2 **")
+TEST_PARSE_FAIL(Truncated12, "2 //")
+TEST_PARSE_FAIL(Truncated13, "2 %")
+TEST_PARSE_FAIL(BadPow, "2 ***2")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -145,6 +149,8 @@ TEST_CONST(Half, ".5", 0.5)
 TEST_CONST(Pi, "pi", M_PI)
 TEST_CONST(True, "True", TRUE_VAL)
 TEST_CONST(False, "False", FALSE_VAL)
+TEST_CONST(E, "e", M_E)
+TEST_CONST(Tau, "tau", 2.0 * M_PI)
 
 TEST_CONST(Sqrt, "sqrt(4)", 2.0)
 TEST_EVAL(Sqrt, "sqrt(x)", 4.0, 2.0)
@@ -156,6 +162,19 @@ TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
 TEST_CONST(Log2_1, "log(4, 2)", 2.0)
+TEST_CONST(Log2_2, "log2(8)", 3.0)
+TEST_CONST(Log10, "log10(100)", 2.0)
+
+TEST_CONST(Hypot, "hypot(3, 4)", 5.0)
+TEST_EVAL(Hypot, "hypot(x, 4)", 3.0, 5.0)
+
+TEST_CONST(CopySign, "copysign(2, -0.5)", -2.0)
+TEST_EVAL(CopySign, "copysign(2, x)", -0.5, -2.0)
+
+TEST_CONST(Tanh, "tanh(0)", 0.0)
+TEST_CONST(Float, "float(1.5)", 1.5)
+TEST_CONST(Bool1, "bool(0.5)", TRUE_VAL)
+TEST_CONST(Bool2, "bool(0)", FALSE_VAL)
 
 TEST_CONST(Round1, "round(-0.5)", -1.0)
 TEST_CONST(Round2, "round(-0.4)", 0.0)
@@ -205,6 +224,53 @@ TEST_EVAL(BinaryMul, "x*3", 2, 6.0)
 TEST_CONST(BinaryDiv, "3/2", 1.5)
 TEST_EVAL(BinaryDiv, "3/x", 2, 1.5)
 
+TEST_CONST(BinaryFloorDiv1, "7 // 2", 3.0)
+TEST_CONST(BinaryFloorDiv2, "-7 // 2", -4.0)
+TEST_CONST(BinaryFloorDiv3, "1 // 0.1", 9.0)
+TEST_CONST(BinaryFloorDiv4, "-1 // 0.1", -10.0)
+TEST_CONST(BinaryFloorDiv5, "7 // -2", -4.0)
+TEST_CONST(BinaryFloorDiv6, "-7.5 // -2", 3.0)
+TEST_CONST(BinaryFloorDiv7, "0.5 // 1", 0.0)
+TEST_CONST(BinaryFloorDiv8, "6 // 0.2", 29.0)
+TEST_EVAL(BinaryFloorDiv, "x // 2", 5.5, 2.0)
+
+TEST_CONST(BinaryMod1, "7 % 3", 1.0)
+TEST_CONST(BinaryMod2, "-7 % 3", 2.0)
+TEST_CONST(BinaryMod3, "7 % -3", -2.0)
+TEST_CONST(BinaryMod4, "6 % 3", 0.0)
+TEST_CONST(BinaryMod5, "1 % 0.1", 0.09999999999999995)
+TEST_CONST(BinaryMod6, "-1e-20 % 1", 1.0)
+TEST_CONST(BinaryMod7, "5 % inf", 5.0)
+TEST_CONST(BinaryMod8, "-7.5 % -2", -1.5)
+TEST_EVAL(BinaryMod, "x % 3", -1.5, 1.5)
+
+/* Python gives zero results of modulo the sign of the divisor, and of floor division the sign
+ * of the quotient. */
+TEST(expr_pylike, SignedZero)
+{
+  const char *expressions[] = {"-6 % 3", "6 % -3", "0 // 1", "0 // -1"};
+  const bool negative[] = {false, true, false, true};
+
+  for (size_t i = 0; i < ARRAY_SIZE(expressions); i++) {
+    ExprPyLike_Parsed *expr = BLI_expr_pylike_parse(expressions[i], nullptr, 0);
+    double result;
+
+    EXPECT_EQ(BLI_expr_pylike_eval(expr, nullptr, 0, &result), EXPR_PYLIKE_SUCCESS);
+    EXPECT_EQ(result, 0.0);
+    EXPECT_EQ(signbit(result) != 0, negative[i]) << expressions[i];
+
+    BLI_expr_pylike_free(expr);
+  }
+}
+
+TEST_CONST(BinaryPow1, "2 ** 3", 8.0)
+TEST_CONST(BinaryPow2, "2 ** 3 ** 2", 512.0)
+TEST_CONST(BinaryPow3, "-2 ** 2", -4.0)
+TEST_CONST(BinaryPow4, "2 ** -1", 0.5)
+TEST_CONST(BinaryPow5, "2 * 3 ** 2", 18.0)
+TEST_EVAL(BinaryPow1, "x ** 2", 3.0, 9.0)
+TEST_EVAL(BinaryPow2, "2 ** x", 3.0, 8.0)
+
 TEST_CONST(Arith1, "1 + -2 * 3", -5.0)
 TEST_CONST(Arith2, "(1 + -2) * 3", -3.0)
 TEST_CONST(Arith3, "-1 + 2 * 3", 5.0)
@@ -337,6 +403,17 @@ TEST_ERROR(SqrtDomain3, "sqrt(x)", 0.0, EXPR_PYLIKE_SUCCESS)
 TEST_ERROR(PowDomain1, "pow(-1, 0.5)", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain2, "pow(-1, x)", 0.5, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain3, "pow(-1, x)", 2.0, EXPR_PYLIKE_SUCCESS)
+TEST_ERROR(PowDomain4, "(-1) ** x", 0.5, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(PowDomain5, "x ** -1", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+
+TEST_ERROR(PowOverflow1, "10 ** x", 400.0, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(PowOverflow2, "x ** 2", 1e200, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(PowOverflow3, "x ** 2", 1e100, EXPR_PYLIKE_SUCCESS)
+
+TEST_ERROR(FloorDivZero1, "1 // x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(FloorDivZero2, "0 // x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(ModZero1, "1 % x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
+TEST_ERROR(ModZero2, "0 % x", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 
 TEST_ERROR(Mixed1, "sqrt(x) + 1 / max(0, x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(Mixed2, "sqrt(x) + 1 / max(0, x)", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
@@ -132,3 +132,75 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+/**
+ * Compare the batched queries with one query at a time. Only the distances are compared, because
+ * nodes at the same distance may be found in a different order.
+ */
+static void batch_queries_test(int points_len, int queries_len, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * points_len, __func__);
+  for (int i = 0; i < points_len; i++) {
+    rng_v3_round(points[i], 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  float(*queries)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  float(*directions)[3] = (float(*)[3])MEM_mallocN(sizeof(float[3]) * queries_len, __func__);
+  for (int i = 0; i < queries_len; i++) {
+    rng_v3_round(queries[i], 3, rng, 1000, 1.5f);
+    BLI_rng_get_float_unit_v3(rng, directions[i]);
+  }
+
+  BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(BVHTreeNearest) * queries_len,
+                                                          __func__);
+  BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(BVHTreeRayHit) * queries_len,
+                                                     __func__);
+  for (int i = 0; i < queries_len; i++) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+  BLI_bvhtree_find_nearest_batch(tree, queries, queries_len, nearest, nullptr, nullptr, 0);
+  BLI_bvhtree_ray_cast_batch(
+      tree, queries, directions, queries_len, 0.1f, hits, nullptr, nullptr, 0);
+
+  for (int i = 0; i < queries_len; i++) {
+    BVHTreeNearest nearest_single;
+    nearest_single.index = -1;
+    nearest_single.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, queries[i], &nearest_single, nullptr, nullptr);
+    EXPECT_NE(nearest[i].index, -1);
+    EXPECT_FLOAT_EQ(nearest[i].dist_sq, nearest_single.dist_sq);
+
+    BVHTreeRayHit hit_single;
+    hit_single.index = -1;
+    hit_single.dist = BVH_RAYCAST_DIST_MAX;
+    BLI_bvhtree_ray_cast_ex(
+        tree, queries[i], directions[i], 0.1f, &hit_single, nullptr, nullptr, 0);
+    EXPECT_EQ(hits[i].index == -1, hit_single.index == -1);
+    EXPECT_FLOAT_EQ(hits[i].dist, hit_single.dist);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(directions);
+  MEM_freeN(nearest);
+  MEM_freeN(hits);
+}
+
+TEST(kdopbvh, FindNearestBatch_1)
+{
+  batch_queries_test(1, 10, 1234);
+}
+TEST(kdopbvh, FindNearestBatch_10000)
+{
+  batch_queries_test(500, 10000, 12);
+}
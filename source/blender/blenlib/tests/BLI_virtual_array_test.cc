@@ -151,4 +151,38 @@ TEST(virtual_array, DerivedSpan)
   }
 }
 
+TEST(virtual_array, DevirtualizeVArrays)
+{
+  Array<int> values = {1, 2, 3, 4};
+  VArray_For_Span<int> varray_span{values};
+  VArray_For_Single<int> varray_single{10, 4};
+  auto get_func = [](const int64_t index) { return (int)(index * 100); };
+  VArray_For_Func<int, decltype(get_func)> varray_func{4, get_func};
+
+  int devirtualized_calls = 0;
+  int sum = 0;
+  auto func = [&](const auto &a, const auto &b) {
+    using VArrayA = std::decay_t<decltype(a)>;
+    using VArrayB = std::decay_t<decltype(b)>;
+    if (!std::is_same_v<VArrayA, VArray<int>> && !std::is_same_v<VArrayB, VArray<int>>) {
+      devirtualized_calls++;
+    }
+    for (const int64_t i : IndexRange(4)) {
+      sum += a[i] * b[i];
+    }
+  };
+
+  devirtualize_varrays(varray_span, varray_single, func);
+  EXPECT_EQ(devirtualized_calls, 1);
+  EXPECT_EQ(sum, 100);
+
+  devirtualize_varrays(varray_span, varray_func, func, true);
+  EXPECT_EQ(devirtualized_calls, 1);
+  EXPECT_EQ(sum, 100 + 2000);
+
+  devirtualize_varrays(varray_single, varray_span, func, false);
+  EXPECT_EQ(devirtualized_calls, 1);
+  EXPECT_EQ(sum, 200 + 2000);
+}
+
 }  // namespace blender::tests
@@ -0,0 +1,110 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_kdopbvh.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+#define NUM_RUN_AVERAGED 10
+
+/* Random points in a unit cube, so that the queries are not coherent in their input order. */
+static float (*random_points(RNG *rng, const int points_len))[3]
+{
+  float(*points)[3] = (float(*)[3])MEM_malloc_arrayN(points_len, sizeof(float[3]), __func__);
+  for (int i = 0; i < points_len; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      points[i][axis] = BLI_rng_get_float(rng);
+    }
+  }
+  return points;
+}
+
+static void init_nearest(BVHTreeNearest *nearest, const int queries_len)
+{
+  for (int i = 0; i < queries_len; i++) {
+    nearest[i].index = -1;
+    nearest[i].dist_sq = FLT_MAX;
+  }
+}
+
+static void print_throughput(const char *id, const double time, const int queries_len)
+{
+  printf("\t%s: %fs on average over %d runs, %.2f M queries per second\n",
+         id,
+         time,
+         NUM_RUN_AVERAGED,
+         (double)queries_len / time / 1e6);
+}
+
+static void find_nearest_batch_test(const char *id, const int points_len, const int queries_len)
+{
+  printf("\n========== STARTING %s ==========\n", id);
+
+  BLI_threadapi_init();
+
+  RNG *rng = BLI_rng_new(0);
+  float(*points)[3] = random_points(rng, points_len);
+  float(*queries)[3] = random_points(rng, queries_len);
+
+  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0f, 2, 6);
+  for (int i = 0; i < points_len; i++) {
+    BLI_bvhtree_insert(tree, i, points[i], 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  BVHTreeNearest *nearest_single = (BVHTreeNearest *)MEM_malloc_arrayN(
+      queries_len, sizeof(BVHTreeNearest), __func__);
+  BVHTreeNearest *nearest_batch = (BVHTreeNearest *)MEM_malloc_arrayN(
+      queries_len, sizeof(BVHTreeNearest), __func__);
+
+  double time_single = 0.0;
+  double time_batch = 0.0;
+  for (int run = 0; run < NUM_RUN_AVERAGED; run++) {
+    init_nearest(nearest_single, queries_len);
+    const double start_single = PIL_check_seconds_timer();
+    for (int i = 0; i < queries_len; i++) {
+      BLI_bvhtree_find_nearest(tree, queries[i], &nearest_single[i], nullptr, nullptr);
+    }
+    time_single += PIL_check_seconds_timer() - start_single;
+
+    init_nearest(nearest_batch, queries_len);
+    const double start_batch = PIL_check_seconds_timer();
+    BLI_bvhtree_find_nearest_batch(
+        tree, queries, queries_len, nearest_batch, nullptr, nullptr, 0);
+    time_batch += PIL_check_seconds_timer() - start_batch;
+  }
+
+  for (int i = 0; i < queries_len; i++) {
+    EXPECT_FLOAT_EQ(nearest_single[i].dist_sq, nearest_batch[i].dist_sq);
+  }
+
+  print_throughput("Single queries", time_single / NUM_RUN_AVERAGED, queries_len);
+  print_throughput("Batched queries", time_batch / NUM_RUN_AVERAGED, queries_len);
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+  MEM_freeN(points);
+  MEM_freeN(queries);
+  MEM_freeN(nearest_single);
+  MEM_freeN(nearest_batch);
+
+  printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(kdopbvh, FindNearestBatch100kPoints1MQueries)
+{
+  find_nearest_batch_test("FindNearestBatch - 100k points - 1M queries", 100000, 1000000);
+}
+
+TEST(kdopbvh, FindNearestBatch1MPoints100kQueries)
+{
+  find_nearest_batch_test("FindNearestBatch - 1M points - 100k queries", 1000000, 100000);
+}
@@ -154,6 +154,11 @@ enum {
 extern const BMOpDefine *bmo_opdefines[];
 extern const int bmo_opdefines_total;
 
+/* The icosahedron that create_icosphere subdivides, with its UVs per face corner. */
+extern const float BM_icosphere_verts[12][3];
+extern const short BM_icosphere_faces[20][3];
+extern const float BM_icosphere_uvs[60][2];
+
 /*------specific operator helper functions-------*/
 void BM_mesh_esubdivide(BMesh *bm,
                         const char edge_hflag,
@@ -33,7 +33,8 @@
 
 /* ************************ primitives ******************* */
 
-static const float icovert[12][3] = {
+/* The icosahedron of #bmo_create_icosphere_exec, also used by the ico sphere geometry node. */
+const float BM_icosphere_verts[12][3] = {
     {0.0f, 0.0f, -200.0f},
     {144.72f, -105.144f, -89.443f},
     {-55.277f, -170.128, -89.443f},
@@ -48,13 +49,13 @@ static const float icovert[12][3] = {
     {0.0f, 0.0f, 200.0f},
 };
 
-static const short icoface[20][3] = {
+const short BM_icosphere_faces[20][3] = {
     {0, 1, 2},  {1, 0, 5},   {0, 2, 3},  {0, 3, 4},  {0, 4, 5},  {1, 5, 10},  {2, 1, 6},
     {3, 2, 7},  {4, 3, 8},   {5, 4, 9},  {1, 10, 6}, {2, 6, 7},  {3, 7, 8},   {4, 8, 9},
     {5, 9, 10}, {6, 10, 11}, {7, 6, 11}, {8, 7, 11}, {9, 8, 11}, {10, 9, 11},
 };
 
-static const float icouvs[60][2] = {
+const float BM_icosphere_uvs[60][2] = {
     {0.181819f, 0.000000f}, {0.272728f, 0.157461f}, {0.090910f, 0.157461f}, {0.272728f, 0.157461f},
     {0.363637f, 0.000000f}, {0.454546f, 0.157461f}, {0.909091f, 0.000000f}, {1.000000f, 0.157461f},
     {0.818182f, 0.157461f}, {0.727273f, 0.000000f}, {0.818182f, 0.157461f}, {0.636364f, 0.157461f},
@@ -994,9 +995,9 @@ void bmo_create_icosphere_exec(BMesh *bm, BMOperator *op)
   /* phi = 0.25f * (float)M_PI; */          /* UNUSED */
 
   for (a = 0; a < 12; a++) {
-    vec[0] = dia_div * icovert[a][0];
-    vec[1] = dia_div * icovert[a][1];
-    vec[2] = dia_div * icovert[a][2];
+    vec[0] = dia_div * BM_icosphere_verts[a][0];
+    vec[1] = dia_div * BM_icosphere_verts[a][1];
+    vec[2] = dia_div * BM_icosphere_verts[a][2];
     eva[a] = BM_vert_create(bm, vec, NULL, BM_CREATE_NOP);
 
     BMO_vert_flag_enable(bm, eva[a], VERT_MARK);
@@ -1007,9 +1008,9 @@ void bmo_create_icosphere_exec(BMesh *bm, BMOperator *op)
     BMFace *f;
     BMVert *v1, *v2, *v3;
 
-    v1 = eva[icoface[a][0]];
-    v2 = eva[icoface[a][1]];
-    v3 = eva[icoface[a][2]];
+    v1 = eva[BM_icosphere_faces[a][0]];
+    v2 = eva[BM_icosphere_faces[a][1]];
+    v3 = eva[BM_icosphere_faces[a][2]];
 
     f = BM_face_create_quad_tri(bm, v1, v2, v3, NULL, NULL, BM_CREATE_NOP);
 
@@ -1023,8 +1024,8 @@ void bmo_create_icosphere_exec(BMesh *bm, BMOperator *op)
       int loop_index;
       BM_ITER_ELEM_INDEX (l, &liter, f, BM_LOOPS_OF_FACE, loop_index) {
         MLoopUV *luv = BM_ELEM_CD_GET_VOID_P(l, cd_loop_uv_offset);
-        luv->uv[0] = icouvs[uvi][0];
-        luv->uv[1] = icouvs[uvi][1];
+        luv->uv[0] = BM_icosphere_uvs[uvi][0];
+        luv->uv[1] = BM_icosphere_uvs[uvi][1];
         uvi++;
       }
     }
@@ -78,6 +78,16 @@ void DEG_graph_relations_update(struct Depsgraph *graph);
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update, in the given graph.
+ *
+ * Used when only relations of this ID are known to be changed (adding or removing a modifier or
+ * constraint, for example). Allows to update relations of the ID without full rebuild of the
+ * graph. Falls back to tagging all relations for update when this is not possible. */
+void DEG_graph_id_tag_relations_update(struct Depsgraph *graph, struct ID *id);
+
+/* Tag relations of the given ID for update, in all dependency graphs. */
+void DEG_id_relations_tag_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /* Handle for components to define their dependencies from callbacks.
@@ -62,10 +62,29 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Tracing */
+
+typedef enum eDEGTraceWriteResult {
+  DEG_TRACE_WRITE_SUCCESS = 0,
+  /* Nothing was recorded, the file is not written. */
+  DEG_TRACE_WRITE_EMPTY,
+  DEG_TRACE_WRITE_CANT_OPEN_FILE,
+} eDEGTraceWriteResult;
+
+/* Write operations recorded while G_DEBUG_DEPSGRAPH_TRACE is enabled as Chrome trace event
+ * JSON. */
+eDEGTraceWriteResult DEG_debug_trace_write(struct Depsgraph *graph, const char *filepath);
+void DEG_debug_trace_clear(struct Depsgraph *graph);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
 bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2);
+/* Same as above, but operations of IDs which are only in the second graph are ignored. Incremental
+ * relation updates keep the nodes of IDs which are not used anymore. */
+bool DEG_debug_compare_ignoring_extra_ids(const struct Depsgraph *graph1,
+                                          const struct Depsgraph *graph2);
 
 /* Check that dependencies in the graph are really up to date. */
 bool DEG_debug_graph_relations_validate(struct Depsgraph *graph,
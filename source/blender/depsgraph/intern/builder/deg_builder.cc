@@ -230,6 +230,12 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
     /* Restore recalc flags from original ID, which could possibly contain recalc flags set by
      * an operator and then were carried on by the undo system. */
     flag |= id_orig->recalc;
+    /* The recalc flags of the original ID don't tell whether every transform tag came with
+     * #ID_RECALC_TRANSFORM_ONLY, so the edits before the relations rebuild need a full
+     * copy-on-write update. */
+    if (id_orig->recalc != 0) {
+      flag |= ID_RECALC_COPY_ON_WRITE;
+    }
     if (flag != 0) {
       graph_id_tag_update(bmain, graph, id_node->id_orig, flag, DEG_UPDATE_SOURCE_RELATIONS);
     }
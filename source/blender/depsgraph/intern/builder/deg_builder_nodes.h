@@ -103,17 +103,19 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
 
   int foreach_id_cow_detect_need_for_update_callback(ID *id_cow_self, ID *id_pointer);
 
-  IDNode *add_id_node(ID *id);
+  virtual IDNode *add_id_node(ID *id);
   IDNode *find_id_node(ID *id);
   TimeSourceNode *add_time_source();
 
-  ComponentNode *add_component_node(ID *id, NodeType comp_type, const char *comp_name = "");
+  virtual ComponentNode *add_component_node(ID *id,
+                                            NodeType comp_type,
+                                            const char *comp_name = "");
 
-  OperationNode *add_operation_node(ComponentNode *comp_node,
-                                    OperationCode opcode,
-                                    const DepsEvalOperationCb &op = nullptr,
-                                    const char *name = "",
-                                    int name_tag = -1);
+  virtual OperationNode *add_operation_node(ComponentNode *comp_node,
+                                            OperationCode opcode,
+                                            const DepsEvalOperationCb &op = nullptr,
+                                            const char *name = "",
+                                            int name_tag = -1);
   OperationNode *add_operation_node(ID *id,
                                     NodeType comp_type,
                                     const char *comp_name,
@@ -128,12 +130,12 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
                                     const char *name = "",
                                     int name_tag = -1);
 
-  OperationNode *ensure_operation_node(ID *id,
-                                       NodeType comp_type,
-                                       OperationCode opcode,
-                                       const DepsEvalOperationCb &op = nullptr,
-                                       const char *name = "",
-                                       int name_tag = -1);
+  virtual OperationNode *ensure_operation_node(ID *id,
+                                               NodeType comp_type,
+                                               OperationCode opcode,
+                                               const DepsEvalOperationCb &op = nullptr,
+                                               const char *name = "",
+                                               int name_tag = -1);
 
   bool has_operation_node(ID *id,
                           NodeType comp_type,
@@ -335,10 +335,10 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                               Node *node_to,
                               const char *description,
                               int flags = 0);
-  Relation *add_operation_relation(OperationNode *node_from,
-                                   OperationNode *node_to,
-                                   const char *description,
-                                   int flags = 0);
+  virtual Relation *add_operation_relation(OperationNode *node_from,
+                                           OperationNode *node_to,
+                                           const char *description,
+                                           int flags = 0);
 
   template<typename KeyType>
   DepsNodeHandle create_node_handle(const KeyType &key, const char *default_name = "");
@@ -358,6 +358,11 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   template<typename KeyFrom, typename KeyTo>
   bool is_same_nodetree_node_dependency(const KeyFrom &key_from, const KeyTo &key_to);
 
+  /* State which demotes currently built entities. */
+  Scene *scene_;
+
+  BuilderMap built_map_;
+
  private:
   struct BuilderWalkUserData {
     DepsgraphRelationBuilder *builder;
@@ -370,10 +375,6 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   static void constraint_walk(bConstraint *con, ID **idpoin, bool is_reference, void *user_data);
 
-  /* State which demotes currently built entities. */
-  Scene *scene_;
-
-  BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
 };
 
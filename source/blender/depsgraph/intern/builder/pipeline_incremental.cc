@@ -0,0 +1,391 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+#include "pipeline_incremental.h"
+
+#include "PIL_time.h"
+
+#include "BLI_listbase.h"
+
+#include "BKE_global.h"
+
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace blender::deg {
+
+namespace {
+
+class DepsgraphIncrementalNodeBuilder : public DepsgraphNodeBuilder {
+ public:
+  DepsgraphIncrementalNodeBuilder(Main *bmain,
+                                  Depsgraph *graph,
+                                  DepsgraphBuilderCache *cache,
+                                  Span<ID *> ids)
+      : DepsgraphNodeBuilder(bmain, graph, cache), nodes_match_(true)
+  {
+    ids_.add_multiple(ids);
+    /* Do not go into dependencies, they are already in the graph. */
+    for (IDNode *id_node : graph->id_nodes) {
+      if (!ids_.contains(id_node->id_orig)) {
+        built_map_.tagBuild(id_node->id_orig);
+      }
+    }
+    /* Match the state set up by build_view_layer(). */
+    scene_ = graph->scene;
+    view_layer_ = graph->view_layer;
+    view_layer_index_ = 0;
+  }
+
+  using DepsgraphNodeBuilder::add_operation_node;
+
+  IDNode *add_id_node(ID *id) override
+  {
+    /* Keep existing node as-is: resetting its previous state would cause re-evaluation. */
+    IDNode *id_node = find_id_node(id);
+    if (id_node != nullptr) {
+      return id_node;
+    }
+    nodes_match_ = false;
+    return DepsgraphNodeBuilder::add_id_node(id);
+  }
+
+  ComponentNode *add_component_node(ID *id, NodeType comp_type, const char *comp_name) override
+  {
+    IDNode *id_node = add_id_node(id);
+    if (id_node->find_component(comp_type, comp_name) == nullptr) {
+      nodes_match_ = false;
+    }
+    return DepsgraphNodeBuilder::add_component_node(id, comp_type, comp_name);
+  }
+
+  OperationNode *add_operation_node(ComponentNode *comp_node,
+                                    OperationCode opcode,
+                                    const DepsEvalOperationCb &op,
+                                    const char *name,
+                                    int name_tag) override
+  {
+    OperationNode *op_node = comp_node->find_operation(opcode, name, name_tag);
+    if (op_node == nullptr) {
+      nodes_match_ = false;
+      /* Component of an ID which is not being updated is finalized already. */
+      comp_node->reopen_build();
+      return DepsgraphNodeBuilder::add_operation_node(comp_node, opcode, op, name, name_tag);
+    }
+    /* Callback might be referring to an index of a modifier or constraint, which could have
+     * changed since the graph was built. */
+    op_node->evaluate = op;
+    visited_operations_.add(op_node);
+    return op_node;
+  }
+
+  OperationNode *ensure_operation_node(ID *id,
+                                       NodeType comp_type,
+                                       OperationCode opcode,
+                                       const DepsEvalOperationCb &op,
+                                       const char *name,
+                                       int name_tag) override
+  {
+    /* Always go via add_operation_node(), so that existing operations are marked as visited. */
+    ComponentNode *comp_node = add_component_node(id, comp_type, "");
+    OperationNode *op_node = comp_node->find_operation(opcode, name, name_tag);
+    if (op_node != nullptr && visited_operations_.contains(op_node)) {
+      return op_node;
+    }
+    return add_operation_node(comp_node, opcode, op, name, name_tag);
+  }
+
+  /* Check whether the builder did not request any node which is not in the graph yet, and that
+   * all operations of the updated IDs were requested. */
+  bool nodes_match()
+  {
+    if (!nodes_match_) {
+      return false;
+    }
+    for (ID *id : ids_) {
+      IDNode *id_node = find_id_node(id);
+      for (ComponentNode *comp_node : id_node->components.values()) {
+        for (OperationNode *op_node : comp_node->operations_map->values()) {
+          /* Copy-on-write operation is only created together with the ID node. */
+          if (op_node->opcode == OperationCode::COPY_ON_WRITE) {
+            continue;
+          }
+          if (!visited_operations_.contains(op_node)) {
+            return false;
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+ protected:
+  Set<ID *> ids_;
+  Set<OperationNode *> visited_operations_;
+  bool nodes_match_;
+};
+
+class DepsgraphIncrementalRelationBuilder : public DepsgraphRelationBuilder {
+ public:
+  DepsgraphIncrementalRelationBuilder(Main *bmain,
+                                      Depsgraph *graph,
+                                      DepsgraphBuilderCache *cache,
+                                      Span<ID *> ids)
+      : DepsgraphRelationBuilder(bmain, graph, cache)
+  {
+    Set<ID *> ids_set;
+    ids_set.add_multiple(ids);
+    for (IDNode *id_node : graph->id_nodes) {
+      if (!ids_set.contains(id_node->id_orig)) {
+        built_map_.tagBuild(id_node->id_orig);
+      }
+    }
+    scene_ = graph->scene;
+  }
+
+  Relation *add_operation_relation(OperationNode *node_from,
+                                   OperationNode *node_to,
+                                   const char *description,
+                                   int flags) override
+  {
+    /* Only relations leading to the updated IDs were removed, the ones going from them to other
+     * IDs are still in the graph. */
+    return DepsgraphRelationBuilder::add_operation_relation(
+        node_from, node_to, description, flags | RELATION_CHECK_BEFORE_ADD);
+  }
+};
+
+}  // namespace
+
+IncrementalBuilderPipeline::IncrementalBuilderPipeline(::Depsgraph *graph, Span<ID *> ids)
+    : AbstractBuilderPipeline(graph), ids_(ids), nodes_match_(false)
+{
+}
+
+bool IncrementalBuilderPipeline::try_build()
+{
+  double start_time = 0.0;
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    start_time = PIL_check_seconds_timer();
+  }
+
+  if (!can_build_incrementally(ids_)) {
+    return false;
+  }
+
+  for (ID *id : ids_) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      comp_node->reopen_build();
+    }
+  }
+
+  {
+    unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
+    build_nodes(*node_builder);
+  }
+  if (!nodes_match_) {
+    return false;
+  }
+
+  /* Only react on changes of special evaluation flags and custom data masks which are caused by
+   * this update. Note that flags requested by the removed relations are kept. */
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+  }
+
+  /* The relations leading to these operations might have been removed by the previous build,
+   * see #deg_graph_remove_unused_noops(). */
+  Set<OperationNode *> unused_noops;
+  for (OperationNode *op_node : deg_graph_->operations) {
+    if (op_node->is_noop() && op_node->outlinks.is_empty() &&
+        !(op_node->flag & DEPSOP_FLAG_PINNED)) {
+      unused_noops.add(op_node);
+    }
+  }
+
+  Set<ID *> rebuilt_ids;
+  Vector<ID *> ids_to_rebuild(ids_);
+  while (!ids_to_rebuild.is_empty()) {
+    rebuilt_ids.add_multiple(ids_to_rebuild);
+    remove_relations(ids_to_rebuild);
+    relation_ids_ = ids_to_rebuild;
+    {
+      unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
+      build_relations(*relation_builder);
+    }
+    /* Relations of the IDs which own the no-ops that are used now are built again, which restores
+     * the relations leading to the no-ops. This can make no-ops of further IDs used. */
+    ids_to_rebuild = find_ids_with_used_pruned_noops(unused_noops, rebuilt_ids);
+    if (!can_build_incrementally(ids_to_rebuild)) {
+      return false;
+    }
+  }
+  build_step_finalize();
+
+  for (ID *id : rebuilt_ids) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    id_node->tag_update(deg_graph_, DEG_UPDATE_SOURCE_RELATIONS);
+  }
+
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph relations of %d ID(s) updated in %f seconds.\n",
+           static_cast<int>(rebuilt_ids.size()),
+           PIL_check_seconds_timer() - start_time);
+  }
+  return true;
+}
+
+Vector<ID *> IncrementalBuilderPipeline::find_ids_with_used_pruned_noops(
+    const Set<OperationNode *> &unused_noops, const Set<ID *> &rebuilt_ids) const
+{
+  Vector<ID *> ids;
+  for (OperationNode *op_node : unused_noops) {
+    if (op_node->outlinks.is_empty()) {
+      continue;
+    }
+    ID *id = op_node->owner->owner->id_orig;
+    if (!rebuilt_ids.contains(id)) {
+      ids.append_non_duplicates(id);
+    }
+  }
+  return ids;
+}
+
+bool IncrementalBuilderPipeline::can_build_incrementally(Span<ID *> ids) const
+{
+  /* Changes in effectors and colliders affect relations of other objects. */
+  for (int i = 0; i < DEG_PHYSICS_RELATIONS_NUM; i++) {
+    if (deg_graph_->physics_relations[i] != nullptr) {
+      return false;
+    }
+  }
+  for (ID *id : ids) {
+    if (GS(id->name) != ID_OB) {
+      return false;
+    }
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    if (id_node == nullptr) {
+      return false;
+    }
+    /* Relations to rigid body simulated objects are built by the scene. */
+    const Object *object = reinterpret_cast<const Object *>(id);
+    if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr) {
+      return false;
+    }
+    /* Relations to ID properties used by drivers are built by the IDs which own the drivers. */
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (op_node->opcode == OperationCode::ID_PROPERTY) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void IncrementalBuilderPipeline::remove_relations(Span<ID *> ids)
+{
+  for (ID *id : ids) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations_map->values()) {
+        while (!op_node->inlinks.is_empty()) {
+          Relation *rel = op_node->inlinks.last();
+          rel->unlink();
+          delete rel;
+        }
+      }
+    }
+  }
+}
+
+unique_ptr<DepsgraphNodeBuilder> IncrementalBuilderPipeline::construct_node_builder()
+{
+  return std::make_unique<DepsgraphIncrementalNodeBuilder>(
+      bmain_, deg_graph_, &builder_cache_, ids_);
+}
+
+unique_ptr<DepsgraphRelationBuilder> IncrementalBuilderPipeline::construct_relation_builder()
+{
+  return std::make_unique<DepsgraphIncrementalRelationBuilder>(
+      bmain_, deg_graph_, &builder_cache_, relation_ids_);
+}
+
+void IncrementalBuilderPipeline::build_nodes(DepsgraphNodeBuilder &node_builder)
+{
+  for (ID *id : ids_) {
+    Object *object = reinterpret_cast<Object *>(id);
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    /* Same indexing as in DepsgraphNodeBuilder::build_view_layer(). */
+    int base_index = -1;
+    if (id_node->has_base) {
+      int index = 0;
+      LISTBASE_FOREACH (Base *, base, &view_layer_->object_bases) {
+        if (!node_builder.need_pull_base_into_graph(base)) {
+          continue;
+        }
+        if (base->object == object) {
+          base_index = index;
+          break;
+        }
+        index++;
+      }
+      if (base_index == -1) {
+        nodes_match_ = false;
+        return;
+      }
+    }
+    /* Visibility and linked state are accumulated from all users of the object, so preserve
+     * them instead of taking the ones from this build. */
+    const eDepsNode_LinkedState_Type linked_state = id_node->linked_state;
+    const bool is_directly_visible = id_node->is_directly_visible;
+    const bool has_base = id_node->has_base;
+    node_builder.build_object(base_index, object, linked_state, is_directly_visible);
+    id_node->linked_state = linked_state;
+    id_node->is_directly_visible = is_directly_visible;
+    id_node->has_base = has_base;
+  }
+  nodes_match_ = static_cast<DepsgraphIncrementalNodeBuilder &>(node_builder).nodes_match();
+}
+
+void IncrementalBuilderPipeline::build_relations(DepsgraphRelationBuilder &relation_builder)
+{
+  for (ID *id : relation_ids_) {
+    relation_builder.build_object(reinterpret_cast<Object *>(id));
+  }
+  for (ID *id : relation_ids_) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    relation_builder.build_copy_on_write_relations(id_node);
+    relation_builder.build_driver_relations(id_node);
+  }
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,80 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "pipeline.h"
+
+namespace blender {
+namespace deg {
+
+struct OperationNode;
+
+/* Update relations of the given objects in an already built dependency graph, without touching
+ * the rest of the graph.
+ *
+ * General notes:
+ *
+ * - Nodes are never created or removed. The node builder is run on the objects in a verification
+ *   mode, and if the set of operations differs from the one in the graph the update is cancelled.
+ *
+ * - All relations which lead to operations of the objects are removed and built again. Relations
+ *   from the objects to other IDs are re-added with a duplicate check, so that they are kept.
+ *
+ * - The full build removes the relations leading to no-op operations that nothing depends on.
+ *   When such an operation of another object gains a user, the relations of that object are
+ *   built again as well, to restore the removed relations.
+ *
+ * - Whenever the objects might be affecting relations of other IDs (physics, rigid body, ID
+ *   properties used by drivers of other IDs) the update is cancelled as well.
+ *
+ * When the update is cancelled the caller is expected to do a full rebuild of the graph. */
+class IncrementalBuilderPipeline : public AbstractBuilderPipeline {
+ public:
+  IncrementalBuilderPipeline(::Depsgraph *graph, Span<ID *> ids);
+
+  /* Returns false if the graph can not be updated incrementally. The graph is then left in a
+   * state which requires full rebuild. */
+  bool try_build();
+
+ protected:
+  virtual unique_ptr<DepsgraphNodeBuilder> construct_node_builder() override;
+  virtual unique_ptr<DepsgraphRelationBuilder> construct_relation_builder() override;
+
+  virtual void build_nodes(DepsgraphNodeBuilder &node_builder) override;
+  virtual void build_relations(DepsgraphRelationBuilder &relation_builder) override;
+
+ private:
+  bool can_build_incrementally(Span<ID *> ids) const;
+  void remove_relations(Span<ID *> ids);
+  Vector<ID *> find_ids_with_used_pruned_noops(const Set<OperationNode *> &unused_noops,
+                                               const Set<ID *> &rebuilt_ids) const;
+
+  Span<ID *> ids_;
+  /* IDs whose relations are built by the current relation builder. */
+  Span<ID *> relation_ids_;
+  bool nodes_match_;
+};
+
+}  // namespace deg
+}  // namespace blender
@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/builder/pipeline_incremental.h"
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+
+#include "BKE_anim_data.h"
+#include "BKE_fcurve.h"
+#include "BKE_fcurve_driver.h"
+#include "BKE_main.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_debug.h"
+
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::deg::tests {
+
+class DepsgraphIncrementalBuildTest : public BlendfileLoadingBaseTest {
+ protected:
+  Main *bmain;
+  Scene *scene;
+  ViewLayer *view_layer;
+  Object *driven;
+  Object *target;
+  DriverVar *driver_variable;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+
+    bmain = BKE_main_new();
+    scene = BKE_scene_add(bmain, "Scene");
+    view_layer = static_cast<ViewLayer *>(scene->view_layers.first);
+    driven = BKE_object_add(bmain, view_layer, OB_EMPTY, "Driven");
+    target = BKE_object_add(bmain, view_layer, OB_MESH, "Target");
+
+    /* The driver has no target yet, so the relations change when it gets one, but the
+     * operations of the driven object stay the same. */
+    AnimData *adt = BKE_animdata_add_id(&driven->id);
+    FCurve *fcu = BKE_fcurve_create();
+    fcu->rna_path = BLI_strdup("location");
+    fcu->array_index = 0;
+    fcu->driver = static_cast<ChannelDriver *>(MEM_callocN(sizeof(ChannelDriver), __func__));
+    fcu->driver->type = DRIVER_TYPE_AVERAGE;
+    driver_variable = driver_add_new_variable(fcu->driver);
+    driver_variable->targets[0].idtype = ID_OB;
+    driver_variable->targets[0].rna_path = BLI_strdup("dimensions");
+    BLI_addtail(&adt->drivers, fcu);
+
+    build_full();
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  void build_full()
+  {
+    depsgraph_free();
+    depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(depsgraph);
+  }
+
+  bool build_incremental(Object *object)
+  {
+    ID *id = &object->id;
+    IncrementalBuilderPipeline builder(depsgraph, Span<ID *>(&id, 1));
+    return builder.try_build();
+  }
+
+  /* Compare with the relations built from scratch. */
+  bool matches_full_build(const bool ignore_extra_ids = false)
+  {
+    ::Depsgraph *full_depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_view_layer(full_depsgraph);
+    const bool is_equal = ignore_extra_ids ?
+                              DEG_debug_compare_ignoring_extra_ids(full_depsgraph, depsgraph) :
+                              DEG_debug_compare(full_depsgraph, depsgraph);
+    DEG_graph_free(full_depsgraph);
+    return is_equal;
+  }
+};
+
+/* The parent operation is only created for objects with a parent, so the update is only done
+ * incrementally when the parent changes to another one. */
+TEST_F(DepsgraphIncrementalBuildTest, change_parent)
+{
+  Object *parent = BKE_object_add(bmain, view_layer, OB_EMPTY, "Parent");
+  driven->parent = parent;
+  driven->partype = PAROBJECT;
+  build_full();
+
+  driven->parent = target;
+  ASSERT_TRUE(build_incremental(driven));
+  EXPECT_TRUE(matches_full_build());
+}
+
+/* The dimensions operation of the target is a no-op without users, so the full build removed the
+ * relations leading to it. They have to be restored when the driver starts using it. */
+TEST_F(DepsgraphIncrementalBuildTest, driver_uses_unused_noop)
+{
+  driver_variable->targets[0].id = &target->id;
+  ASSERT_TRUE(build_incremental(driven));
+  EXPECT_TRUE(matches_full_build());
+
+  driver_variable->targets[0].id = nullptr;
+  ASSERT_TRUE(build_incremental(driven));
+  EXPECT_TRUE(matches_full_build());
+}
+
+/* Nodes of IDs which are not used anymore are kept by the incremental update. */
+TEST_F(DepsgraphIncrementalBuildTest, unused_id_is_kept)
+{
+  Object *parent = BKE_object_add_only_object(bmain, OB_EMPTY, "Parent");
+  driven->parent = parent;
+  driven->partype = PAROBJECT;
+  build_full();
+
+  driven->parent = target;
+  ASSERT_TRUE(build_incremental(driven));
+  EXPECT_FALSE(matches_full_build());
+  EXPECT_TRUE(matches_full_build(true));
+}
+
+}  // namespace blender::deg::tests
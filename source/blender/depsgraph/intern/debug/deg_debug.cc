@@ -23,20 +23,54 @@
 
 #include "intern/debug/deg_debug.h"
 
+#include <fstream>
+#include <sstream>
+
 #include "BLI_console.h"
+#include "BLI_fileops.h"
 #include "BLI_hash.h"
+#include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
 #include "PIL_time_utildefines.h"
 
+#include "BKE_appdir.h"
 #include "BKE_global.h"
 
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
 namespace blender::deg {
 
 DepsgraphDebug::DepsgraphDebug()
-    : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
+    : flags(G.debug),
+      is_ever_evaluated(false),
+      graph_evaluation_start_time_(0),
+      trace_start_time_(PIL_check_seconds_timer()),
+      trace_evaluation_start_time_(0),
+      trace_events_num_(0)
+{
+}
+
+DepsgraphDebug::~DepsgraphDebug()
 {
+  /* Tracing enabled from the command line has no other way to get the trace out. */
+  if (!do_trace() || trace_events_num_ == 0) {
+    return;
+  }
+  /* Don't overwrite traces of previous sessions, which use the same file names. */
+  static std::atomic<int> trace_counter = 0;
+  char filepath[FILE_MAX];
+  do {
+    char filename[64];
+    BLI_snprintf(filename, sizeof(filename), "depsgraph_trace_%d.json", trace_counter++);
+    BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_base(), filename);
+  } while (BLI_exists(filepath));
+  if (trace_write(filepath) == DEG_TRACE_WRITE_SUCCESS) {
+    printf("Depsgraph evaluation trace written to %s\n", filepath);
+  }
 }
 
 bool DepsgraphDebug::do_time_debug() const
@@ -44,8 +78,17 @@ bool DepsgraphDebug::do_time_debug() const
   return ((G.debug & G_DEBUG_DEPSGRAPH_TIME) != 0);
 }
 
+bool DepsgraphDebug::do_trace() const
+{
+  return ((G.debug & G_DEBUG_DEPSGRAPH_TRACE) != 0);
+}
+
 void DepsgraphDebug::begin_graph_evaluation()
 {
+  if (do_trace()) {
+    trace_evaluation_start_time_ = PIL_check_seconds_timer();
+  }
+
   if (!do_time_debug()) {
     return;
   }
@@ -61,6 +104,13 @@ void DepsgraphDebug::begin_graph_evaluation()
 
 void DepsgraphDebug::end_graph_evaluation()
 {
+  /* Whole evaluation is recorded on the calling thread, so that operations which it evaluated
+   * itself are nested under it. */
+  if (do_trace() && trace_evaluation_start_time_ != 0.0) {
+    trace_operation(nullptr, trace_evaluation_start_time_, PIL_check_seconds_timer());
+  }
+  trace_evaluation_start_time_ = 0.0;
+
   if (!do_time_debug()) {
     return;
   }
@@ -72,6 +122,123 @@ void DepsgraphDebug::end_graph_evaluation()
   is_ever_evaluated = true;
 }
 
+void DepsgraphDebug::trace_operation(const OperationNode *operation_node,
+                                     const double start_time,
+                                     const double end_time)
+{
+  if (trace_events_num_.fetch_add(1, std::memory_order_relaxed) >= MAX_TRACE_EVENTS) {
+    return;
+  }
+  trace_threads_.local().events.append(
+      {operation_node, start_time - trace_start_time_, end_time - trace_start_time_});
+}
+
+static string json_escape(StringRef str)
+{
+  string result;
+  for (const char c : str) {
+    if (ELEM(c, '"', '\\')) {
+      result += '\\';
+    }
+    if (static_cast<unsigned char>(c) < ' ') {
+      /* Control characters are not allowed in JSON strings. */
+      continue;
+    }
+    result += c;
+  }
+  return result;
+}
+
+static string trace_event_format(const DepsgraphTraceEvent &event,
+                                 const StringRef graph_name,
+                                 const int thread)
+{
+  string name = "Evaluation";
+  string category = "Depsgraph";
+  string id_name = graph_name;
+  if (event.operation_node != nullptr) {
+    const ComponentNode *comp_node = event.operation_node->owner;
+    name = event.operation_node->full_identifier();
+    category = nodeTypeAsString(comp_node->type);
+    id_name = comp_node->owner->name;
+  }
+  /* Time stamps are in microseconds. */
+  std::stringstream stream;
+  stream << "{\"name\": \"" << json_escape(name) << "\", \"cat\": \"" << json_escape(category)
+         << "\", \"ph\": \"X\", \"ts\": " << static_cast<int64_t>(event.start * 1e6)
+         << ", \"dur\": " << static_cast<int64_t>((event.end - event.start) * 1e6)
+         << ", \"pid\": 0, \"tid\": " << thread << ", \"args\": {\"id\": \""
+         << json_escape(id_name) << "\"}}";
+  return stream.str();
+}
+
+void DepsgraphDebug::trace_assign_thread_numbers()
+{
+  /* Use small thread numbers that are easier to read than thread ids. */
+  int threads_num = 0;
+  trace_threads_.foreach_value([&](DepsgraphTraceThread &thread) {
+    threads_num = std::max(threads_num, thread.number + 1);
+  });
+  trace_threads_.foreach_value([&](DepsgraphTraceThread &thread) {
+    if (thread.number == -1) {
+      thread.number = threads_num++;
+    }
+  });
+}
+
+void DepsgraphDebug::trace_format_operations()
+{
+  trace_assign_thread_numbers();
+  trace_threads_.foreach_value([&](DepsgraphTraceThread &thread) {
+    for (const DepsgraphTraceEvent &event : thread.events) {
+      thread.formatted_events.append(trace_event_format(event, name, thread.number));
+    }
+    thread.events.clear_and_make_inline();
+  });
+}
+
+eDEGTraceWriteResult DepsgraphDebug::trace_write(const char *filepath)
+{
+  if (trace_events_num_ == 0) {
+    return DEG_TRACE_WRITE_EMPTY;
+  }
+
+  std::ofstream file(filepath);
+  if (!file) {
+    DEG_ERROR_PRINTF("Could not open \"%s\" for writing\n", filepath);
+    return DEG_TRACE_WRITE_CANT_OPEN_FILE;
+  }
+
+  trace_assign_thread_numbers();
+  file << "{\"traceEvents\": [\n";
+  bool is_first = true;
+  trace_threads_.foreach_value([&](const DepsgraphTraceThread &thread) {
+    for (const string &formatted : thread.formatted_events) {
+      file << (is_first ? "  " : ",\n  ") << formatted;
+      is_first = false;
+    }
+    for (const DepsgraphTraceEvent &event : thread.events) {
+      file << (is_first ? "  " : ",\n  ") << trace_event_format(event, name, thread.number);
+      is_first = false;
+    }
+  });
+  file << "\n],\n";
+  const int64_t dropped_events_num = trace_events_num_ - MAX_TRACE_EVENTS;
+  file << "\"otherData\": {\"dropped_events\": " << std::max<int64_t>(dropped_events_num, 0)
+       << "}}\n";
+
+  return DEG_TRACE_WRITE_SUCCESS;
+}
+
+void DepsgraphDebug::trace_clear()
+{
+  trace_threads_.foreach_value([](DepsgraphTraceThread &thread) {
+    thread.events.clear_and_make_inline();
+    thread.formatted_events.clear_and_make_inline();
+  });
+  trace_events_num_ = 0;
+}
+
 bool terminal_do_color()
 {
   return (G.debug & G_DEBUG_DEPSGRAPH_PRETTY) != 0;
@@ -23,6 +23,10 @@
 
 #pragma once
 
+#include <atomic>
+
+#include "BLI_enumerable_thread_specific.hh"
+
 #include "intern/debug/deg_time_average.h"
 #include "intern/depsgraph_type.h"
 
@@ -33,15 +37,48 @@
 namespace blender {
 namespace deg {
 
+struct OperationNode;
+
+/* Single evaluated operation of the evaluation trace. Times are in seconds, relative to the
+ * creation of the dependency graph. */
+struct DepsgraphTraceEvent {
+  /* Is null for the event of the whole graph evaluation. */
+  const OperationNode *operation_node;
+  double start;
+  double end;
+};
+
+/* Events recorded by a single thread, so that recording doesn't need any locking. */
+struct DepsgraphTraceThread {
+  Vector<DepsgraphTraceEvent> events;
+  /* Events of operations which are freed already, formatted as JSON objects. */
+  Vector<string> formatted_events;
+  /* Small number which is used in the trace instead of the thread id, -1 until it is known. */
+  int number = -1;
+};
+
 class DepsgraphDebug {
  public:
   DepsgraphDebug();
+  ~DepsgraphDebug();
 
   bool do_time_debug() const;
+  bool do_trace() const;
 
   void begin_graph_evaluation();
   void end_graph_evaluation();
 
+  /* Record evaluation of an operation which started and ended at the given
+   * PIL_check_seconds_timer() times. Is safe to be called from multiple threads. */
+  void trace_operation(const OperationNode *operation_node, double start_time, double end_time);
+  /* Format the recorded events, so that the operation nodes can be freed. */
+  void trace_format_operations();
+
+  /* Write all recorded trace events as Chrome trace event JSON, which can be opened in
+   * `chrome://tracing` or Perfetto. Is not to be called during evaluation. */
+  eDEGTraceWriteResult trace_write(const char *filepath);
+  void trace_clear();
+
   /* NOTE: Corresponds to G_DEBUG_DEPSGRAPH_* flags. */
   int flags;
 
@@ -56,6 +93,8 @@ class DepsgraphDebug {
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
+  /* Maximum number of recorded trace events, later events are dropped. */
+  static const constexpr int MAX_TRACE_EVENTS = 1 << 20;
 
   /* Point in time when last graph evaluation began.
    * Is initialized from begin_graph_evaluation() when time debug is enabled.
@@ -63,6 +102,17 @@ class DepsgraphDebug {
   double graph_evaluation_start_time_;
 
   AveragedTimeSampler<MAX_FPS_COUNTERS> fps_samples_;
+
+  /* Point in time which corresponds to zero time stamp of the trace events. */
+  double trace_start_time_;
+  /* Start of the current graph evaluation, when tracing is enabled. */
+  double trace_evaluation_start_time_;
+
+  threading::EnumerableThreadSpecific<DepsgraphTraceThread> trace_threads_;
+  /* Number of recorded events, including the dropped ones. */
+  std::atomic<int64_t> trace_events_num_;
+
+  void trace_assign_thread_numbers();
 };
 
 #define DEG_DEBUG_PRINTF(depsgraph, type, ...) \
@@ -167,6 +167,9 @@ void Depsgraph::clear_id_nodes()
 {
   /* Free memory used by ID nodes. */
 
+  /* Trace events refer to operation nodes which are freed now. */
+  debug.trace_format_operations();
+
   /* Stupid workaround to ensure we free IDs in a proper order. */
   clear_id_nodes_conditional(&id_nodes, [](ID_Type id_type) { return id_type == ID_SCE; });
   clear_id_nodes_conditional(&id_nodes, [](ID_Type id_type) { return id_type != ID_PA; });
@@ -108,6 +108,10 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* IDs whose own relations are to be rebuilt, without touching the rest of the graph.
+   * Only used when full update of relations is not requested. */
+  VectorSet<ID *> ids_need_relations_update;
+
   /* Indicated whether IDs in this graph are to be tagged as if they first appear visible, with
    * an optional tag for their animation (time) update. */
   bool need_visibility_update;
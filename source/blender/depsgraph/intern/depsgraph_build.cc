@@ -39,6 +39,7 @@
 #include "DNA_simulation_types.h"
 
 #include "BKE_collection.h"
+#include "BKE_global.h"
 #include "BKE_main.h"
 #include "BKE_scene.h"
 
@@ -50,6 +51,7 @@
 #include "builder/pipeline_all_objects.h"
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_incremental.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -305,11 +307,54 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
 void DEG_graph_relations_update(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = (deg::Depsgraph *)graph;
-  if (!deg_graph->need_update) {
+  if (deg_graph->need_update) {
+    DEG_graph_build_from_view_layer(graph);
+    return;
+  }
+  if (deg_graph->ids_need_relations_update.is_empty()) {
     /* Graph is up to date, nothing to do. */
     return;
   }
-  DEG_graph_build_from_view_layer(graph);
+  /* Copy the IDs, since the set is cleared by the builder. */
+  blender::Vector<ID *> ids(deg_graph->ids_need_relations_update.as_span());
+  deg::IncrementalBuilderPipeline builder(graph, ids);
+  if (!builder.try_build()) {
+    DEG_graph_tag_relations_update(graph);
+    DEG_graph_build_from_view_layer(graph);
+    return;
+  }
+  if (G.debug & G_DEBUG_DEPSGRAPH_BUILD) {
+    /* Compare against relations built from scratch. */
+    Depsgraph *temp_graph = DEG_graph_new(
+        deg_graph->bmain, deg_graph->scene, deg_graph->view_layer, deg_graph->mode);
+    DEG_graph_build_from_view_layer(temp_graph);
+    if (!DEG_debug_compare_ignoring_extra_ids(temp_graph, graph)) {
+      fprintf(stderr, "ERROR! Incremental relations update differs from full rebuild!\n");
+    }
+    DEG_graph_free(temp_graph);
+  }
+}
+
+void DEG_graph_id_tag_relations_update(Depsgraph *graph, ID *id)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  if (deg_graph->need_update) {
+    /* Full rebuild is already requested. */
+    return;
+  }
+  if (GS(id->name) != ID_OB || deg_graph->find_id_node(id) == nullptr) {
+    DEG_graph_tag_relations_update(graph);
+    return;
+  }
+  DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  deg_graph->ids_need_relations_update.add(id);
+}
+
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    DEG_graph_id_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph), id);
+  }
 }
 
 /* Tag all relations for update. */
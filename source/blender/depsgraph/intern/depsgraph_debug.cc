@@ -40,6 +40,7 @@
 #include "intern/depsgraph_type.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 #include "intern/node/deg_node_time.h"
 
 namespace deg = blender::deg;
@@ -68,22 +69,102 @@ const char *DEG_debug_name_get(struct Depsgraph *depsgraph)
   return deg_graph->debug.name.c_str();
 }
 
-bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2)
+eDEGTraceWriteResult DEG_debug_trace_write(Depsgraph *depsgraph, const char *filepath)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  return deg_graph->debug.trace_write(filepath);
+}
+
+void DEG_debug_trace_clear(Depsgraph *depsgraph)
+{
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(depsgraph);
+  deg_graph->debug.trace_clear();
+}
+
+static bool debug_is_ignored_node(const deg::Node *node, const deg::Depsgraph *ids_graph)
+{
+  if (ids_graph == nullptr || node->type != deg::NodeType::OPERATION) {
+    return false;
+  }
+  const deg::OperationNode *op_node = static_cast<const deg::OperationNode *>(node);
+  return ids_graph->find_id_node(op_node->owner->owner->id_orig) == nullptr;
+}
+
+/* When #ids_graph is given, operations of IDs which are not in that graph are skipped. */
+static blender::Set<std::string> debug_relation_identifiers(const deg::Depsgraph *deg_graph,
+                                                            const deg::Depsgraph *ids_graph)
+{
+  blender::Set<std::string> result;
+  for (deg::OperationNode *node : deg_graph->operations) {
+    if (debug_is_ignored_node(node, ids_graph)) {
+      continue;
+    }
+    for (deg::Relation *rel : node->inlinks) {
+      if (debug_is_ignored_node(rel->from, ids_graph)) {
+        continue;
+      }
+      const std::string from = (rel->from->type == deg::NodeType::OPERATION) ?
+                                   ((deg::OperationNode *)rel->from)->full_identifier() :
+                                   rel->from->identifier();
+      result.add(from + " -> " + node->full_identifier() + " (" + rel->name + ")");
+    }
+  }
+  return result;
+}
+
+static int64_t debug_operations_num(const deg::Depsgraph *deg_graph,
+                                    const deg::Depsgraph *ids_graph)
+{
+  int64_t operations_num = 0;
+  for (deg::OperationNode *node : deg_graph->operations) {
+    if (!debug_is_ignored_node(node, ids_graph)) {
+      operations_num++;
+    }
+  }
+  return operations_num;
+}
+
+static bool debug_compare(const struct Depsgraph *graph1,
+                          const struct Depsgraph *graph2,
+                          const bool ignore_ids_only_in_graph2)
 {
   BLI_assert(graph1 != nullptr);
   BLI_assert(graph2 != nullptr);
   const deg::Depsgraph *deg_graph1 = reinterpret_cast<const deg::Depsgraph *>(graph1);
   const deg::Depsgraph *deg_graph2 = reinterpret_cast<const deg::Depsgraph *>(graph2);
-  if (deg_graph1->operations.size() != deg_graph2->operations.size()) {
+  const deg::Depsgraph *ids_graph = ignore_ids_only_in_graph2 ? deg_graph1 : nullptr;
+  if (deg_graph1->operations.size() != debug_operations_num(deg_graph2, ids_graph)) {
     return false;
   }
-  /* TODO(sergey): Currently we only do real stupid check,
-   * which is fast but which isn't 100% reliable.
-   *
-   * Would be cool to make it more robust, but it's good enough
-   * for now. Also, proper graph check is actually NP-complex
-   * problem. */
-  return true;
+  /* NOTE: Relations are compared by the identifiers of the nodes they connect, so that the check
+   * does not depend on order of nodes. Flags of relations (such as cyclic) are ignored. */
+  const blender::Set<std::string> relations1 = debug_relation_identifiers(deg_graph1, nullptr);
+  const blender::Set<std::string> relations2 = debug_relation_identifiers(deg_graph2, ids_graph);
+  bool is_equal = true;
+  for (const std::string &relation : relations1) {
+    if (!relations2.contains(relation)) {
+      fprintf(stderr, "Relation is missing from the second graph: %s\n", relation.c_str());
+      is_equal = false;
+    }
+  }
+  for (const std::string &relation : relations2) {
+    if (!relations1.contains(relation)) {
+      fprintf(stderr, "Relation is missing from the first graph: %s\n", relation.c_str());
+      is_equal = false;
+    }
+  }
+  return is_equal;
+}
+
+bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2)
+{
+  return debug_compare(graph1, graph2, false);
+}
+
+bool DEG_debug_compare_ignoring_extra_ids(const struct Depsgraph *graph1,
+                                          const struct Depsgraph *graph2)
+{
+  return debug_compare(graph1, graph2, true);
 }
 
 bool DEG_debug_graph_relations_validate(Depsgraph *graph,
@@ -237,6 +237,8 @@ void depsgraph_tag_to_component_opcode(const ID *id,
       break;
     case ID_RECALC_TAG_FOR_UNDO:
       break; /* Must be ignored by depsgraph. */
+    case ID_RECALC_TRANSFORM_ONLY:
+      break; /* Is always tagged together with #ID_RECALC_TRANSFORM. */
   }
 }
 
@@ -458,8 +460,8 @@ const char *update_source_as_string(eUpdateSource source)
 
 int deg_recalc_flags_for_legacy_zero()
 {
-  return ID_RECALC_ALL &
-         ~(ID_RECALC_PSYS_ALL | ID_RECALC_ANIMATION | ID_RECALC_SOURCE | ID_RECALC_EDITORS);
+  return ID_RECALC_ALL & ~(ID_RECALC_PSYS_ALL | ID_RECALC_ANIMATION | ID_RECALC_SOURCE |
+                           ID_RECALC_EDITORS | ID_RECALC_TRANSFORM_ONLY);
 }
 
 int deg_recalc_flags_effective(Depsgraph *graph, int flags)
@@ -665,10 +667,20 @@ void graph_id_tag_update(
   if (flag == 0) {
     deg_graph_node_tag_zero(bmain, graph, id_node, update_source);
   }
+  if (flag & ID_RECALC_TRANSFORM_ONLY) {
+    flag |= ID_RECALC_TRANSFORM;
+  }
   /* Store original flag in the ID.
    * Allows to have more granularity than a node-factory based flags. */
   if (id_node != nullptr) {
     id_node->id_cow->recalc |= flag;
+    int tagged_flag = (flag == 0) ? deg_recalc_flags_for_legacy_zero() : flag;
+    /* Only a transform tag which doesn't come with #ID_RECALC_TRANSFORM_ONLY needs a full
+     * copy-on-write update. */
+    if (tagged_flag & ID_RECALC_TRANSFORM_ONLY) {
+      tagged_flag &= ~ID_RECALC_TRANSFORM;
+    }
+    id_node->tagged_recalc_flags |= tagged_flag;
   }
   /* When ID is tagged for update based on an user edits store the recalc flags in the original ID.
    * This way IDs in the undo steps will have this flag preserved, making it possible to restore
@@ -754,6 +766,8 @@ const char *DEG_update_tag_as_string(IDRecalcFlag flag)
       return "ALL";
     case ID_RECALC_TAG_FOR_UNDO:
       return "TAG_FOR_UNDO";
+    case ID_RECALC_TRANSFORM_ONLY:
+      return "TRANSFORM_ONLY";
   }
   return nullptr;
 }
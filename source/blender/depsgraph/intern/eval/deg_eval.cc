@@ -29,7 +29,9 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_heap_simple.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -37,6 +39,7 @@
 #include "DNA_node_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "DEG_depsgraph.h"
 #include "DEG_depsgraph_query.h"
@@ -62,6 +65,7 @@ namespace {
 struct DepsgraphEvalState;
 
 void deg_task_run_func(TaskPool *pool, void *taskdata);
+void deg_task_run_by_priority_func(TaskPool *pool, void *taskdata);
 
 template<typename ScheduleFunction, typename... ScheduleFunctionArgs>
 void schedule_children(DepsgraphEvalState *state,
@@ -74,6 +78,8 @@ void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), Tas
   BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
 }
 
+void schedule_node_by_priority(OperationNode *node, const int thread_id, TaskPool *pool);
+
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
   /* Stage 1: Only  Copy-on-Write operations are to be evaluated, prior to anything else.
@@ -94,8 +100,16 @@ enum class EvaluationStage {
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Record start and end of every evaluated operation into the trace of the graph. */
+  bool do_trace;
   EvaluationStage stage;
   bool need_single_thread_pass;
+  /* Evaluate operations which are ready in the order of their critical path time, instead of the
+   * order in which they became ready. */
+  bool use_critical_path;
+  /* Operations which are ready to be evaluated, ordered by their critical path time. */
+  HeapSimple *ready_queue;
+  SpinLock ready_queue_lock;
 };
 
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
@@ -105,10 +119,19 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_stats || state->do_trace || state->use_critical_path) {
     const double start_time = PIL_check_seconds_timer();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    const double end_time = PIL_check_seconds_timer();
+    if (state->do_trace) {
+      state->graph->debug.trace_operation(operation_node, start_time, end_time);
+    }
+    if (state->do_stats) {
+      operation_node->stats.current_time += end_time - start_time;
+    }
+    if (state->use_critical_path) {
+      operation_node->stats.accumulate_average_time(end_time - start_time);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -128,6 +151,23 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   schedule_children(state, operation_node, schedule_node_to_pool, pool);
 }
 
+void deg_task_run_by_priority_func(TaskPool *pool, void *UNUSED(taskdata))
+{
+  void *userdata_v = BLI_task_pool_user_data(pool);
+  DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
+
+  /* Every task evaluates the most important operation which is ready at the time the task runs,
+   * which is not necessarily the operation which caused the task to be pushed. */
+  BLI_spin_lock(&state->ready_queue_lock);
+  OperationNode *operation_node = reinterpret_cast<OperationNode *>(
+      BLI_heapsimple_pop_min(state->ready_queue));
+  BLI_spin_unlock(&state->ready_queue_lock);
+
+  evaluate_node(state, operation_node);
+
+  schedule_children(state, operation_node, schedule_node_by_priority, pool);
+}
+
 bool check_operation_node_visible(OperationNode *op_node)
 {
   const ComponentNode *comp_node = op_node->owner;
@@ -171,22 +211,92 @@ void calculate_pending_parents_for_node(OperationNode *node)
   }
 }
 
-void calculate_pending_parents(Depsgraph *graph)
+bool need_evaluate_operation(const OperationNode *node)
 {
-  for (OperationNode *node : graph->operations) {
-    calculate_pending_parents_for_node(node);
+  return check_operation_node_visible(const_cast<OperationNode *>(node)) &&
+         (node->flag & DEPSOP_FLAG_NEEDS_UPDATE) != 0;
+}
+
+/* Time used for operations which were not evaluated since the graph was built. Using the same
+ * cost for all of them makes the critical path the longest chain of operations. */
+constexpr double default_operation_time = 1e-5;
+
+/* Marks operations in #OperationNode.critical_path_time which are not handled yet. */
+constexpr float critical_path_time_unknown = -1.0f;
+constexpr float critical_path_time_visiting = -2.0f;
+
+float operation_critical_path_time(const OperationNode *node)
+{
+  float max_child_time = 0.0f;
+  for (const Relation *rel : node->outlinks) {
+    const OperationNode *child = (const OperationNode *)rel->to;
+    if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && need_evaluate_operation(child)) {
+      /* Children which are still being visited only happen with unresolved cycles. */
+      max_child_time = max(max_child_time, child->critical_path_time);
+    }
+  }
+  if (node->is_noop()) {
+    return max_child_time;
+  }
+  const double time = (node->stats.average_time > 0.0) ? node->stats.average_time :
+                                                          default_operation_time;
+  return (float)time + max_child_time;
+}
+
+/* Calculate for every operation which is to be evaluated the estimated time needed to evaluate
+ * it and all the operations which depend on it, so that the longest chains can be started first.
+ * Only the tagged operations are visited, their times are marked as unknown beforehand. Times of
+ * other operations are left from earlier evaluations and are ignored. */
+void calculate_critical_path_times(Span<OperationNode *> tagged_operations)
+{
+  Vector<OperationNode *> stack;
+  for (OperationNode *root : tagged_operations) {
+    if (root->critical_path_time != critical_path_time_unknown) {
+      continue;
+    }
+    stack.append(root);
+    while (!stack.is_empty()) {
+      OperationNode *node = stack.last();
+      if (node->critical_path_time >= 0.0f) {
+        stack.remove_last();
+        continue;
+      }
+      if (node->critical_path_time == critical_path_time_visiting) {
+        /* All children are handled now. */
+        stack.remove_last();
+        node->critical_path_time = operation_critical_path_time(node);
+        continue;
+      }
+      node->critical_path_time = critical_path_time_visiting;
+      for (Relation *rel : node->outlinks) {
+        OperationNode *child = (OperationNode *)rel->to;
+        if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 &&
+            child->critical_path_time == critical_path_time_unknown) {
+          stack.append(child);
+        }
+      }
+    }
   }
 }
 
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   const bool do_stats = state->do_stats;
-  calculate_pending_parents(graph);
+  const bool use_critical_path = state->use_critical_path;
+  Vector<OperationNode *> tagged_operations;
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
+    calculate_pending_parents_for_node(node);
     if (do_stats) {
       node->stats.reset_current();
     }
+    if (use_critical_path && need_evaluate_operation(node)) {
+      node->critical_path_time = critical_path_time_unknown;
+      tagged_operations.append(node);
+    }
+  }
+  if (use_critical_path) {
+    calculate_critical_path_times(tagged_operations);
   }
 }
 
@@ -307,6 +417,15 @@ void schedule_children(DepsgraphEvalState *state,
   }
 }
 
+void schedule_node_by_priority(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
+{
+  DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_user_data(pool);
+  BLI_spin_lock(&state->ready_queue_lock);
+  BLI_heapsimple_insert(state->ready_queue, -node->critical_path_time, node);
+  BLI_spin_unlock(&state->ready_queue_lock);
+  BLI_task_pool_push(pool, deg_task_run_by_priority_func, nullptr, false, nullptr);
+}
+
 void schedule_node_to_queue(OperationNode *node,
                             const int /*thread_id*/,
                             GSQueue *evaluation_queue)
@@ -381,7 +500,11 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = graph->debug.do_trace();
   state.need_single_thread_pass = false;
+  state.ready_queue = nullptr;
+  state.use_critical_path = U.experimental.use_depsgraph_critical_path &&
+                            (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) == 0;
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
 
@@ -396,8 +519,18 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   /* After that, process all other nodes. */
   state.stage = EvaluationStage::THREADED_EVALUATION;
   task_pool = deg_evaluate_task_pool_create(&state);
-  schedule_graph(&state, schedule_node_to_pool, task_pool);
-  BLI_task_pool_work_and_wait(task_pool);
+  if (state.use_critical_path) {
+    state.ready_queue = BLI_heapsimple_new();
+    BLI_spin_init(&state.ready_queue_lock);
+    schedule_graph(&state, schedule_node_by_priority, task_pool);
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_spin_end(&state.ready_queue_lock);
+    BLI_heapsimple_free(state.ready_queue, nullptr);
+  }
+  else {
+    schedule_graph(&state, schedule_node_to_pool, task_pool);
+    BLI_task_pool_work_and_wait(task_pool);
+  }
   BLI_task_pool_free(task_pool);
 
   if (state.need_single_thread_pass) {
@@ -97,9 +97,12 @@
 #include "intern/builder/deg_builder.h"
 #include "intern/builder/deg_builder_nodes.h"
 #include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
 #include "intern/eval/deg_eval_runtime_backup.h"
 #include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 
 namespace blender::deg {
 
@@ -1071,6 +1074,37 @@ void deg_free_copy_on_write_datablock(ID *id_cow)
   id_cow->name[0] = '\0';
 }
 
+namespace {
+
+/* Check whether the copy-on-write update was only requested by tags which can be handled without
+ * copying the whole data-block (see #ID_TYPE_PARTIAL_COW_RECALC). Updates flushed from other
+ * data-blocks, such as the object data, always need a full copy. */
+bool need_only_partial_copy_on_write_update(const IDNode *id_node)
+{
+  const int partial_recalc = ID_TYPE_PARTIAL_COW_RECALC(id_node->id_type);
+  const int tagged_recalc = id_node->tagged_recalc_flags & ~ID_RECALC_POINT_CACHE;
+  if (partial_recalc == 0 || tagged_recalc == 0 || (tagged_recalc & ~partial_recalc) != 0) {
+    return false;
+  }
+  if (!deg_copy_on_write_is_expanded(id_node->id_cow)) {
+    return false;
+  }
+  ComponentNode *cow_comp = id_node->find_component(NodeType::COPY_ON_WRITE);
+  OperationNode *cow_op = cow_comp->get_entry_operation();
+  for (const Relation *rel : cow_op->inlinks) {
+    if (rel->from->type != NodeType::OPERATION) {
+      continue;
+    }
+    const OperationNode *op_from = (const OperationNode *)rel->from;
+    if (op_from->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 void deg_evaluate_copy_on_write(struct ::Depsgraph *graph, const IDNode *id_node)
 {
   const Depsgraph *depsgraph = reinterpret_cast<const Depsgraph *>(graph);
@@ -1080,6 +1114,16 @@ void deg_evaluate_copy_on_write(struct ::Depsgraph *graph, const IDNode *id_node
      * ensures scene and view layer pointers are valid. */
     return;
   }
+  if (need_only_partial_copy_on_write_update(id_node)) {
+    DEG_COW_PRINT("Partial update of datablock %s: recalc=%d\n",
+                  id_node->id_orig->name,
+                  id_node->tagged_recalc_flags);
+    BKE_id_eval_partial_copy(id_node->id_cow,
+                             id_node->id_orig,
+                             id_node->tagged_recalc_flags &
+                                 ID_TYPE_PARTIAL_COW_RECALC(id_node->id_type));
+    return;
+  }
   deg_update_copy_on_write_datablock(depsgraph, id_node);
 }
 
@@ -405,6 +405,9 @@ void deg_graph_clear_tags(Depsgraph *graph)
   }
   /* Clear any entry tags which haven't been flushed. */
   graph->entry_tags.clear();
+  for (IDNode *id_node : graph->id_nodes) {
+    id_node->tagged_recalc_flags = 0;
+  }
 
   graph->time_source->tagged_for_update = false;
 }
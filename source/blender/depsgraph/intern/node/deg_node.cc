@@ -278,6 +278,7 @@ Node::Stats::Stats()
 void Node::Stats::reset()
 {
   current_time = 0.0;
+  average_time = 0.0;
 }
 
 void Node::Stats::reset_current()
@@ -285,6 +286,13 @@ void Node::Stats::reset_current()
   current_time = 0.0;
 }
 
+void Node::Stats::accumulate_average_time(const double time)
+{
+  /* Weight recent evaluations more, so the estimate follows changes in the scene. */
+  const double factor = 0.25;
+  average_time = (average_time == 0.0) ? time : average_time + (time - average_time) * factor;
+}
+
 /*******************************************************************************
  * Node itself.
  */
@@ -161,8 +161,13 @@ struct Node {
     /* Reset counters needed for the current graph evaluation, does not
      * touch averaging accumulators. */
     void reset_current();
+    /* Add the time of an evaluation of this node to the average time. */
+    void accumulate_average_time(double time);
     /* Time spend on this node during current graph evaluation. */
     double current_time;
+    /* Exponential moving average of the time spent on this node in the evaluations since the
+     * graph was built, used to estimate the cost of evaluating it again. */
+    double average_time;
   };
   /* Relationships between nodes
    * The reason why all depsgraph nodes are descended from this type (apart
@@ -204,13 +204,13 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
 
 void ComponentNode::set_entry_operation(OperationNode *op_node)
 {
-  BLI_assert(entry_operation == nullptr);
+  BLI_assert(ELEM(entry_operation, nullptr, op_node));
   entry_operation = op_node;
 }
 
 void ComponentNode::set_exit_operation(OperationNode *op_node)
 {
-  BLI_assert(exit_operation == nullptr);
+  BLI_assert(ELEM(exit_operation, nullptr, op_node));
   exit_operation = op_node;
 }
 
@@ -289,6 +289,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Component was not touched since the previous build. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
@@ -297,6 +301,19 @@ void ComponentNode::finalize_build(Depsgraph * /*graph*/)
   operations_map = nullptr;
 }
 
+void ComponentNode::reopen_build()
+{
+  if (operations_map != nullptr) {
+    return;
+  }
+  operations_map = new Map<ComponentNode::OperationIDKey, OperationNode *>();
+  for (OperationNode *op_node : operations) {
+    OperationIDKey key(op_node->opcode, op_node->name.c_str(), op_node->name_tag);
+    operations_map->add_new(key, op_node);
+  }
+  operations.clear();
+}
+
 /* Bone Component ========================================= */
 
 /* Initialize 'bone component' node - from pointer data given */
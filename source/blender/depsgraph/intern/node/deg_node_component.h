@@ -113,6 +113,10 @@ struct ComponentNode : public Node {
 
   void finalize_build(Depsgraph *graph);
 
+  /* Reverse of finalize_build(): bring the operations back into the hash map, so that the
+   * component can be extended by builders again. Used by incremental relations update. */
+  void reopen_build();
+
   IDNode *owner;
 
   /* ** Inner nodes for this component ** */
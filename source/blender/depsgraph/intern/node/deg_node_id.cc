@@ -91,6 +91,7 @@ void IDNode::init(const ID *id, const char *UNUSED(subdata))
   has_base = false;
   is_user_modified = false;
   id_cow_recalc_backup = 0;
+  tagged_recalc_flags = 0;
 
   visible_components_mask = 0;
   previously_visible_components_mask = 0;
@@ -182,6 +183,8 @@ ComponentNode *IDNode::add_component(NodeType type, const char *name)
 
 void IDNode::tag_update(Depsgraph *graph, eUpdateSource source)
 {
+  /* Updates of all components require a full copy-on-write update. */
+  tagged_recalc_flags |= ID_RECALC_ALL;
   for (ComponentNode *comp_node : components.values()) {
     /* Relations update does explicit animation update when needed. Here we ignore animation
      * component to avoid loss of possible unkeyed changes. */
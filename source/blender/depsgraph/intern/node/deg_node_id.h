@@ -123,6 +123,10 @@ struct IDNode : public Node {
   /* Accumulate recalc flags from multiple update passes. */
   int id_cow_recalc_backup;
 
+  /* Recalc flags the ID was explicitly tagged with since its last evaluation. Used to check
+   * whether the copy-on-write update can only copy the data affected by those tags. */
+  int tagged_recalc_flags;
+
   IDComponentsMask visible_components_mask;
   IDComponentsMask previously_visible_components_mask;
 
@@ -265,6 +265,10 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Estimated time to evaluate this operation and the longest chain of operations which depend
+   * on it. Used to schedule operations on the critical path first. */
+  float critical_path_time;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
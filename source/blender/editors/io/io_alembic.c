@@ -133,6 +133,8 @@ static int wm_alembic_export_exec(bContext *C, wmOperator *op)
       .export_particles = RNA_boolean_get(op->ptr, "export_particles"),
       .export_custom_properties = RNA_boolean_get(op->ptr, "export_custom_properties"),
       .use_instancing = RNA_boolean_get(op->ptr, "use_instancing"),
+      .use_parallel_frames = RNA_boolean_get(op->ptr, "use_parallel_frames"),
+      .parallel_frames_memory = RNA_int_get(op->ptr, "parallel_frames_memory"),
       .packuv = RNA_boolean_get(op->ptr, "packuv"),
       .triangulate = RNA_boolean_get(op->ptr, "triangulate"),
       .quad_method = RNA_enum_get(op->ptr, "quad_method"),
@@ -188,6 +190,13 @@ static void ui_alembic_export_settings(uiLayout *layout, PointerRNA *imfptr)
 
   uiItemS(col);
 
+  uiItemR(col, imfptr, "use_parallel_frames", 0, NULL, ICON_NONE);
+  sub = uiLayoutColumn(col, false);
+  uiLayoutSetActive(sub, RNA_boolean_get(imfptr, "use_parallel_frames"));
+  uiItemR(sub, imfptr, "parallel_frames_memory", 0, IFACE_("Memory"), ICON_NONE);
+
+  uiItemS(col);
+
   uiItemR(col, imfptr, "flatten", 0, NULL, ICON_NONE);
   uiItemR(sub, imfptr, "use_instancing", 0, IFACE_("Use Instancing"), ICON_NONE);
   uiItemR(sub, imfptr, "export_custom_properties", 0, IFACE_("Custom Properties"), ICON_NONE);
@@ -459,6 +468,25 @@ void WM_OT_alembic_export(wmOperatorType *ot)
                   "Export Custom Properties",
                   "Export custom properties to Alembic .userProperties");
 
+  RNA_def_boolean(ot->srna,
+                  "use_parallel_frames",
+                  false,
+                  "Parallel Frames",
+                  "Evaluate several frames at the same time on copies of the scene, which is "
+                  "faster for rigs and modifiers but uses more memory. Frame change handlers are "
+                  "not run for these frames, and scenes with simulations are still evaluated one "
+                  "frame at a time");
+
+  RNA_def_int(ot->srna,
+              "parallel_frames_memory",
+              4096,
+              0,
+              INT_MAX,
+              "Parallel Frames Memory",
+              "Memory in megabytes which may be used by the copies of the scene",
+              256,
+              65536);
+
   RNA_def_boolean(
       ot->srna,
       "as_background_job",
@@ -121,6 +121,8 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
   const bool export_materials = RNA_boolean_get(op->ptr, "export_materials");
   const bool use_instancing = RNA_boolean_get(op->ptr, "use_instancing");
   const bool evaluation_mode = RNA_enum_get(op->ptr, "evaluation_mode");
+  const bool use_parallel_frames = RNA_boolean_get(op->ptr, "use_parallel_frames");
+  const int parallel_frames_memory = RNA_int_get(op->ptr, "parallel_frames_memory");
 
   struct USDExportParams params = {
       export_animation,
@@ -132,6 +134,8 @@ static int wm_usd_export_exec(bContext *C, wmOperator *op)
       visible_objects_only,
       use_instancing,
       evaluation_mode,
+      use_parallel_frames,
+      parallel_frames_memory,
   };
 
   bool ok = USD_export(C, filename, &params, as_background_job);
@@ -155,6 +159,12 @@ static void wm_usd_export_draw(bContext *UNUSED(C), wmOperator *op)
 
   col = uiLayoutColumn(box, true);
   uiItemR(col, ptr, "export_animation", 0, NULL, ICON_NONE);
+  col = uiLayoutColumn(col, true);
+  uiLayoutSetActive(col, RNA_boolean_get(ptr, "export_animation"));
+  uiItemR(col, ptr, "use_parallel_frames", 0, NULL, ICON_NONE);
+  uiItemR(col, ptr, "parallel_frames_memory", 0, IFACE_("Memory"), ICON_NONE);
+
+  col = uiLayoutColumn(box, true);
   uiItemR(col, ptr, "export_hair", 0, NULL, ICON_NONE);
   uiItemR(col, ptr, "export_uvmaps", 0, NULL, ICON_NONE);
   uiItemR(col, ptr, "export_normals", 0, NULL, ICON_NONE);
@@ -240,6 +250,25 @@ void WM_OT_usd_export(struct wmOperatorType *ot)
                "Use Settings for",
                "Determines visibility of objects, modifier settings, and other areas where there "
                "are different settings for viewport and rendering");
+
+  RNA_def_boolean(ot->srna,
+                  "use_parallel_frames",
+                  false,
+                  "Parallel Frames",
+                  "Evaluate several frames at the same time on copies of the scene, which is "
+                  "faster for rigs and modifiers but uses more memory. Frame change handlers are "
+                  "not run for these frames, and scenes with simulations are still evaluated one "
+                  "frame at a time");
+
+  RNA_def_int(ot->srna,
+              "parallel_frames_memory",
+              4096,
+              0,
+              INT_MAX,
+              "Parallel Frames Memory",
+              "Memory in megabytes which may be used by the copies of the scene",
+              256,
+              65536);
 }
 
 #endif /* WITH_USD */
@@ -1492,7 +1492,12 @@ static int constraint_delete_exec(bContext *C, wmOperator *op)
     ED_object_constraint_update(bmain, ob);
 
     /* relations */
-    DEG_relations_tag_update(CTX_data_main(C));
+    if (lb == &ob->constraints) {
+      DEG_id_relations_tag_update(bmain, &ob->id);
+    }
+    else {
+      DEG_relations_tag_update(bmain);
+    }
 
     /* notifiers */
     WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_REMOVED, ob);
@@ -2136,7 +2141,12 @@ static int constraint_add_exec(
   }
 
   /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
+  if (pchan == NULL) {
+    DEG_id_relations_tag_update(bmain, &ob->id);
+  }
+  else {
+    DEG_relations_tag_update(bmain);
+  }
 
   if ((ob->type == OB_ARMATURE) && (pchan)) {
     BKE_pose_tag_recalc(bmain, ob->pose); /* sort pose channels */
@@ -336,6 +336,28 @@ class GVArray_For_SingleValue : public GVArray_For_SingleValueRef {
   ~GVArray_For_SingleValue();
 };
 
+/* Generic virtual array that accesses a contiguous range of another virtual array, where the
+ * first index of the range becomes index zero. */
+class GVArray_For_SlicedGVArray : public GVArray {
+ protected:
+  const GVArray &varray_;
+  int64_t offset_;
+
+ public:
+  GVArray_For_SlicedGVArray(const GVArray &varray, const IndexRange slice)
+      : GVArray(varray.type(), slice.size()), varray_(varray), offset_(slice.start())
+  {
+    BLI_assert(slice.one_after_last() <= varray.size());
+  }
+
+ protected:
+  void get_impl(const int64_t index, void *r_value) const override;
+  void get_to_uninitialized_impl(const int64_t index, void *r_value) const override;
+
+  bool is_single_impl() const override;
+  void get_internal_single_impl(void *r_value) const override;
+};
+
 /* Used to convert a typed virtual array into a generic one. */
 template<typename T> class GVArray_For_VArray : public GVArray {
  protected:
@@ -911,4 +933,37 @@ template<typename T> class GVMutableArray_Typed {
   }
 };
 
+/**
+ * Utility class to create the "best" sliced virtual array for a generic virtual array. Spans are
+ * sliced directly, so that functions using the sliced virtual array can still access the
+ * elements without an indirection.
+ *
+ * This is not a virtual array itself, but is used to get a virtual array.
+ */
+class GVArray_Slice {
+ private:
+  const GVArray *varray_;
+  /* Of these optional virtual arrays, at most one is constructed at any time. */
+  std::optional<GVArray_For_GSpan> varray_span_;
+  std::optional<GVArray_For_SlicedGVArray> varray_any_;
+
+ public:
+  GVArray_Slice(const GVArray &varray, const IndexRange slice);
+
+  const GVArray &operator*() const
+  {
+    return *varray_;
+  }
+
+  const GVArray *operator->() const
+  {
+    return varray_;
+  }
+
+  operator const GVArray &() const
+  {
+    return *varray_;
+  }
+};
+
 }  // namespace blender::fn
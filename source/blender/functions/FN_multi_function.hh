@@ -42,6 +42,11 @@
  * 1. Create a new subclass of MultiFunction.
  * 2. Implement a constructor that initialized the signature of the function.
  * 3. Override the `call` function.
+ * 4. Optionally override `get_execution_hints`, e.g. when the function is not thread-safe.
+ *
+ * Callers that evaluate a function for many elements should use `call_auto`, which splits the
+ * mask into slices that are processed in parallel. For now only `MFNetworkEvaluator` does that,
+ * geometry nodes evaluate multi-functions for a single element at a time.
  */
 
 #include "BLI_hash.hh"
@@ -62,6 +67,12 @@ class MultiFunction {
 
   virtual void call(IndexMask mask, MFParams params, MFContext context) const = 0;
 
+  /**
+   * Same as `call`, but the mask is split into slices that are evaluated in parallel when the
+   * function supports it.
+   */
+  void call_auto(IndexMask mask, MFParams params, MFContext context) const;
+
   virtual uint64_t hash() const
   {
     return get_default_hash(this);
@@ -108,6 +119,31 @@ class MultiFunction {
     return *signature_ref_;
   }
 
+  /**
+   * Information about how the multi-function behaves that helps a caller to execute it
+   * efficiently.
+   */
+  struct ExecutionHints {
+    /**
+     * Suggested minimum number of elements that a single thread should process. Smaller slices
+     * are not worth the overhead of scheduling a task.
+     */
+    int64_t min_grain_size = 10000;
+    /**
+     * Indicates that the function allocates arrays as large as the highest index in the mask.
+     * When evaluated in slices, the indices are offset to start at zero to reduce the memory
+     * usage of each slice.
+     */
+    bool allocates_array = false;
+    /**
+     * Functions that access shared state without synchronization must not be called from
+     * multiple threads at the same time.
+     */
+    bool is_thread_safe = true;
+  };
+
+  ExecutionHints execution_hints() const;
+
  protected:
   /* Make the function use the given signature. This should be called once in the constructor of
    * child classes. No copy of the signature is made, so the caller has to make sure that the
@@ -119,6 +155,8 @@ class MultiFunction {
     BLI_assert(signature != nullptr);
     signature_ref_ = signature;
   }
+
+  virtual ExecutionHints get_execution_hints() const;
 };
 
 inline MFParamsBuilder::MFParamsBuilder(const class MultiFunction &fn, int64_t min_array_size)
@@ -174,9 +174,12 @@ class CustomMF_SI_SI_SI_SO : public MultiFunction {
                const VArray<In2> &in2,
                const VArray<In3> &in3,
                MutableSpan<Out1> out1) {
-      mask.foreach_index([&](int i) {
-        new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i], in3[i]));
-      });
+      devirtualize_varrays(
+          in1, in2, in3, [&](const auto &in1, const auto &in2, const auto &in3) {
+            mask.foreach_index([&](int i) {
+              new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i], in3[i]));
+            });
+          });
     };
   }
 
@@ -237,9 +240,17 @@ class CustomMF_SI_SI_SI_SI_SO : public MultiFunction {
                const VArray<In3> &in3,
                const VArray<In4> &in4,
                MutableSpan<Out1> out1) {
-      mask.foreach_index([&](int i) {
-        new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i], in3[i], in4[i]));
-      });
+      devirtualize_varrays(
+          in1,
+          in2,
+          in3,
+          in4,
+          [&](const auto &in1, const auto &in2, const auto &in3, const auto &in4) {
+            mask.foreach_index([&](int i) {
+              new (static_cast<void *>(&out1[i]))
+                  Out1(element_fn(in1[i], in2[i], in3[i], in4[i]));
+            });
+          });
     };
   }
 
@@ -318,9 +329,10 @@ template<typename From, typename To> class CustomMF_Convert : public MultiFuncti
     const VArray<From> &inputs = params.readonly_single_input<From>(0);
     MutableSpan<To> outputs = params.uninitialized_single_output<To>(1);
 
-    for (int64_t i : mask) {
-      new (static_cast<void *>(&outputs[i])) To(inputs[i]);
-    }
+    devirtualize_varray(inputs, [&](const auto &inputs) {
+      mask.foreach_index(
+          [&](const int64_t i) { new (static_cast<void *>(&outputs[i])) To(inputs[i]); });
+    });
   }
 };
 
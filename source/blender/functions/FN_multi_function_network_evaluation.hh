@@ -31,6 +31,7 @@ class MFNetworkEvaluator : public MultiFunction {
   MFSignature signature_;
   Vector<const MFOutputSocket *> inputs_;
   Vector<const MFInputSocket *> outputs_;
+  ExecutionHints execution_hints_;
 
  public:
   MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs, Vector<const MFInputSocket *> outputs);
@@ -38,6 +39,9 @@ class MFNetworkEvaluator : public MultiFunction {
   void call(IndexMask mask, MFParams params, MFContext context) const override;
 
  private:
+  ExecutionHints get_execution_hints() const override;
+  ExecutionHints compute_execution_hints() const;
+
   using Storage = MFNetworkEvaluationStorage;
 
   void copy_inputs_to_storage(MFParams params, Storage &storage) const;
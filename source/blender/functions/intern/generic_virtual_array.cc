@@ -309,6 +309,49 @@ GVArray_For_SingleValue::~GVArray_For_SingleValue()
   MEM_freeN((void *)value_);
 }
 
+/* --------------------------------------------------------------------
+ * GVArray_For_SlicedGVArray.
+ */
+
+void GVArray_For_SlicedGVArray::get_impl(const int64_t index, void *r_value) const
+{
+  varray_.get(index + offset_, r_value);
+}
+
+void GVArray_For_SlicedGVArray::get_to_uninitialized_impl(const int64_t index,
+                                                          void *r_value) const
+{
+  varray_.get_to_uninitialized(index + offset_, r_value);
+}
+
+bool GVArray_For_SlicedGVArray::is_single_impl() const
+{
+  return varray_.is_single();
+}
+
+void GVArray_For_SlicedGVArray::get_internal_single_impl(void *r_value) const
+{
+  varray_.get_internal_single(r_value);
+}
+
+/* --------------------------------------------------------------------
+ * GVArray_Slice.
+ */
+
+GVArray_Slice::GVArray_Slice(const GVArray &varray, const IndexRange slice)
+{
+  if (varray.is_span()) {
+    const GSpan span = varray.get_internal_span();
+    varray_span_.emplace(span.slice(slice.start(), slice.size()));
+    varray_ = &*varray_span_;
+  }
+  else {
+    /* Single values are handled here as well, because the sliced virtual array forwards them. */
+    varray_any_.emplace(varray, slice);
+    varray_ = &*varray_any_;
+  }
+}
+
 /* --------------------------------------------------------------------
  * GVArray_GSpan.
  */
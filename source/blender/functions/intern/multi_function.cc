@@ -16,8 +16,104 @@
 
 #include "FN_multi_function.hh"
 
+#include "BLI_task.hh"
+
 namespace blender::fn {
 
+MultiFunction::ExecutionHints MultiFunction::execution_hints() const
+{
+  return this->get_execution_hints();
+}
+
+MultiFunction::ExecutionHints MultiFunction::get_execution_hints() const
+{
+  return ExecutionHints{};
+}
+
+static bool supports_threading_by_slicing_params(const MultiFunction &fn)
+{
+  for (const int param_index : fn.param_indices()) {
+    const MFParamType param_type = fn.param_type(param_index);
+    if (ELEM(param_type.category(),
+             MFParamType::VectorInput,
+             MFParamType::VectorOutput,
+             MFParamType::VectorMutable)) {
+      /* Vector arrays can't be sliced, and appending to them from multiple threads is not
+       * thread-safe. */
+      return false;
+    }
+  }
+  return true;
+}
+
+void MultiFunction::call_auto(IndexMask mask, MFParams params, MFContext context) const
+{
+  if (mask.is_empty()) {
+    return;
+  }
+  const ExecutionHints hints = this->execution_hints();
+  const int64_t grain_size = hints.min_grain_size;
+
+  if (grain_size >= mask.size() || !hints.is_thread_safe ||
+      !supports_threading_by_slicing_params(*this)) {
+    this->call(mask, params, context);
+    return;
+  }
+
+  threading::parallel_for(mask.index_range(), grain_size, [&](const IndexRange sub_range) {
+    const IndexMask sliced_mask = mask.slice(sub_range);
+    if (!hints.allocates_array || sliced_mask[0] < grain_size) {
+      /* There is no benefit in offsetting the indices, the parameters can be used directly. */
+      this->call(sliced_mask, params, context);
+      return;
+    }
+
+    const int64_t input_slice_start = sliced_mask[0];
+    const int64_t input_slice_size = sliced_mask.last() - input_slice_start + 1;
+    const IndexRange input_slice_range{input_slice_start, input_slice_size};
+
+    Vector<int64_t> offset_mask_indices;
+    const IndexMask offset_mask = mask.slice_and_offset(sub_range, offset_mask_indices);
+
+    MFParamsBuilder offset_params{*this, offset_mask.min_array_size()};
+
+    /* Slice all parameters so that the indices in the offset mask can be used with them. */
+    for (const int param_index : this->param_indices()) {
+      const MFParamType param_type = this->param_type(param_index);
+      switch (param_type.category()) {
+        case MFParamType::SingleInput: {
+          const GVArray &varray = params.readonly_single_input(param_index);
+          const GVArray_Slice &sliced_varray =
+              offset_params.resource_scope().construct<GVArray_Slice>(
+                  __func__, varray, input_slice_range);
+          offset_params.add_readonly_single_input(*sliced_varray);
+          break;
+        }
+        case MFParamType::SingleMutable: {
+          const GMutableSpan span = params.single_mutable(param_index);
+          offset_params.add_single_mutable(
+              span.slice(input_slice_range.start(), input_slice_range.size()));
+          break;
+        }
+        case MFParamType::SingleOutput: {
+          const GMutableSpan span = params.uninitialized_single_output(param_index);
+          offset_params.add_uninitialized_single_output(
+              span.slice(input_slice_range.start(), input_slice_range.size()));
+          break;
+        }
+        case MFParamType::VectorInput:
+        case MFParamType::VectorMutable:
+        case MFParamType::VectorOutput: {
+          BLI_assert_unreachable();
+          break;
+        }
+      }
+    }
+
+    this->call(offset_mask, offset_params, context);
+  });
+}
+
 class DummyMultiFunction : public MultiFunction {
  public:
   DummyMultiFunction()
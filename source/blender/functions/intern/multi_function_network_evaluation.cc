@@ -38,6 +38,7 @@
 #include "FN_multi_function_network_evaluation.hh"
 
 #include "BLI_resource_scope.hh"
+#include "BLI_set.hh"
 #include "BLI_stack.hh"
 
 namespace blender::fn {
@@ -144,6 +145,10 @@ MFNetworkEvaluator::MFNetworkEvaluator(Vector<const MFOutputSocket *> inputs,
 
   signature_ = signature.build();
   this->set_signature(&signature_);
+
+  /* The network does not change anymore, so the hints are only computed once instead of walking
+   * the network for every call. */
+  execution_hints_ = this->compute_execution_hints();
 }
 
 void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context) const
@@ -163,6 +168,41 @@ void MFNetworkEvaluator::call(IndexMask mask, MFParams params, MFContext context
   this->initialize_remaining_outputs(params, storage, outputs_to_initialize_in_the_end);
 }
 
+MultiFunction::ExecutionHints MFNetworkEvaluator::get_execution_hints() const
+{
+  return execution_hints_;
+}
+
+MultiFunction::ExecutionHints MFNetworkEvaluator::compute_execution_hints() const
+{
+  ExecutionHints hints;
+  /* The storage allocates arrays that are as large as the highest index in the mask. */
+  hints.allocates_array = true;
+
+  /* Calling the network from multiple threads calls every function in it from multiple threads. */
+  Stack<const MFNode *> nodes_to_check;
+  Set<const MFNode *> checked_nodes;
+  for (const MFInputSocket *socket : outputs_) {
+    nodes_to_check.push(&socket->origin()->node());
+  }
+  while (!nodes_to_check.is_empty()) {
+    const MFNode &node = *nodes_to_check.pop();
+    if (!checked_nodes.add(&node)) {
+      continue;
+    }
+    if (node.is_function() && !node.as_function().function().execution_hints().is_thread_safe) {
+      hints.is_thread_safe = false;
+      break;
+    }
+    for (const MFInputSocket *input : node.inputs()) {
+      if (input->origin() != nullptr) {
+        nodes_to_check.push(&input->origin()->node());
+      }
+    }
+  }
+  return hints;
+}
+
 BLI_NOINLINE void MFNetworkEvaluator::copy_inputs_to_storage(MFParams params,
                                                              Storage &storage) const
 {
@@ -370,7 +410,7 @@ BLI_NOINLINE void MFNetworkEvaluator::evaluate_function(MFContext &global_contex
       }
     }
 
-    function.call(storage.mask(), params, global_context);
+    function.call_auto(storage.mask(), params, global_context);
   }
 
   storage.finish_node(function_node);
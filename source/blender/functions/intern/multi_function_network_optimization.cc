@@ -18,6 +18,7 @@
  * \ingroup fn
  */
 
+#include <algorithm>
 /* Used to check if two multi-functions have the exact same type. */
 #include <typeinfo>
 
@@ -25,11 +26,13 @@
 #include "FN_multi_function_network_evaluation.hh"
 #include "FN_multi_function_network_optimization.hh"
 
+#include "BLI_array.hh"
 #include "BLI_disjoint_set.hh"
 #include "BLI_ghash.h"
 #include "BLI_map.hh"
 #include "BLI_multi_value_map.hh"
 #include "BLI_rand.h"
+#include "BLI_set.hh"
 #include "BLI_stack.hh"
 
 namespace blender::fn::mf_network_optimization {
@@ -498,4 +501,295 @@ void common_subnetwork_elimination(MFNetwork &network)
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Function Chain Fusion
+ * \{ */
+
+/**
+ * Evaluates a chain of multi-functions where each function, except for the last one, passes its
+ * only output to the next function. Instead of evaluating every function for all indices before
+ * the next one, the entire chain is evaluated for small chunks of indices. That way the values
+ * passed between the functions are only stored for one chunk at a time and stay in the CPU cache,
+ * instead of being written to and read from an array as large as the input.
+ */
+class FusedChainFunction : public MultiFunction {
+ private:
+  /* Chosen so that a few intermediate arrays of vectors fit into the L2 cache. */
+  static constexpr int64_t chunk_size = 1024;
+
+  struct ParamSource {
+    /* Either a parameter of the fused function or an intermediate value between two steps. */
+    bool is_intermediate;
+    int index;
+  };
+
+  struct Step {
+    const MultiFunction *fn;
+    /* Indexed by the parameter index of the function. */
+    Vector<ParamSource> sources;
+  };
+
+  MFSignature signature_;
+  Vector<Step> steps_;
+  /* The intermediate value with index i is the output of step i and the input of step i + 1. */
+  Vector<const CPPType *> intermediate_types_;
+
+ public:
+  /**
+   * The sockets in the original network that correspond to every parameter of the fused
+   * function are added to #r_param_sockets.
+   */
+  FusedChainFunction(Span<MFFunctionNode *> chain, Vector<MFSocket *> &r_param_sockets)
+  {
+    BLI_assert(chain.size() >= 2);
+
+    std::string name;
+    for (const MFFunctionNode *node : chain) {
+      if (!name.empty()) {
+        name += " -> ";
+      }
+      name += node->name();
+    }
+    MFSignatureBuilder signature{name};
+
+    for (const int step_index : chain.index_range()) {
+      MFFunctionNode &node = *chain[step_index];
+      const MultiFunction &fn = node.function();
+      const bool is_last_step = step_index == chain.size() - 1;
+      Step step{&fn, {}};
+      int input_index = 0;
+      int output_index = 0;
+
+      for (const int param_index : fn.param_indices()) {
+        const MFParamType param_type = fn.param_type(param_index);
+        const CPPType &type = param_type.data_type().single_type();
+        if (param_type.category() == MFParamType::SingleInput) {
+          MFInputSocket &socket = node.input(input_index++);
+          if (step_index > 0 && socket.origin() == &chain[step_index - 1]->output(0)) {
+            step.sources.append({true, step_index - 1});
+          }
+          else {
+            step.sources.append({false, (int)r_param_sockets.size()});
+            signature.single_input(fn.param_name(param_index), type);
+            r_param_sockets.append(&socket);
+          }
+        }
+        else {
+          BLI_assert(param_type.category() == MFParamType::SingleOutput);
+          MFOutputSocket &socket = node.output(output_index++);
+          if (is_last_step) {
+            step.sources.append({false, (int)r_param_sockets.size()});
+            signature.single_output(fn.param_name(param_index), type);
+            r_param_sockets.append(&socket);
+          }
+          else {
+            step.sources.append({true, (int)intermediate_types_.size()});
+            intermediate_types_.append(&type);
+          }
+        }
+      }
+
+      if (fn.depends_on_context()) {
+        signature.depends_on_context();
+      }
+      steps_.append(std::move(step));
+    }
+
+    signature_ = signature.build();
+    this->set_signature(&signature_);
+  }
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    for (const Step &step : steps_) {
+      const ExecutionHints step_hints = step.fn->execution_hints();
+      hints.min_grain_size = std::max(hints.min_grain_size, step_hints.min_grain_size);
+      hints.is_thread_safe &= step_hints.is_thread_safe;
+    }
+    return hints;
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext context) const override
+  {
+    /* The buffers for the intermediate values are reused for every chunk. */
+    Array<void *> buffers(intermediate_types_.size());
+    for (const int i : intermediate_types_.index_range()) {
+      const CPPType &type = *intermediate_types_[i];
+      buffers[i] = MEM_mallocN_aligned(chunk_size * type.size(), type.alignment(), __func__);
+    }
+
+    Vector<int64_t> chunk_indices;
+    int64_t mask_start = 0;
+    while (mask_start < mask.size()) {
+      /* A chunk contains the indices in the mask that are in the next range of #chunk_size
+       * indices. They are offset so that the first index in the chunk becomes zero. */
+      const int64_t offset = mask[mask_start];
+      const Span<int64_t> remaining_indices = mask.indices().drop_front(mask_start);
+      const int64_t mask_end = mask_start + (std::lower_bound(remaining_indices.begin(),
+                                                              remaining_indices.end(),
+                                                              offset + chunk_size) -
+                                             remaining_indices.begin());
+      const IndexRange slice{offset, mask[mask_end - 1] - offset + 1};
+
+      if (mask.is_range()) {
+        this->call_chunk(IndexRange(slice.size()), slice, buffers, params, context);
+      }
+      else {
+        chunk_indices.clear();
+        for (const int64_t i : IndexRange(mask_start, mask_end - mask_start)) {
+          chunk_indices.append(mask[i] - offset);
+        }
+        this->call_chunk(chunk_indices.as_span(), slice, buffers, params, context);
+      }
+      mask_start = mask_end;
+    }
+
+    for (void *buffer : buffers) {
+      MEM_freeN(buffer);
+    }
+  }
+
+ private:
+  void call_chunk(IndexMask chunk_mask,
+                  IndexRange slice,
+                  Span<void *> buffers,
+                  MFParams params,
+                  MFContext context) const
+  {
+    for (const int step_index : steps_.index_range()) {
+      const Step &step = steps_[step_index];
+      const MultiFunction &fn = *step.fn;
+      MFParamsBuilder step_params{fn, slice.size()};
+
+      for (const int param_index : fn.param_indices()) {
+        const ParamSource source = step.sources[param_index];
+        if (fn.param_type(param_index).category() == MFParamType::SingleInput) {
+          if (source.is_intermediate) {
+            const CPPType &type = *intermediate_types_[source.index];
+            step_params.add_readonly_single_input(GSpan(type, buffers[source.index], slice.size()));
+          }
+          else {
+            const GVArray &varray = params.readonly_single_input(source.index);
+            const GVArray_Slice &sliced_varray =
+                step_params.resource_scope().construct<GVArray_Slice>(__func__, varray, slice);
+            step_params.add_readonly_single_input(*sliced_varray);
+          }
+        }
+        else {
+          if (source.is_intermediate) {
+            const CPPType &type = *intermediate_types_[source.index];
+            step_params.add_uninitialized_single_output(
+                GMutableSpan(type, buffers[source.index], slice.size()));
+          }
+          else {
+            GMutableSpan span = params.uninitialized_single_output(source.index);
+            step_params.add_uninitialized_single_output(span.slice(slice.start(), slice.size()));
+          }
+        }
+      }
+
+      fn.call(chunk_mask, step_params, context);
+
+      if (step_index > 0) {
+        /* The output of the previous step has been used by this step and is not needed anymore. */
+        intermediate_types_[step_index - 1]->destruct_indices(buffers[step_index - 1], chunk_mask);
+      }
+    }
+  }
+};
+
+static bool function_node_can_be_fused(const MFFunctionNode &node)
+{
+  const MultiFunction &fn = node.function();
+  for (const int param_index : fn.param_indices()) {
+    const MFParamType::Category category = fn.param_type(param_index).category();
+    if (!ELEM(category, MFParamType::SingleInput, MFParamType::SingleOutput)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * The next node in a chain is the only user of the only output of a node. Both nodes have to
+ * work on single values only, because vector values can't be split into chunks as easily.
+ */
+static MFFunctionNode *find_next_node_in_chain(MFFunctionNode &node)
+{
+  if (node.outputs().size() != 1 || !function_node_can_be_fused(node)) {
+    return nullptr;
+  }
+  Span<MFInputSocket *> targets = node.output(0).targets();
+  if (targets.size() != 1) {
+    return nullptr;
+  }
+  MFNode &target_node = targets[0]->node();
+  if (!target_node.is_function()) {
+    return nullptr;
+  }
+  MFFunctionNode &target_function_node = target_node.as_function();
+  if (!function_node_can_be_fused(target_function_node)) {
+    return nullptr;
+  }
+  return &target_function_node;
+}
+
+static void replace_chain_with_fused_node(MFNetwork &network,
+                                          Span<MFFunctionNode *> chain,
+                                          ResourceScope &scope)
+{
+  Vector<MFSocket *> param_sockets;
+  const MultiFunction &fused_fn = scope.construct<FusedChainFunction>(
+      __func__, chain, param_sockets);
+  MFFunctionNode &fused_node = network.add_function(fused_fn);
+
+  int input_index = 0;
+  int output_index = 0;
+  for (MFSocket *socket : param_sockets) {
+    if (socket->is_input()) {
+      MFInputSocket &fused_input = fused_node.input(input_index++);
+      if (MFOutputSocket *origin = socket->as_input().origin()) {
+        network.add_link(*origin, fused_input);
+      }
+    }
+    else {
+      network.relink(socket->as_output(), fused_node.output(output_index++));
+    }
+  }
+}
+
+/**
+ * Replaces chains of function nodes with a single function that evaluates the chain in chunks.
+ * This avoids allocating and filling arrays for the values passed between the nodes.
+ */
+void function_chain_fusion(MFNetwork &network, ResourceScope &scope)
+{
+  Map<MFFunctionNode *, MFFunctionNode *> next_node_in_chain;
+  Set<MFFunctionNode *> nodes_with_previous_node;
+  for (MFFunctionNode *node : network.function_nodes()) {
+    if (MFFunctionNode *next_node = find_next_node_in_chain(*node)) {
+      next_node_in_chain.add_new(node, next_node);
+      nodes_with_previous_node.add_new(next_node);
+    }
+  }
+
+  Vector<MFNode *> nodes_to_remove;
+  for (MFFunctionNode *first_node : next_node_in_chain.keys()) {
+    if (nodes_with_previous_node.contains(first_node)) {
+      /* The node is not at the start of a chain. */
+      continue;
+    }
+    Vector<MFFunctionNode *> chain = {first_node};
+    while (MFFunctionNode *next_node = next_node_in_chain.lookup_default(chain.last(), nullptr)) {
+      chain.append(next_node);
+    }
+    replace_chain_with_fused_node(network, chain, scope);
+    nodes_to_remove.extend(chain.as_span().cast<MFNode *>());
+  }
+  network.remove(nodes_to_remove);
+}
+
+/** \} */
+
 }  // namespace blender::fn::mf_network_optimization
@@ -5,6 +5,7 @@
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_network.hh"
 #include "FN_multi_function_network_evaluation.hh"
+#include "FN_multi_function_network_optimization.hh"
 
 namespace blender::fn::tests {
 namespace {
@@ -276,5 +277,153 @@ TEST(multi_function_network, Test2)
   }
 }
 
+TEST(multi_function_network, FunctionChainFusion)
+{
+  CustomMF_SI_SO<int, int> add_10_fn("add 10", [](int value) { return value + 10; });
+  CustomMF_SI_SI_SO<int, int, int> multiply_fn("multiply", [](int a, int b) { return a * b; });
+  CustomMF_SI_SO<int, int> subtract_1_fn("subtract 1", [](int value) { return value - 1; });
+
+  MFNetwork network;
+
+  MFNode &node1 = network.add_function(add_10_fn);
+  MFNode &node2 = network.add_function(multiply_fn);
+  MFNode &node3 = network.add_function(subtract_1_fn);
+  MFOutputSocket &input_socket_1 = network.add_input("Input 1", MFDataType::ForSingle<int>());
+  MFOutputSocket &input_socket_2 = network.add_input("Input 2", MFDataType::ForSingle<int>());
+  MFInputSocket &output_socket = network.add_output("Output", MFDataType::ForSingle<int>());
+  network.add_link(input_socket_1, node1.input(0));
+  network.add_link(node1.output(0), node2.input(0));
+  network.add_link(input_socket_2, node2.input(1));
+  network.add_link(node2.output(0), node3.input(0));
+  network.add_link(node3.output(0), output_socket);
+
+  ResourceScope scope;
+  mf_network_optimization::function_chain_fusion(network, scope);
+  EXPECT_EQ(network.function_nodes().size(), 1);
+
+  MFNetworkEvaluator network_fn{{&input_socket_1, &input_socket_2}, {&output_socket}};
+
+  /* Use enough elements to evaluate the fused function in multiple chunks. */
+  const int size = 5000;
+  Array<int> values(size);
+  for (const int i : values.index_range()) {
+    values[i] = i;
+  }
+  const int factor = 3;
+  {
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_readonly_single_input(&factor);
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(IndexRange(size), params, context);
+
+    for (const int i : results.index_range()) {
+      EXPECT_EQ(results[i], (i + 10) * 3 - 1);
+    }
+  }
+  {
+    Vector<int64_t> indices;
+    for (int i = 1; i < size; i += 7) {
+      indices.append(i);
+    }
+    Array<int> results(size, -1);
+
+    MFParamsBuilder params(network_fn, size);
+    params.add_readonly_single_input(values.as_span());
+    params.add_readonly_single_input(&factor);
+    params.add_uninitialized_single_output(results.as_mutable_span());
+
+    MFContextBuilder context;
+
+    network_fn.call(indices.as_span(), params, context);
+
+    for (const int i : results.index_range()) {
+      EXPECT_EQ(results[i], (i % 7 == 1) ? (i + 10) * 3 - 1 : -1);
+    }
+  }
+}
+
+/* Adds one to every value and remembers how it was called. */
+class CountCallsFunction : public MultiFunction {
+ public:
+  mutable int calls_num = 0;
+  mutable int64_t max_mask_size = 0;
+
+  CountCallsFunction()
+  {
+    static MFSignature signature = create_signature();
+    this->set_signature(&signature);
+  }
+
+  static MFSignature create_signature()
+  {
+    MFSignatureBuilder signature{"Count Calls"};
+    signature.single_input<float>("Value");
+    signature.single_output<float>("Result");
+    return signature.build();
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext UNUSED(context)) const override
+  {
+    const VArray<float> &values = params.readonly_single_input<float>(0, "Value");
+    MutableSpan<float> results = params.uninitialized_single_output<float>(1, "Result");
+    for (const int64_t i : mask) {
+      results[i] = values[i] + 1.0f;
+    }
+    calls_num++;
+    max_mask_size = std::max(max_mask_size, mask.size());
+  }
+};
+
+TEST(multi_function_network, FunctionChainFusionAfterEvaluatorCreation)
+{
+  /* Build the network in the same order as a node that expands into multiple functions in
+   * #get_multi_function_per_node, like the math node with clamping enabled. The evaluator only
+   * references the dummy nodes, so the chain can be fused after it is created. */
+  CountCallsFunction base_fn;
+  CustomMF_SI_SO<float, float> clamp_fn{"Clamp",
+                                        [](float value) { return std::clamp(value, 0.0f, 1.0f); }};
+
+  MFNetwork network;
+  MFFunctionNode &base_node = network.add_function(base_fn);
+  MFFunctionNode &clamp_node = network.add_function(clamp_fn);
+  network.add_link(base_node.output(0), clamp_node.input(0));
+  MFOutputSocket &input_socket = network.add_input("Input", MFDataType::ForSingle<float>());
+  MFInputSocket &output_socket = network.add_output("Output", MFDataType::ForSingle<float>());
+  network.add_link(input_socket, base_node.input(0));
+  network.add_link(clamp_node.output(0), output_socket);
+
+  MFNetworkEvaluator network_fn{{&input_socket}, {&output_socket}};
+
+  ResourceScope scope;
+  mf_network_optimization::function_chain_fusion(network, scope);
+  EXPECT_EQ(network.function_nodes().size(), 1);
+
+  const int size = 5000;
+  Array<float> values(size);
+  for (const int i : values.index_range()) {
+    values[i] = (i % 3) - 1.5f;
+  }
+  Array<float> results(size, -1.0f);
+
+  MFParamsBuilder params(network_fn, size);
+  params.add_readonly_single_input(values.as_span());
+  params.add_uninitialized_single_output(results.as_mutable_span());
+  MFContextBuilder context;
+  network_fn.call(IndexRange(size), params, context);
+
+  for (const int i : results.index_range()) {
+    EXPECT_EQ(results[i], std::clamp(values[i] + 1.0f, 0.0f, 1.0f));
+  }
+  /* Without fusion, the first function would be called once for all indices. */
+  EXPECT_EQ(base_fn.calls_num, 5);
+  EXPECT_EQ(base_fn.max_mask_size, 1024);
+}
+
 }  // namespace
 }  // namespace blender::fn::tests
@@ -5,6 +5,8 @@
 #include "FN_multi_function.hh"
 #include "FN_multi_function_builder.hh"
 
+#include "BLI_timeit.hh"
+
 namespace blender::fn::tests {
 namespace {
 
@@ -305,6 +307,34 @@ TEST(multi_function, CustomMF_SI_SI_SI_SO)
   EXPECT_EQ(outputs[3], 13);
 }
 
+TEST(multi_function, CustomMF_SI_SI_SI_SI_SO)
+{
+  CustomMF_SI_SI_SI_SI_SO<int, int, int, int, int> fn{
+      "custom", [](int a, int b, int c, int d) { return a * 1000 + b * 100 + c * 10 + d; }};
+
+  Array<int> values_a = {1, 2, 3, 4};
+  const int value_b = 5;
+  Array<int> values_c = {6, 7, 8, 9};
+  const int value_d = 0;
+  Array<int> outputs(values_a.size(), -1);
+
+  MFParamsBuilder params(fn, values_a.size());
+  params.add_readonly_single_input(values_a.as_span());
+  params.add_readonly_single_input(&value_b);
+  params.add_readonly_single_input(values_c.as_span());
+  params.add_readonly_single_input(&value_d);
+  params.add_uninitialized_single_output(outputs.as_mutable_span());
+
+  MFContextBuilder context;
+
+  fn.call({0, 2, 3}, params, context);
+
+  EXPECT_EQ(outputs[0], 1560);
+  EXPECT_EQ(outputs[1], -1);
+  EXPECT_EQ(outputs[2], 3580);
+  EXPECT_EQ(outputs[3], 4590);
+}
+
 TEST(multi_function, CustomMF_SM)
 {
   CustomMF_SM<std::string> fn("AddSuffix", [](std::string &value) { value += " test"; });
@@ -412,5 +442,168 @@ TEST(multi_function, CustomMF_Convert)
   EXPECT_EQ(outputs[2], 9);
 }
 
+/* Adds the inputs, but also checks that the indices are offset to start close to zero. */
+class OffsetAddFunction : public AddFunction {
+ public:
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    hints.min_grain_size = 1000;
+    hints.allocates_array = true;
+    return hints;
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext context) const override
+  {
+    EXPECT_LT(mask[0], this->execution_hints().min_grain_size);
+    AddFunction::call(mask, params, context);
+  }
+};
+
+/* Counts how often it is called, which is not synchronized between threads. */
+class CountCallsFunction : public AddFunction {
+ public:
+  mutable int calls = 0;
+
+  ExecutionHints get_execution_hints() const override
+  {
+    ExecutionHints hints;
+    hints.min_grain_size = 1000;
+    hints.is_thread_safe = false;
+    return hints;
+  }
+
+  void call(IndexMask mask, MFParams params, MFContext context) const override
+  {
+    calls++;
+    AddFunction::call(mask, params, context);
+  }
+};
+
+TEST(multi_function, CallAutoWithOffset)
+{
+  OffsetAddFunction fn;
+
+  const int size = 100000;
+  Array<int> input1(size);
+  Array<int> input2(size);
+  for (const int i : IndexRange(size)) {
+    input1[i] = i;
+    input2[i] = 2 * i;
+  }
+  Vector<int64_t> indices;
+  for (int i = 0; i < size; i += 3) {
+    indices.append(i);
+  }
+  Array<int> output(size, -1);
+
+  MFParamsBuilder params(fn, size);
+  params.add_readonly_single_input(input1.as_span());
+  params.add_readonly_single_input(input2.as_span());
+  params.add_uninitialized_single_output(output.as_mutable_span());
+
+  MFContextBuilder context;
+  fn.call_auto(indices.as_span(), params, context);
+
+  for (const int i : IndexRange(size)) {
+    EXPECT_EQ(output[i], (i % 3 == 0) ? 3 * i : -1);
+  }
+}
+
+TEST(multi_function, CallAutoNotThreadSafe)
+{
+  CountCallsFunction fn;
+
+  const int size = 100000;
+  Array<int> input1(size, 1);
+  Array<int> input2(size, 2);
+  Array<int> output(size, -1);
+
+  MFParamsBuilder params(fn, size);
+  params.add_readonly_single_input(input1.as_span());
+  params.add_readonly_single_input(input2.as_span());
+  params.add_uninitialized_single_output(output.as_mutable_span());
+
+  MFContextBuilder context;
+  fn.call_auto(IndexRange(size), params, context);
+
+  EXPECT_EQ(fn.calls, 1);
+  for (const int i : IndexRange(size)) {
+    EXPECT_EQ(output[i], 3);
+  }
+}
+
+/**
+ * Set this to 1 to activate the benchmark. It compares a multi-function that accesses its inputs
+ * through virtual method calls with one that is devirtualized by the builder.
+ */
+#if 0
+template<typename FnT> BLI_NOINLINE void benchmark_multi_function(StringRef name, const FnT &fn)
+{
+  const int size = 10000000;
+  Array<float> values_a(size, 1.0f);
+  const float value_b = 2.0f;
+  Array<float> values_c(size, 3.0f);
+  Array<float> outputs(size);
+
+  MFParamsBuilder params(fn, size);
+  params.add_readonly_single_input(values_a.as_span());
+  params.add_readonly_single_input(&value_b);
+  params.add_readonly_single_input(values_c.as_span());
+  params.add_uninitialized_single_output(outputs.as_mutable_span());
+
+  MFContextBuilder context;
+  {
+    SCOPED_TIMER(name);
+    fn.call(IndexRange(size), params, context);
+  }
+
+  /* Print a value for simple error checking and to avoid some compiler optimizations. */
+  std::cout << "Value: " << outputs.last() << "\n";
+}
+
+TEST(multi_function, DevirtualizeBenchmark)
+{
+  using FnT = CustomMF_SI_SI_SI_SO<float, float, float, float>;
+  auto element_fn = [](float a, float b, float c) { return a * b + c; };
+  /* Pass a #std::function to avoid the constructor that devirtualizes the inputs. */
+  std::function<void(IndexMask,
+                     const VArray<float> &,
+                     const VArray<float> &,
+                     const VArray<float> &,
+                     MutableSpan<float>)>
+      virtual_function = [&](IndexMask mask,
+                             const VArray<float> &a,
+                             const VArray<float> &b,
+                             const VArray<float> &c,
+                             MutableSpan<float> r) {
+        mask.foreach_index([&](int i) { r[i] = element_fn(a[i], b[i], c[i]); });
+      };
+  FnT virtual_fn{"virtual", virtual_function};
+  FnT devirtualized_fn{"devirtualized", element_fn};
+
+  for (int i = 0; i < 3; i++) {
+    benchmark_multi_function("Virtual      ", virtual_fn);
+    benchmark_multi_function("Devirtualized", devirtualized_fn);
+  }
+}
+
+/**
+ * Timer 'Virtual      ' took 276.974 ms
+ * Value: 5
+ * Timer 'Devirtualized' took 31.3996 ms
+ * Value: 5
+ * Timer 'Virtual      ' took 190.314 ms
+ * Value: 5
+ * Timer 'Devirtualized' took 31.5211 ms
+ * Value: 5
+ * Timer 'Virtual      ' took 193.482 ms
+ * Value: 5
+ * Timer 'Devirtualized' took 32.3567 ms
+ * Value: 5
+ */
+
+#endif /* Benchmark */
+
 }  // namespace
 }  // namespace blender::fn::tests
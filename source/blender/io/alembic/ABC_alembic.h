@@ -64,6 +64,11 @@ struct AlembicExportParams {
   bool export_custom_properties;
   bool use_instancing;
 
+  /* Evaluate several frames at the same time on copies of the dependency graph, using up to
+   * `parallel_frames_memory` megabytes for the copies. */
+  bool use_parallel_frames;
+  int parallel_frames_memory;
+
   /* See MOD_TRIANGULATE_NGON_xxx and MOD_TRIANGULATE_QUAD_xxx
    * in DNA_modifier_types.h */
   int quad_method;
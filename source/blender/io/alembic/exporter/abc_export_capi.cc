@@ -36,6 +36,7 @@
 #include "BKE_global.h"
 #include "BKE_main.h"
 #include "BKE_scene.h"
+#include "BKE_scene_frames_evaluator.hh"
 
 #include "BLI_fileops.h"
 #include "BLI_path_util.h"
@@ -49,6 +50,7 @@ static CLG_LogRef LOG = {"io.alembic"};
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 struct ExportJobData {
   Main *bmain;
@@ -75,6 +77,14 @@ static void build_depsgraph(Depsgraph *depsgraph, const bool visible_objects_onl
   }
 }
 
+static int64_t parallel_frames_memory_budget(const AlembicExportParams &params)
+{
+  if (!params.use_parallel_frames) {
+    return 0;
+  }
+  return int64_t(params.parallel_frames_memory) * 1024 * 1024;
+}
+
 static void export_startjob(void *customdata,
                             /* Cannot be const, this function implements wm_jobs_start_callback.
                              * NOLINTNEXTLINE: readability-non-const-parameter. */
@@ -138,29 +148,34 @@ static void export_startjob(void *customdata,
 
     /* Writing the animated frames is not 100% of the work, but it's our best guess. */
     const float progress_per_frame = 1.0f / std::max(size_t(1), abc_archive->total_frame_count());
-    ABCArchive::Frames::const_iterator frame_it = abc_archive->frames_begin();
-    const ABCArchive::Frames::const_iterator frames_end = abc_archive->frames_end();
+    const std::vector<double> frames(abc_archive->frames_begin(), abc_archive->frames_end());
 
-    for (; frame_it != frames_end; frame_it++) {
-      double frame = *frame_it;
+    const bool visible_objects_only = data->params.visible_objects_only;
+    bke::SceneFramesEvaluator frames_evaluator(
+        data->depsgraph,
+        [visible_objects_only](Depsgraph *depsgraph) {
+          build_depsgraph(depsgraph, visible_objects_only);
+        },
+        parallel_frames_memory_budget(data->params));
 
+    frames_evaluator.foreach_frame(frames, [&](Depsgraph *depsgraph, const double frame) {
       if (G.is_break || (stop != nullptr && *stop)) {
-        break;
+        return false;
       }
 
-      /* Update the scene for the next frame to render. */
-      scene->r.cfra = static_cast<int>(frame);
-      scene->r.subframe = frame - scene->r.cfra;
-      BKE_scene_graph_update_for_newframe(data->depsgraph);
-
       CLOG_INFO(&LOG, 2, "Exporting frame %.2f", frame);
       ExportSubset export_subset = abc_archive->export_subset_for_frame(frame);
+      iter.set_depsgraph(depsgraph);
       iter.set_export_subset(export_subset);
       iter.iterate_and_write();
 
       *progress += progress_per_frame;
       *do_update = true;
-    }
+      return true;
+    });
+
+    /* Copies of the dependency graph are freed together with the evaluator. */
+    iter.set_depsgraph(data->depsgraph);
   }
   else {
     /* If we're not animating, a single iteration over all objects is enough. */
@@ -37,7 +37,6 @@ class ABCAbstractWriter;
 class ABCHierarchyIterator;
 
 struct ABCWriterConstructorArgs {
-  Depsgraph *depsgraph;
   ABCArchive *abc_archive;
   Alembic::Abc::OObject abc_parent;
   std::string abc_name;
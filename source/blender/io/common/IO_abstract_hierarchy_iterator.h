@@ -245,6 +245,11 @@ class AbstractHierarchyIterator {
    * previous iteration. */
   void set_export_subset(ExportSubset export_subset_);
 
+  /* Switch to another dependency graph of the same view layer, for example one that is evaluated
+   * at a different frame. Existing writers use it from the next iteration on. */
+  void set_depsgraph(Depsgraph *depsgraph);
+  Depsgraph *depsgraph() const;
+
   /* Convert the given name to something that is valid for the exported file format.
    * This base implementation is a no-op; override in a concrete subclass. */
   virtual std::string make_valid_name(const std::string &name) const;
@@ -0,0 +1,212 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+#include "IO_abstract_hierarchy_iterator.h"
+
+#include "tests/blendfile_loading_base_test.h"
+
+#include "BKE_customdata.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_modifier.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+#include "BKE_scene_frames_evaluator.hh"
+#include "BLI_listbase.h"
+#include "BLI_set.hh"
+#include "BLI_threads.h"
+#include "BLI_vector.hh"
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::io {
+
+namespace {
+
+class EmptyWriter : public AbstractHierarchyWriter {
+ public:
+  void write(HierarchyContext & /*context*/) override
+  {
+  }
+};
+
+/* Records the number of faces of the exported mesh for every frame. */
+class PolysNumWriter : public AbstractHierarchyWriter {
+ public:
+  Vector<int> &polys_num;
+
+  explicit PolysNumWriter(Vector<int> &polys_num) : polys_num(polys_num)
+  {
+  }
+
+  void write(HierarchyContext &context) override
+  {
+    const Mesh *mesh = BKE_object_get_evaluated_mesh(context.object);
+    polys_num.append(mesh->totpoly);
+  }
+};
+
+class PolysNumHierarchyIterator : public AbstractHierarchyIterator {
+ public:
+  Vector<int> polys_num;
+
+  explicit PolysNumHierarchyIterator(Depsgraph *depsgraph) : AbstractHierarchyIterator(depsgraph)
+  {
+  }
+  ~PolysNumHierarchyIterator() override
+  {
+    release_writers();
+  }
+
+ protected:
+  AbstractHierarchyWriter *create_transform_writer(const HierarchyContext * /*context*/) override
+  {
+    return new EmptyWriter();
+  }
+  AbstractHierarchyWriter *create_data_writer(const HierarchyContext *context) override
+  {
+    if (context->object->type != OB_MESH) {
+      return nullptr;
+    }
+    return new PolysNumWriter(polys_num);
+  }
+  AbstractHierarchyWriter *create_hair_writer(const HierarchyContext * /*context*/) override
+  {
+    return nullptr;
+  }
+  AbstractHierarchyWriter *create_particle_writer(const HierarchyContext * /*context*/) override
+  {
+    return nullptr;
+  }
+
+  void release_writer(AbstractHierarchyWriter *writer) override
+  {
+    delete writer;
+  }
+};
+
+}  // namespace
+
+class SceneFramesExportTest : public BlendfileLoadingBaseTest {
+ protected:
+  static constexpr int polys_num = 10;
+
+  Main *bmain;
+  Vector<double> frames;
+
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+
+    bmain = BKE_main_new();
+    Scene *scene = BKE_scene_add(bmain, "Scene");
+    ViewLayer *view_layer = static_cast<ViewLayer *>(scene->view_layers.first);
+    Object *object = BKE_object_add(bmain, view_layer, OB_MESH, "Mesh");
+    mesh_create(static_cast<Mesh *>(object->data), object);
+
+    /* The Build modifier adds one face every frame. */
+    BuildModifierData *bmd = reinterpret_cast<BuildModifierData *>(
+        BKE_modifier_new(eModifierType_Build));
+    bmd->start = 1.0f;
+    bmd->length = float(polys_num);
+    BLI_addtail(&object->modifiers, bmd);
+
+    for (int frame = 1; frame <= polys_num + 1; frame++) {
+      frames.append(frame);
+    }
+
+    depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+    DEG_graph_build_from_view_layer(depsgraph);
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_main_free(bmain);
+  }
+
+  /* Separate quads, so that every face the Build modifier adds is visible in the face count. */
+  static void mesh_create(Mesh *mesh, Object *object)
+  {
+    Mesh *mesh_src = BKE_mesh_new_nomain(polys_num * 4, 0, 0, polys_num * 4, polys_num);
+    for (int i = 0; i < polys_num; i++) {
+      for (int corner = 0; corner < 4; corner++) {
+        const int index = i * 4 + corner;
+        mesh_src->mvert[index].co[0] = float(i) + float(corner == 1 || corner == 2);
+        mesh_src->mvert[index].co[1] = float(corner >= 2);
+        mesh_src->mloop[index].v = index;
+      }
+      mesh_src->mpoly[i].loopstart = i * 4;
+      mesh_src->mpoly[i].totloop = 4;
+    }
+    BKE_mesh_calc_edges(mesh_src, false, false);
+    BKE_mesh_nomain_to_mesh(mesh_src, mesh, object, &CD_MASK_MESH, true);
+  }
+
+  /* Export all frames and return the face count of the mesh at each of them. Also returns the
+   * number of dependency graphs the frames were evaluated on. */
+  Vector<int> export_polys_num(const int64_t memory_budget, int64_t *r_depsgraphs_num)
+  {
+    PolysNumHierarchyIterator iterator(depsgraph);
+    iterator.set_export_subset({false, true});
+
+    Set<Depsgraph *> used_depsgraphs;
+    bke::SceneFramesEvaluator frames_evaluator(
+        depsgraph,
+        [](Depsgraph *copy) { DEG_graph_build_from_view_layer(copy); },
+        memory_budget);
+    frames_evaluator.foreach_frame(frames, [&](Depsgraph *frame_depsgraph, double /*frame*/) {
+      used_depsgraphs.add(frame_depsgraph);
+      iterator.set_depsgraph(frame_depsgraph);
+      iterator.iterate_and_write();
+      return true;
+    });
+    iterator.set_depsgraph(depsgraph);
+
+    *r_depsgraphs_num = used_depsgraphs.size();
+    return iterator.polys_num;
+  }
+};
+
+TEST_F(SceneFramesExportTest, BuildModifierParallelMatchesSerial)
+{
+  int64_t serial_depsgraphs_num;
+  const Vector<int> serial_polys_num = export_polys_num(0, &serial_depsgraphs_num);
+  EXPECT_EQ(serial_depsgraphs_num, 1);
+  ASSERT_EQ(serial_polys_num.size(), frames.size());
+  EXPECT_EQ(serial_polys_num.first(), 0);
+  EXPECT_EQ(serial_polys_num.last(), polys_num);
+
+  /* Copies of the dependency graph have to be evaluated at their own frame, not at the frame of
+   * the original scene. */
+  int64_t parallel_depsgraphs_num;
+  const Vector<int> parallel_polys_num = export_polys_num(int64_t(1) << 30,
+                                                          &parallel_depsgraphs_num);
+  EXPECT_EQ(parallel_polys_num, serial_polys_num);
+  if (BLI_system_thread_count() > 1) {
+    EXPECT_GT(parallel_depsgraphs_num, 1);
+  }
+}
+
+}  // namespace blender::io
@@ -38,6 +38,7 @@
 #include "BKE_context.h"
 #include "BKE_global.h"
 #include "BKE_scene.h"
+#include "BKE_scene_frames_evaluator.hh"
 
 #include "BLI_fileops.h"
 #include "BLI_path_util.h"
@@ -74,6 +75,25 @@ static void ensure_usd_plugin_path_registered()
   pxr::PlugRegistry::GetInstance().RegisterPlugins(blender_usd_datafiles + "/");
 }
 
+/* Construct the depsgraph for exporting. */
+static void build_depsgraph(Depsgraph *depsgraph, const bool visible_objects_only)
+{
+  if (visible_objects_only) {
+    DEG_graph_build_from_view_layer(depsgraph);
+  }
+  else {
+    DEG_graph_build_for_all_objects(depsgraph);
+  }
+}
+
+static int64_t parallel_frames_memory_budget(const USDExportParams &params)
+{
+  if (!params.use_parallel_frames) {
+    return 0;
+  }
+  return int64_t(params.parallel_frames_memory) * 1024 * 1024;
+}
+
 static void export_startjob(void *customdata,
                             /* Cannot be const, this function implements wm_jobs_start_callback.
                              * NOLINTNEXTLINE: readability-non-const-parameter. */
@@ -88,14 +108,8 @@ static void export_startjob(void *customdata,
   WM_set_locked_interface(data->wm, true);
   G.is_break = false;
 
-  /* Construct the depsgraph for exporting. */
   Scene *scene = DEG_get_input_scene(data->depsgraph);
-  if (data->params.visible_objects_only) {
-    DEG_graph_build_from_view_layer(data->depsgraph);
-  }
-  else {
-    DEG_graph_build_for_all_objects(data->depsgraph);
-  }
+  build_depsgraph(data->depsgraph, data->params.visible_objects_only);
   BKE_scene_graph_update_tagged(data->depsgraph, data->bmain);
 
   *progress = 0.0f;
@@ -133,22 +147,35 @@ static void export_startjob(void *customdata,
     /* Writing the animated frames is not 100% of the work, but it's our best guess. */
     float progress_per_frame = 1.0f / std::max(1, (scene->r.efra - scene->r.sfra + 1));
 
-    for (float frame = scene->r.sfra; frame <= scene->r.efra; frame++) {
+    Vector<double> frames;
+    for (int frame = scene->r.sfra; frame <= scene->r.efra; frame++) {
+      frames.append(frame);
+    }
+
+    const bool visible_objects_only = data->params.visible_objects_only;
+    bke::SceneFramesEvaluator frames_evaluator(
+        data->depsgraph,
+        [visible_objects_only](Depsgraph *depsgraph) {
+          build_depsgraph(depsgraph, visible_objects_only);
+        },
+        parallel_frames_memory_budget(data->params));
+
+    frames_evaluator.foreach_frame(frames, [&](Depsgraph *depsgraph, const double frame) {
       if (G.is_break || (stop != nullptr && *stop)) {
-        break;
+        return false;
       }
 
-      /* Update the scene for the next frame to render. */
-      scene->r.cfra = static_cast<int>(frame);
-      scene->r.subframe = frame - scene->r.cfra;
-      BKE_scene_graph_update_for_newframe(data->depsgraph);
-
+      iter.set_depsgraph(depsgraph);
       iter.set_export_frame(frame);
       iter.iterate_and_write();
 
       *progress += progress_per_frame;
       *do_update = true;
-    }
+      return true;
+    });
+
+    /* Copies of the dependency graph are freed together with the evaluator. */
+    iter.set_depsgraph(data->depsgraph);
   }
   else {
     /* If we're not animating, a single iteration over all objects is enough. */
@@ -23,14 +23,11 @@
 #include <pxr/usd/sdf/path.h>
 #include <pxr/usd/usd/common.h>
 
-struct Depsgraph;
-
 namespace blender::io::usd {
 
 class USDHierarchyIterator;
 
 struct USDExporterContext {
-  Depsgraph *depsgraph;
   const pxr::UsdStageRefPtr stage;
   const pxr::SdfPath usd_path;
   const USDHierarchyIterator *hierarchy_iterator;
@@ -73,7 +73,7 @@ void USDCameraWriter::do_write(HierarchyContext &context)
                                                              usd_export_context_.usd_path);
 
   Camera *camera = static_cast<Camera *>(context.object->data);
-  Scene *scene = DEG_get_evaluated_scene(usd_export_context_.depsgraph);
+  Scene *scene = DEG_get_evaluated_scene(usd_export_context_.hierarchy_iterator->depsgraph());
 
   usd_camera.CreateProjectionAttr().Set(pxr::UsdGeomTokens->perspective);
 
@@ -42,7 +42,7 @@ USDMetaballWriter::USDMetaballWriter(const USDExporterContext &ctx) : USDGeneric
 
 bool USDMetaballWriter::is_supported(const HierarchyContext *context) const
 {
-  Scene *scene = DEG_get_input_scene(usd_export_context_.depsgraph);
+  Scene *scene = DEG_get_input_scene(usd_export_context_.hierarchy_iterator->depsgraph());
   return is_basis_ball(scene, context->object) && USDGenericMeshWriter::is_supported(context);
 }
 
@@ -62,7 +62,8 @@ Mesh *USDMetaballWriter::get_export_mesh(Object *object_eval, bool &r_needsfree)
     return mesh_eval;
   }
   r_needsfree = true;
-  return BKE_mesh_new_from_object(usd_export_context_.depsgraph, object_eval, false, false);
+  return BKE_mesh_new_from_object(
+      usd_export_context_.hierarchy_iterator->depsgraph(), object_eval, false, false);
 }
 
 void USDMetaballWriter::free_export_mesh(Mesh *mesh)
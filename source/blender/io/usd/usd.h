@@ -37,6 +37,10 @@ struct USDExportParams {
   bool visible_objects_only;
   bool use_instancing;
   enum eEvaluationMode evaluation_mode;
+  /* Evaluate several frames at the same time on copies of the dependency graph, using up to
+   * `parallel_frames_memory` megabytes for the copies. */
+  bool use_parallel_frames;
+  int parallel_frames_memory;
 };
 
 /* The USD_export takes a as_background_job parameter, and returns a boolean.
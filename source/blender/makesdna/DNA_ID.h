@@ -458,6 +458,11 @@ typedef struct PreviewImage {
  * Keep in sync with #BKE_id_eval_properties_copy. */
 #define ID_TYPE_SUPPORTS_PARAMS_WITHOUT_COW(id_type) ELEM(id_type, ID_ME)
 
+/* Recalc flags which can be handled by copying only the affected data to an already expanded
+ * copy-on-write data-block, instead of copying the whole data-block again.
+ * Keep in sync with #BKE_id_eval_partial_copy. */
+#define ID_TYPE_PARTIAL_COW_RECALC(id_type) (((id_type) == ID_OB) ? ID_RECALC_TRANSFORM_ONLY : 0)
+
 #ifdef GS
 #  undef GS
 #endif
@@ -697,6 +702,12 @@ typedef enum IDRecalcFlag {
    */
   ID_RECALC_TAG_FOR_UNDO = (1 << 24),
 
+  /* Only the object transform settings changed, which are copied to the evaluated object by
+   * #BKE_object_transform_copy_for_eval. Allows to update the evaluated object without copying
+   * the whole data-block, so only tag this when it's certain nothing else in the object changed,
+   * like the transform tool does. Implies #ID_RECALC_TRANSFORM. */
+  ID_RECALC_TRANSFORM_ONLY = (1 << 25),
+
   /***************************************************************************
    * Pseudonyms, to have more semantic meaning in the actual code without
    * using too much low-level and implementation specific tags. */
@@ -680,7 +680,11 @@ typedef struct bAction {
    * (if 0, will be set to whatever ID first evaluates it).
    */
   int idroot;
-  char _pad[4];
+  /**
+   * Runtime: new value is assigned whenever the F-Curves are copied (which happens when the
+   * action is copied for evaluation), used to validate caches of resolved F-Curve paths.
+   */
+  unsigned int fcurves_generation;
 
   PreviewImage *preview;
 } bAction;
@@ -1116,6 +1116,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved RNA paths of the active action F-Curves (see `anim_sys.c`). */
+  struct AnimChannelBindings *channel_bindings;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
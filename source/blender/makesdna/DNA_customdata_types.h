@@ -53,6 +53,11 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /**
+   * Run-time only: ownership of #data that is shared with layers in other #CustomData, see
+   * #CD_SHARE. The data is copied before it is changed in that case.
+   */
+  struct CustomDataSharing *sharing;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
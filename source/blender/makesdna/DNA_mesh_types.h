@@ -103,6 +103,9 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /** Compact copy of the vertex weights, used by armature deform (`armature_deform.c`). */
+  struct ArmatureSkinWeights *skin_weights;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
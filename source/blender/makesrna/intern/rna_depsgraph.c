@@ -252,6 +252,31 @@ static void rna_Depsgraph_debug_stats_gnuplot(Depsgraph *depsgraph,
   fclose(f);
 }
 
+static void rna_Depsgraph_debug_trace_write(Depsgraph *depsgraph,
+                                            ReportList *reports,
+                                            const char *filepath)
+{
+  switch (DEG_debug_trace_write(depsgraph, filepath)) {
+    case DEG_TRACE_WRITE_SUCCESS:
+      break;
+    case DEG_TRACE_WRITE_EMPTY:
+      BKE_reportf(reports,
+                  RPT_ERROR,
+                  "No recorded evaluation trace to write to \"%s\", it is only recorded while "
+                  "bpy.app.debug_depsgraph_trace is enabled",
+                  filepath);
+      break;
+    case DEG_TRACE_WRITE_CANT_OPEN_FILE:
+      BKE_reportf(reports, RPT_ERROR, "Could not open \"%s\" for writing", filepath);
+      break;
+  }
+}
+
+static void rna_Depsgraph_debug_trace_clear(Depsgraph *depsgraph)
+{
+  DEG_debug_trace_clear(depsgraph);
+}
+
 static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 {
   DEG_graph_tag_relations_update(depsgraph);
@@ -665,6 +690,18 @@ static void rna_def_depsgraph(BlenderRNA *brna)
                                   "File name where gnuplot script will save the result");
   RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "debug_trace_write", "rna_Depsgraph_debug_trace_write");
+  RNA_def_function_ui_description(func,
+                                  "Write the operations evaluated while the evaluation trace was "
+                                  "enabled as Chrome trace event JSON file");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+  parm = RNA_def_string_file_path(
+      func, "filepath", NULL, FILE_MAX, "File Path", "Output path for the trace file");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
+  func = RNA_def_function(srna, "debug_trace_clear", "rna_Depsgraph_debug_trace_clear");
+  RNA_def_function_ui_description(func, "Discard the recorded evaluation trace");
+
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
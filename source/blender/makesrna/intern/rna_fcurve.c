@@ -639,9 +639,12 @@ static void rna_FCurve_update_data(Main *bmain, Scene *UNUSED(scene), PointerRNA
 
 static void rna_FCurve_update_data_relations(Main *bmain,
                                              Scene *UNUSED(scene),
-                                             PointerRNA *UNUSED(ptr))
+                                             PointerRNA *ptr)
 {
   DEG_relations_tag_update(bmain);
+  /* The evaluated copy of the action still has the old path, and so do the channel bindings
+   * cached for it. */
+  rna_tag_animation_update(bmain, ptr->owner_id);
 }
 
 /* RNA update callback for F-Curves to indicate that there are copy-on-write tagging/flushing
@@ -2395,14 +2398,12 @@ static void rna_def_fcurve(BlenderRNA *brna)
   RNA_def_property_string_funcs(
       prop, "rna_FCurve_RnaPath_get", "rna_FCurve_RnaPath_length", "rna_FCurve_RnaPath_set");
   RNA_def_property_ui_text(prop, "Data Path", "RNA Path to property affected by F-Curve");
-  /* XXX need an update callback for this to that animation gets evaluated */
   RNA_def_property_update(prop, NC_ANIMATION, "rna_FCurve_update_data_relations");
 
   /* called 'index' when given as function arg */
   prop = RNA_def_property(srna, "array_index", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_ui_text(
       prop, "RNA Array Index", "Index to the specific property affected by F-Curve if applicable");
-  /* XXX need an update callback for this so that animation gets evaluated */
   RNA_def_property_update(prop, NC_ANIMATION, "rna_FCurve_update_data_relations");
 
   /* Color */
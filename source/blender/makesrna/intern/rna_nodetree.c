@@ -1550,6 +1550,14 @@ static void rna_NodeTree_outputs_move(bNodeTree *ntree, Main *bmain, int from_in
   WM_main_add_notifier(NC_NODE | NA_EDITED, ntree);
 }
 
+static void rna_NodeTree_execution_trace_write(bNodeTree *ntree,
+                                               bContext *C,
+                                               ReportList *reports,
+                                               const char *filepath)
+{
+  BKE_nodetree_execution_trace_write(C, ntree, filepath, reports);
+}
+
 static void rna_NodeTree_interface_update(bNodeTree *ntree, bContext *C)
 {
   Main *bmain = CTX_data_main(C);
@@ -2419,6 +2427,23 @@ static void rna_Node_socket_value_update(ID *id, bNode *node, bContext *C)
   ED_node_tag_update_nodetree(CTX_data_main(C), (bNodeTree *)id, node);
 }
 
+static void rna_Node_execution_info(ID *id,
+                                    bNode *node,
+                                    bContext *C,
+                                    int *r_calls,
+                                    float *r_duration,
+                                    int *r_output_geometry_size,
+                                    float *r_memory_in_use)
+{
+  double duration;
+  int64_t output_geometry_size, memory_in_use;
+  BKE_node_execution_info_get(
+      C, (bNodeTree *)id, node, r_calls, &duration, &output_geometry_size, &memory_in_use);
+  *r_duration = (float)duration;
+  *r_output_geometry_size = (int)MIN2(output_geometry_size, INT_MAX);
+  *r_memory_in_use = (float)memory_in_use / (1024.0f * 1024.0f);
+}
+
 static void rna_Node_select_set(PointerRNA *ptr, bool value)
 {
   bNode *node = (bNode *)ptr->data;
@@ -11280,6 +11305,46 @@ static void rna_def_node(BlenderRNA *brna)
   parm = RNA_def_pointer(func, "context", "Context", "", "");
   RNA_def_parameter_flags(parm, PROP_NEVER_NULL, PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "execution_info", "rna_Node_execution_info");
+  RNA_def_function_ui_description(
+      func,
+      "Statistics of the executions of the node during the last evaluation of the node tree by "
+      "the active object and modifier");
+  RNA_def_function_flag(func, FUNC_USE_SELF_ID | FUNC_USE_CONTEXT);
+  parm = RNA_def_int(func, "calls", 0, 0, INT_MAX, "Calls", "Number of executions", 0, INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func,
+                       "time",
+                       0.0f,
+                       0.0f,
+                       FLT_MAX,
+                       "Time",
+                       "Total execution time in seconds",
+                       0.0f,
+                       FLT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_int(func,
+                     "geometry_size",
+                     0,
+                     0,
+                     INT_MAX,
+                     "Geometry Size",
+                     "Number of points in all output geometries",
+                     0,
+                     INT_MAX);
+  RNA_def_function_output(func, parm);
+  parm = RNA_def_float(func,
+                       "memory_in_use",
+                       0.0f,
+                       0.0f,
+                       FLT_MAX,
+                       "Memory in Use",
+                       "Highest total memory in use right after an execution of the node in "
+                       "megabytes, including memory that was not allocated by the node",
+                       0.0f,
+                       FLT_MAX);
+  RNA_def_function_output(func, parm);
+
   func = RNA_def_function(srna, "is_registered_node_type", "rna_Node_is_registered_node_type");
   RNA_def_function_ui_description(func, "True if a registered node type");
   RNA_def_function_flag(func, FUNC_NO_SELF | FUNC_USE_SELF_TYPE);
@@ -11712,6 +11777,15 @@ static void rna_def_nodetree(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Active Output", "Index of the active output");
   RNA_def_property_update(prop, NC_NODE, NULL);
 
+  func = RNA_def_function(srna, "write_execution_trace", "rna_NodeTree_execution_trace_write");
+  RNA_def_function_ui_description(func,
+                                  "Write the node executions of the last evaluation by the "
+                                  "active object and modifier as Chrome trace event JSON file");
+  RNA_def_function_flag(func, FUNC_USE_CONTEXT | FUNC_USE_REPORTS);
+  parm = RNA_def_string_file_path(
+      func, "filepath", NULL, 0, "", "File path to write the trace to");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
   /* exposed as a function for runtime interface type properties */
   func = RNA_def_function(srna, "interface_update", "rna_NodeTree_interface_update");
   RNA_def_function_ui_description(func, "Updated node group interface");
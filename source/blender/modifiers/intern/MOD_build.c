@@ -41,7 +41,6 @@
 #include "BKE_mesh.h"
 #include "BKE_modifier.h"
 #include "BKE_particle.h"
-#include "BKE_scene.h"
 #include "BKE_screen.h"
 
 #include "UI_interface.h"
@@ -100,8 +99,7 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, struct
   range_vn_i(edgeMap, numEdge_src, 0);
   range_vn_i(faceMap, numPoly_src, 0);
 
-  struct Scene *scene = DEG_get_input_scene(ctx->depsgraph);
-  frac = (BKE_scene_frame_get(scene) - bmd->start) / bmd->length;
+  frac = (DEG_get_ctime(ctx->depsgraph) - bmd->start) / bmd->length;
   CLAMP(frac, 0.0f, 1.0f);
   if (bmd->flag & MOD_BUILD_FLAG_REVERSE) {
     frac = 1.0f - frac;
@@ -24,6 +24,7 @@
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "MEM_guardedalloc.h"
 
@@ -96,10 +97,14 @@ using blender::StringRefNull;
 using blender::Vector;
 using blender::fn::GMutablePointer;
 using blender::fn::GPointer;
+using blender::modifiers::geometry_nodes::GeometryNodesCache;
 using blender::nodes::GeoNodeExecParams;
 using namespace blender::fn::multi_function_types;
 using namespace blender::nodes::derived_node_tree_types;
 
+/* Maximum memory used by cached node outputs of a single modifier. */
+static const int64_t cache_memory_budget = 256 * 1024 * 1024;
+
 static void initData(ModifierData *md)
 {
   NodesModifierData *nmd = (NodesModifierData *)md;
@@ -906,6 +911,45 @@ static void log_ui_hints(const DSocket socket,
   }
 }
 
+/**
+ * Create the callback that stores the timing and memory statistics of every executed node in the
+ * UI storage of the original node trees, so that they can be displayed and queried from Python.
+ */
+static blender::modifiers::geometry_nodes::LogNodeExecutionFn log_node_execution_fn(
+    Object *self_object, NodesModifierData *nmd)
+{
+  using blender::timeit::TimePoint;
+  using blender::timeit::Nanoseconds;
+
+  bNodeTree *root_btree_original = (bNodeTree *)DEG_get_original_id(&nmd->node_group->id);
+  const NodeTreeEvaluationContext context{*self_object, nmd->modifier};
+  const TimePoint evaluation_start = blender::timeit::Clock::now();
+
+  return [=](const DNode node,
+             const TimePoint start,
+             const TimePoint end,
+             const int64_t output_geometry_size) {
+    bNodeTree *btree_original = (bNodeTree *)DEG_get_original_id((ID *)node->btree());
+    const Nanoseconds duration = end - start;
+    BKE_nodetree_node_execution_add(*btree_original,
+                                    context,
+                                    *node->bnode(),
+                                    duration.count() / 1e9,
+                                    output_geometry_size,
+                                    (int64_t)MEM_get_memory_in_use());
+
+    NodeExecutionEvent event;
+    event.tree_name = btree_original->id.name + 2;
+    event.node_name = node->bnode()->name;
+    event.start = std::chrono::duration_cast<std::chrono::microseconds>(start - evaluation_start)
+                      .count();
+    event.end = std::chrono::duration_cast<std::chrono::microseconds>(end - evaluation_start)
+                    .count();
+    event.thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    BKE_nodetree_execution_event_add(*root_btree_original, context, std::move(event));
+  };
+}
+
 /**
  * Evaluate a node group to compute the output geometry.
  * Currently, this uses a fairly basic and inefficient algorithm that might compute things more
@@ -980,6 +1024,17 @@ static GeometrySet compute_geometry(const DerivedNodeTree &tree,
   eval_params.depsgraph = ctx->depsgraph;
   eval_params.self_object = ctx->object;
   eval_params.log_socket_value_fn = log_socket_value;
+  if (logging_enabled(ctx)) {
+    eval_params.log_node_execution_fn = log_node_execution_fn(ctx->object, nmd);
+  }
+  /* Only cache in the viewport where the same tree is evaluated many times with small changes.
+   * The cache is stored in the runtime data, which is kept across copy-on-write updates. */
+  if (DEG_get_mode(ctx->depsgraph) == DAG_EVAL_VIEWPORT) {
+    if (nmd->modifier.runtime == nullptr) {
+      nmd->modifier.runtime = new GeometryNodesCache(cache_memory_budget);
+    }
+    eval_params.cache = static_cast<GeometryNodesCache *>(nmd->modifier.runtime);
+  }
   blender::modifiers::geometry_nodes::evaluate_geometry_nodes(eval_params);
 
   BLI_assert(eval_params.r_output_values.size() == 1);
@@ -1233,6 +1288,12 @@ static void copyData(const ModifierData *md, ModifierData *target, const int fla
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  GeometryNodesCache *cache = static_cast<GeometryNodesCache *>(runtime_data_v);
+  delete cache;
+}
+
 static void freeData(ModifierData *md)
 {
   NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
@@ -1240,6 +1301,8 @@ static void freeData(ModifierData *md)
     IDP_FreeProperty_ex(nmd->settings.properties, false);
     nmd->settings.properties = nullptr;
   }
+  freeRuntimeData(nmd->modifier.runtime);
+  nmd->modifier.runtime = nullptr;
 }
 
 static void requiredDataMask(Object *UNUSED(ob),
@@ -1283,7 +1346,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ foreachTexLink,
-    /* freeRuntimeData */ nullptr,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
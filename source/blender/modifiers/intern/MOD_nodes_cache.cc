@@ -0,0 +1,426 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software  Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup modifiers
+ */
+
+#include <cstring>
+
+#include "MOD_nodes_cache.hh"
+
+#include "BLI_vector.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_node_types.h"
+#include "DNA_pointcloud_types.h"
+#include "DNA_sdna_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_geometry_set.hh"
+#include "BKE_node.h"
+#include "BKE_spline.hh"
+
+#include "DNA_genfile.h"
+
+struct Collection;
+struct Object;
+struct Tex;
+
+namespace blender::modifiers::geometry_nodes {
+
+/* -------------------------------------------------------------------- */
+/** \name Hashing
+ * \{ */
+
+/* Cache keys only store the hashes of input values, not the values themselves. Therefore all
+ * values are hashed by their full content with a 64 bit hash, to make collisions very unlikely. */
+static uint64_t hash_mix(uint64_t value)
+{
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+uint64_t cache_hash_combine(const uint64_t a, const uint64_t b)
+{
+  return hash_mix(a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2)));
+}
+
+static uint64_t hash_bytes(const void *data, const size_t size, uint64_t hash)
+{
+  const char *bytes = static_cast<const char *>(data);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash = (hash ^ hash_mix(word)) * 0x100000001b3ull;
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    memcpy(&word, bytes + i, size - i);
+    hash = (hash ^ hash_mix(word)) * 0x100000001b3ull;
+  }
+  return hash_mix(hash ^ size);
+}
+
+static uint64_t hash_string(const char *str, const uint64_t hash)
+{
+  return hash_bytes(str, strlen(str), hash);
+}
+
+static bool dna_struct_has_pointers(const SDNA &sdna, const int struct_nr)
+{
+  const SDNA_Struct *struct_info = sdna.structs[struct_nr];
+  for (const int i : IndexRange(struct_info->members_len)) {
+    const SDNA_StructMember &member = struct_info->members[i];
+    const char *name = sdna.names[member.name];
+    if (name[0] == '*' || name[0] == '(') {
+      return true;
+    }
+    const int member_struct_nr = DNA_struct_find_nr(&sdna, sdna.types[member.type]);
+    if (member_struct_nr != -1 && dna_struct_has_pointers(sdna, member_struct_nr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Storage that contains pointers can't be hashed by its bytes, because the data it points to can
+ * change, or be freed and reallocated at the same address. */
+static bool node_storage_is_hashable(const bNodeType &type)
+{
+  static std::mutex mutex;
+  static Map<const bNodeType *, bool> hashable_by_type;
+
+  std::lock_guard lock{mutex};
+  return hashable_by_type.lookup_or_add_cb(&type, [&]() {
+    const SDNA *sdna = DNA_sdna_current_get();
+    const int struct_nr = DNA_struct_find_nr(sdna, type.storagename);
+    return struct_nr != -1 && !dna_struct_has_pointers(*sdna, struct_nr);
+  });
+}
+
+std::optional<uint64_t> cache_hash_node_settings(const bNode &node)
+{
+  if (node.id != nullptr) {
+    return std::nullopt;
+  }
+
+  uint64_t hash = hash_string(node.typeinfo->idname, 0);
+  hash = cache_hash_combine(hash, node.custom1);
+  hash = cache_hash_combine(hash, node.custom2);
+  hash = hash_bytes(&node.custom3, sizeof(node.custom3), hash);
+  hash = hash_bytes(&node.custom4, sizeof(node.custom4), hash);
+  hash = cache_hash_combine(hash, node.flag & NODE_MUTED);
+
+  if (node.storage != nullptr) {
+    if (!node_storage_is_hashable(*node.typeinfo)) {
+      return std::nullopt;
+    }
+    hash = hash_bytes(node.storage, MEM_allocN_len(node.storage), hash);
+  }
+
+  return hash;
+}
+
+static uint64_t hash_custom_data(const CustomData &data, const int size, uint64_t hash)
+{
+  for (const int i : IndexRange(data.totlayer)) {
+    const CustomDataLayer &layer = data.layers[i];
+    hash = cache_hash_combine(hash, layer.type);
+    hash = hash_string(layer.name, hash);
+    if (layer.type == CD_MDEFORMVERT) {
+      /* Weights are stored in separate arrays. */
+      const MDeformVert *dverts = static_cast<const MDeformVert *>(layer.data);
+      for (const int i_vert : IndexRange(size)) {
+        hash = hash_bytes(
+            dverts[i_vert].dw, sizeof(MDeformWeight) * dverts[i_vert].totweight, hash);
+      }
+    }
+    else {
+      hash = hash_bytes(
+          layer.data, static_cast<size_t>(CustomData_sizeof(layer.type)) * size, hash);
+    }
+  }
+  return hash;
+}
+
+static std::optional<uint64_t> hash_geometry_component(const GeometryComponent &component)
+{
+  uint64_t hash = cache_hash_combine(0, component.type());
+
+  switch (component.type()) {
+    case GEO_COMPONENT_TYPE_MESH: {
+      const MeshComponent &mesh_component = static_cast<const MeshComponent &>(component);
+      const Mesh *mesh = mesh_component.get_for_read();
+      if (mesh == nullptr) {
+        return hash;
+      }
+      hash = hash_custom_data(mesh->vdata, mesh->totvert, hash);
+      hash = hash_custom_data(mesh->edata, mesh->totedge, hash);
+      hash = hash_custom_data(mesh->ldata, mesh->totloop, hash);
+      hash = hash_custom_data(mesh->pdata, mesh->totpoly, hash);
+      for (const auto item : mesh_component.vertex_group_names().items()) {
+        hash = hash_string(item.key.c_str(), hash);
+        hash = cache_hash_combine(hash, item.value);
+      }
+      /* Materials are referenced, but they don't change the geometry. */
+      hash = hash_bytes(mesh->mat, sizeof(Material *) * mesh->totcol, hash);
+      return hash;
+    }
+    case GEO_COMPONENT_TYPE_POINT_CLOUD: {
+      const PointCloudComponent &pointcloud_component =
+          static_cast<const PointCloudComponent &>(component);
+      const PointCloud *pointcloud = pointcloud_component.get_for_read();
+      if (pointcloud == nullptr) {
+        return hash;
+      }
+      return hash_custom_data(pointcloud->pdata, pointcloud->totpoint, hash);
+    }
+    case GEO_COMPONENT_TYPE_INSTANCES: {
+      const InstancesComponent &instances_component = static_cast<const InstancesComponent &>(
+          component);
+      /* Instanced objects and collections can change without the reference changing. */
+      for (const InstanceReference &reference : instances_component.references()) {
+        if (reference.type() != InstanceReference::Type::None) {
+          return std::nullopt;
+        }
+      }
+      const Span<float4x4> transforms = instances_component.instance_transforms();
+      const Span<int> handles = instances_component.instance_reference_handles();
+      const Span<int> ids = instances_component.instance_ids();
+      hash = hash_bytes(transforms.data(), transforms.size_in_bytes(), hash);
+      hash = hash_bytes(handles.data(), handles.size_in_bytes(), hash);
+      hash = hash_bytes(ids.data(), ids.size_in_bytes(), hash);
+      return hash;
+    }
+    case GEO_COMPONENT_TYPE_CURVE:
+    case GEO_COMPONENT_TYPE_VOLUME:
+      /* Not supported yet, these are not passed into the modifier from the modifier stack. */
+      return std::nullopt;
+  }
+
+  return std::nullopt;
+}
+
+std::optional<uint64_t> cache_hash_value(const GPointer value)
+{
+  const CPPType &type = *value.type();
+
+  if (type == CPPType::get<GeometrySet>()) {
+    const GeometrySet &geometry_set = *static_cast<const GeometrySet *>(value.get());
+    uint64_t hash = 0;
+    for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+      const std::optional<uint64_t> component_hash = hash_geometry_component(*component);
+      if (!component_hash) {
+        return std::nullopt;
+      }
+      hash = cache_hash_combine(hash, *component_hash);
+    }
+    return hash;
+  }
+  if (type == CPPType::get<Object *>() || type == CPPType::get<Collection *>() ||
+      type == CPPType::get<Tex *>()) {
+    /* The referenced data can change without changing the pointer. */
+    return std::nullopt;
+  }
+
+  const uint64_t type_hash = hash_string(type.name().c_str(), 0);
+  if (type == CPPType::get<std::string>()) {
+    const std::string &str = *static_cast<const std::string *>(value.get());
+    return hash_bytes(str.data(), str.size(), type_hash);
+  }
+  if (type.is_trivially_destructible()) {
+    /* Socket values like floats, vectors and colors are plain data. Don't use #CPPType::hash,
+     * it is meant for hash tables and e.g. only combines the components of vectors weakly. */
+    return hash_bytes(value.get(), static_cast<size_t>(type.size()), type_hash);
+  }
+  /* The content of other types is not known to be fully represented by their hash. */
+  return std::nullopt;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Memory Usage
+ * \{ */
+
+static int64_t custom_data_memory_size(const CustomData &data, const int size)
+{
+  int64_t memory_size = 0;
+  for (const int i : IndexRange(data.totlayer)) {
+    memory_size += static_cast<int64_t>(CustomData_sizeof(data.layers[i].type)) * size;
+  }
+  return memory_size;
+}
+
+/**
+ * Approximate memory used by the value, components shared with other values are counted
+ * multiple times. Nothing is returned for values that should not be cached.
+ */
+static std::optional<int64_t> value_memory_size(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (type != CPPType::get<GeometrySet>()) {
+    return type.size();
+  }
+
+  const GeometrySet &geometry_set = *static_cast<const GeometrySet *>(value.get());
+  int64_t memory_size = sizeof(GeometrySet);
+
+  if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+    memory_size += custom_data_memory_size(mesh->vdata, mesh->totvert);
+    memory_size += custom_data_memory_size(mesh->edata, mesh->totedge);
+    memory_size += custom_data_memory_size(mesh->ldata, mesh->totloop);
+    memory_size += custom_data_memory_size(mesh->pdata, mesh->totpoly);
+  }
+  if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+    memory_size += custom_data_memory_size(pointcloud->pdata, pointcloud->totpoint);
+  }
+  if (const CurveEval *curve = geometry_set.get_curve_for_read()) {
+    for (const SplinePtr &spline : curve->splines()) {
+      memory_size += static_cast<int64_t>(spline->size()) * (sizeof(float3) + 2 * sizeof(float));
+    }
+  }
+  if (const InstancesComponent *instances =
+          geometry_set.get_component_for_read<InstancesComponent>()) {
+    memory_size += static_cast<int64_t>(instances->instances_amount()) *
+                   (sizeof(float4x4) + 2 * sizeof(int));
+  }
+  if (geometry_set.has<VolumeComponent>()) {
+    /* Volume grids can be large and their size is not known here. */
+    return std::nullopt;
+  }
+
+  return memory_size;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Cache
+ * \{ */
+
+uint64_t GeometryNodesCacheKey::hash() const
+{
+  uint64_t hash = hash_string(node_name.c_str(), output_index);
+  for (const uint64_t value : hashes) {
+    hash = cache_hash_combine(hash, value);
+  }
+  return hash;
+}
+
+GeometryNodesCache::GeometryNodesCache(const int64_t memory_budget) : memory_budget_(memory_budget)
+{
+}
+
+GeometryNodesCache::~GeometryNodesCache()
+{
+  for (Entry &entry : entries_.values()) {
+    entry.value.destruct();
+    MEM_freeN(entry.value.get());
+  }
+}
+
+bool GeometryNodesCache::lookup(const GeometryNodesCacheKey &key,
+                                const CPPType &type,
+                                void *r_value)
+{
+  std::lock_guard lock{mutex_};
+  Entry *entry = entries_.lookup_ptr(key);
+  if (entry == nullptr || *entry->value.type() != type) {
+    return false;
+  }
+  entry->last_used = evaluation_;
+  type.copy_to_uninitialized(entry->value.get(), r_value);
+  return true;
+}
+
+void GeometryNodesCache::add(const GeometryNodesCacheKey &key, const GPointer value)
+{
+  const std::optional<int64_t> memory_size = value_memory_size(value);
+  if (!memory_size || *memory_size > memory_budget_) {
+    return;
+  }
+
+  /* Copy the value outside of the lock, the geometry may have to be copied to make sure that it
+   * doesn't reference data that is freed after the evaluation. */
+  const CPPType &type = *value.type();
+  void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+  type.copy_to_uninitialized(value.get(), buffer);
+  if (type == CPPType::get<GeometrySet>()) {
+    static_cast<GeometrySet *>(buffer)->ensure_owns_direct_data();
+  }
+
+  std::lock_guard lock{mutex_};
+  if (Entry *existing_entry = entries_.lookup_ptr(key)) {
+    this->remove_entry(key, *existing_entry);
+  }
+  entries_.add_new(key, {{type, buffer}, *memory_size, evaluation_});
+  memory_usage_ += *memory_size;
+  this->evict_until_below_budget();
+}
+
+void GeometryNodesCache::remove_unused(const Set<GeometryNodesCacheKey> &used_keys)
+{
+  std::lock_guard lock{mutex_};
+
+  Vector<GeometryNodesCacheKey> keys_to_remove;
+  for (const GeometryNodesCacheKey &key : entries_.keys()) {
+    if (!used_keys.contains(key)) {
+      keys_to_remove.append(key);
+    }
+  }
+  for (const GeometryNodesCacheKey &key : keys_to_remove) {
+    this->remove_entry(key, entries_.lookup(key));
+  }
+
+  evaluation_++;
+}
+
+void GeometryNodesCache::remove_entry(const GeometryNodesCacheKey &key, Entry &entry)
+{
+  memory_usage_ -= entry.memory_size;
+  entry.value.destruct();
+  MEM_freeN(entry.value.get());
+  entries_.remove(key);
+}
+
+void GeometryNodesCache::evict_until_below_budget()
+{
+  while (memory_usage_ > memory_budget_ && !entries_.is_empty()) {
+    const GeometryNodesCacheKey *oldest_key = nullptr;
+    uint64_t oldest_evaluation = UINT64_MAX;
+    for (const auto item : entries_.items()) {
+      if (item.value.last_used < oldest_evaluation) {
+        oldest_key = &item.key;
+        oldest_evaluation = item.value.last_used;
+      }
+    }
+    /* Copy the key, it is destructed when the entry is removed. */
+    const GeometryNodesCacheKey key = *oldest_key;
+    this->remove_entry(key, entries_.lookup(key));
+  }
+}
+
+/** \} */
+
+}  // namespace blender::modifiers::geometry_nodes
@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software  Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup modifiers
+ *
+ * Cache of node output values that persists across evaluations of a geometry nodes modifier.
+ *
+ * Values are keyed by a hash of everything that went into computing them: the node type and
+ * settings, the values of unlinked inputs and recursively the hashes of linked inputs, up to the
+ * inputs of the modifier. Therefore, when the hash of a node output is found in the cache, the
+ * entire part of the node tree that computes it does not have to be evaluated again. Nodes that
+ * depend on data that is not part of the hash, like other objects, are never cached.
+ */
+
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#include "FN_generic_pointer.hh"
+
+#include "MEM_guardedalloc.h"
+
+struct bNode;
+
+namespace blender::modifiers::geometry_nodes {
+
+using fn::CPPType;
+using fn::GMutablePointer;
+using fn::GPointer;
+
+/** Combine two hashes in an order dependent way. */
+uint64_t cache_hash_combine(uint64_t a, uint64_t b);
+
+/**
+ * Hash of the node settings that are not stored in sockets. Nothing is returned when the node
+ * depends on data that can't be hashed, in which case its outputs must not be cached.
+ */
+std::optional<uint64_t> cache_hash_node_settings(const bNode &node);
+
+/**
+ * Hash of the entire content of a value. Nothing is returned for values that reference data which
+ * can change independently from the value itself, like objects, or whose content can't be hashed.
+ */
+std::optional<uint64_t> cache_hash_value(GPointer value);
+
+/**
+ * Identifies a cached node output. The key is stored with the cached value and compared on
+ * lookup, so that a collision of the combined hash can't return the value of another output.
+ * Input values are only compared by their 64 bit hashes, see #cache_hash_value.
+ */
+struct GeometryNodesCacheKey {
+  std::string node_name;
+  int output_index;
+  /** Hash of the node settings, followed by the hashes of all input values. */
+  Vector<uint64_t> hashes;
+
+  uint64_t hash() const;
+
+  friend bool operator==(const GeometryNodesCacheKey &a, const GeometryNodesCacheKey &b)
+  {
+    return a.output_index == b.output_index && a.hashes == b.hashes &&
+           a.node_name == b.node_name;
+  }
+};
+
+class GeometryNodesCache {
+ private:
+  struct Entry {
+    GMutablePointer value;
+    int64_t memory_size;
+    /* Evaluation in which the value was added or used last, for evicting the oldest values. */
+    uint64_t last_used;
+  };
+
+  std::mutex mutex_;
+  Map<GeometryNodesCacheKey, Entry> entries_;
+  int64_t memory_usage_ = 0;
+  int64_t memory_budget_;
+  uint64_t evaluation_ = 0;
+
+ public:
+  GeometryNodesCache(int64_t memory_budget);
+  ~GeometryNodesCache();
+
+  /**
+   * Copy the cached value into uninitialized memory. Returns false if there is no value with a
+   * matching key and type.
+   */
+  bool lookup(const GeometryNodesCacheKey &key, const CPPType &type, void *r_value);
+
+  /** Add a copy of the value, evicting the least recently used values when over budget. */
+  void add(const GeometryNodesCacheKey &key, GPointer value);
+
+  /**
+   * Called after every evaluation. Values with keys not computed by the last evaluation can never
+   * be used again, because some of their inputs changed.
+   */
+  void remove_unused(const Set<GeometryNodesCacheKey> &used_keys);
+
+  int64_t memory_usage() const
+  {
+    return memory_usage_;
+  }
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("GeometryNodesCache")
+
+ private:
+  void remove_entry(const GeometryNodesCacheKey &key, Entry &entry);
+  void evict_until_below_budget();
+};
+
+}  // namespace blender::modifiers::geometry_nodes
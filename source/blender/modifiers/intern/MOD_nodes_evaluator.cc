@@ -220,6 +220,22 @@ struct NodeState {
    * not run twice at the same time accidentally.
    */
   NodeScheduleState schedule_state = NodeScheduleState::NotScheduled;
+
+  /**
+   * Hash of everything that the outputs of this node depend on. It is empty when the outputs
+   * depend on data that can't be hashed. This is only computed when there is a cache and is not
+   * modified anymore while nodes are executed, so it can be read without locking.
+   */
+  std::optional<uint64_t> cache_hash;
+  bool cache_hash_is_computed = false;
+  /** Hashes #cache_hash is combined from, stored with cached values to verify cache hits. */
+  Vector<uint64_t> cache_key_hashes;
+
+  /**
+   * Output values that have been found in the cache, indexed by output socket index. When this
+   * is not empty, these values are forwarded instead of executing the node.
+   */
+  Vector<GMutablePointer> cached_output_values;
 };
 
 /**
@@ -314,6 +330,9 @@ class NodeParamsProvider : public nodes::GeoNodeExecParamsProvider {
   NodeState &node_state_;
 
  public:
+  /** Number of points in the geometries that have been output so far, for profiling. */
+  int64_t output_geometry_size = 0;
+
   NodeParamsProvider(GeometryNodesEvaluator &evaluator, DNode dnode, NodeState &node_state);
 
   bool can_get_input(StringRef identifier) const override;
@@ -353,6 +372,18 @@ class GeometryNodesEvaluator {
    */
   VectorSet<NodeWithState> node_states_;
 
+  /**
+   * Cache keys of all outputs that can be stored in the cache in this evaluation. Values with
+   * other keys are removed from the cache afterwards.
+   */
+  Set<GeometryNodesCacheKey> used_cache_keys_;
+
+  /**
+   * Hashes of the values passed into the node group, computed once per evaluation because hashing
+   * a geometry has to read all of its data.
+   */
+  Map<DOutputSocket, std::optional<uint64_t>> input_value_hashes_;
+
   /**
    * Contains all the tasks for the nodes that are currently scheduled.
    */
@@ -376,6 +407,10 @@ class GeometryNodesEvaluator {
     task_pool_ = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
 
     this->create_states_for_reachable_nodes();
+    if (params_.cache != nullptr) {
+      /* Has to happen before the group inputs are forwarded, because their values are hashed. */
+      this->compute_cache_hashes();
+    }
     this->forward_group_inputs();
     this->schedule_initial_nodes();
 
@@ -385,6 +420,10 @@ class GeometryNodesEvaluator {
 
     this->extract_group_outputs();
     this->destruct_node_states();
+
+    if (params_.cache != nullptr) {
+      params_.cache->remove_unused(used_cache_keys_);
+    }
   }
 
   void create_states_for_reachable_nodes()
@@ -499,6 +538,124 @@ class GeometryNodesEvaluator {
     }
   }
 
+  void compute_cache_hashes()
+  {
+    for (auto &&item : params_.input_values.items()) {
+      input_value_hashes_.add_new(item.key, cache_hash_value(item.value));
+    }
+    for (const NodeWithState &item : node_states_) {
+      this->ensure_cache_hash(item.node, *item.state);
+      if (!this->node_uses_cache(item.node, *item.state)) {
+        continue;
+      }
+      for (const int i : item.node->outputs().index_range()) {
+        used_cache_keys_.add(this->cache_key(item.node, *item.state, i));
+      }
+    }
+  }
+
+  GeometryNodesCacheKey cache_key(const DNode node,
+                                  const NodeState &node_state,
+                                  const int output_index)
+  {
+    return {node->name(), output_index, node_state.cache_key_hashes};
+  }
+
+  const std::optional<uint64_t> &ensure_cache_hash(const DNode node, NodeState &node_state)
+  {
+    if (!node_state.cache_hash_is_computed) {
+      /* Node trees don't have cycles, so this recursion always ends. */
+      node_state.cache_hash = this->compute_cache_hash(node, node_state);
+      node_state.cache_hash_is_computed = true;
+    }
+    return node_state.cache_hash;
+  }
+
+  /**
+   * The hashes that the returned hash is combined from are stored in the node state as well: the
+   * hash of the node settings followed by the hashes of the input values.
+   */
+  std::optional<uint64_t> compute_cache_hash(const DNode node, NodeState &node_state)
+  {
+    Vector<uint64_t> &hashes = node_state.cache_key_hashes;
+    if (node->is_group_input_node() || node->is_group_output_node()) {
+      return std::nullopt;
+    }
+    const std::optional<uint64_t> settings_hash = cache_hash_node_settings(*node->bnode());
+    if (!settings_hash) {
+      return std::nullopt;
+    }
+    uint64_t hash = *settings_hash;
+    hashes.append(hash);
+
+    bool is_hashable = true;
+    auto add_value_hash = [&](const std::optional<uint64_t> &value_hash) {
+      if (!value_hash) {
+        is_hashable = false;
+        return;
+      }
+      hash = cache_hash_combine(hash, *value_hash);
+      hashes.append(*value_hash);
+    };
+
+    for (const int i : node->inputs().index_range()) {
+      const InputState &input_state = node_state.inputs[i];
+      if (input_state.type == nullptr) {
+        /* Ignore unavailable and non-data sockets. */
+        continue;
+      }
+      const DInputSocket socket = node.input(i);
+      bool is_linked = false;
+      socket.foreach_origin_socket([&](const DSocket origin) {
+        is_linked = true;
+        if (is_hashable) {
+          add_value_hash(this->compute_origin_cache_hash(origin, *input_state.type));
+        }
+      });
+      if (!is_linked && is_hashable) {
+        /* The value is read from the socket itself. */
+        add_value_hash(this->compute_origin_cache_hash(socket, *input_state.type));
+      }
+      if (!is_hashable) {
+        hashes.clear();
+        return std::nullopt;
+      }
+    }
+    return hash;
+  }
+
+  std::optional<uint64_t> compute_origin_cache_hash(const DSocket origin, const CPPType &type)
+  {
+    if (origin->is_input()) {
+      GMutablePointer value = this->get_value_from_socket(origin, type);
+      const std::optional<uint64_t> hash = cache_hash_value(value);
+      value.destruct();
+      return hash;
+    }
+    const DOutputSocket origin_output{origin};
+    if (const std::optional<uint64_t> *hash = input_value_hashes_.lookup_ptr(origin_output)) {
+      return *hash;
+    }
+    const DNode origin_node = origin.node();
+    const std::optional<uint64_t> &origin_hash = this->ensure_cache_hash(
+        origin_node, this->get_node_state(origin_node));
+    if (!origin_hash) {
+      return std::nullopt;
+    }
+    return cache_hash_combine(*origin_hash, origin->index());
+  }
+
+  /**
+   * Only the outputs of geometry nodes are cached. Multi-function nodes are cheap to compute, and
+   * nodes that support laziness might not compute all of their outputs.
+   */
+  bool node_uses_cache(const DNode node, const NodeState &node_state)
+  {
+    return params_.cache != nullptr && node_state.cache_hash.has_value() &&
+           !node_supports_laziness(node) &&
+           node->bnode()->typeinfo->geometry_node_execute != nullptr;
+  }
+
   void destruct_node_states()
   {
     threading::parallel_for(
@@ -645,8 +802,14 @@ class GeometryNodesEvaluator {
        * required and before we check that all required inputs are provided. This reduces the
        * number of "round-trips" through the task pool by one for most nodes. */
       if (!node_state.non_lazy_node_is_initialized && !node_supports_laziness(node)) {
-        this->initialize_non_lazy_node(locked_node);
         node_state.non_lazy_node_is_initialized = true;
+        /* When all outputs are cached, the inputs are not required and the nodes that compute
+         * them do not have to run at all. */
+        if (this->load_outputs_from_cache(locked_node)) {
+          do_execute_node = true;
+          return;
+        }
+        this->initialize_non_lazy_node(locked_node);
       }
       /* Prepare inputs and check if all required inputs are provided. */
       if (!this->prepare_node_inputs_for_execution(locked_node)) {
@@ -727,6 +890,35 @@ class GeometryNodesEvaluator {
     }
   }
 
+  bool load_outputs_from_cache(LockedNode &locked_node)
+  {
+    NodeState &node_state = locked_node.node_state;
+    if (!this->node_uses_cache(locked_node.node, node_state)) {
+      return false;
+    }
+    LinearAllocator<> &allocator = local_allocators_.local();
+    Vector<GMutablePointer> values(node_state.outputs.size());
+    for (const int i : node_state.outputs.index_range()) {
+      if (node_state.outputs[i].output_usage == ValueUsage::Unused) {
+        continue;
+      }
+      const CPPType &type = *get_socket_cpp_type(locked_node.node.output(i));
+      void *buffer = allocator.allocate(type.size(), type.alignment());
+      if (!params_.cache->lookup(this->cache_key(locked_node.node, node_state, i), type, buffer)) {
+        /* Only skip the node when all outputs are cached, otherwise it has to run anyway. */
+        for (GMutablePointer value : values) {
+          if (value.get() != nullptr) {
+            value.destruct();
+          }
+        }
+        return false;
+      }
+      values[i] = {type, buffer};
+    }
+    node_state.cached_output_values = std::move(values);
+    return true;
+  }
+
   /**
    * Checks if requested inputs are available and "marks" all the inputs that are available
    * during the node execution. Inputs that are provided after this function ends but before the
@@ -795,29 +987,43 @@ class GeometryNodesEvaluator {
     }
     node_state.has_been_executed = true;
 
-    /* Use the geometry node execute callback if it exists. */
-    if (bnode.typeinfo->geometry_node_execute != nullptr) {
-      this->execute_geometry_node(node, node_state);
+    if (!node_state.cached_output_values.is_empty()) {
+      this->forward_cached_outputs(node, node_state);
       return;
     }
 
+    const bool log_execution = bool(params_.log_node_execution_fn);
+    const timeit::TimePoint start_time = log_execution ? timeit::Clock::now() :
+                                                         timeit::TimePoint();
+    int64_t output_geometry_size = 0;
+
+    /* Use the geometry node execute callback if it exists. */
+    const MultiFunction *multi_function = nullptr;
+    if (bnode.typeinfo->geometry_node_execute != nullptr) {
+      output_geometry_size = this->execute_geometry_node(node, node_state);
+    }
     /* Use the multi-function implementation if it exists. */
-    const MultiFunction *multi_function = params_.mf_by_node->lookup_default(node, nullptr);
-    if (multi_function != nullptr) {
+    else if ((multi_function = params_.mf_by_node->lookup_default(node, nullptr))) {
       this->execute_multi_function_node(node, *multi_function, node_state);
-      return;
+    }
+    else {
+      this->execute_unknown_node(node, node_state);
     }
 
-    this->execute_unknown_node(node, node_state);
+    if (log_execution) {
+      params_.log_node_execution_fn(node, start_time, timeit::Clock::now(), output_geometry_size);
+    }
   }
 
-  void execute_geometry_node(const DNode node, NodeState &node_state)
+  /** Returns the number of points in the output geometries. */
+  int64_t execute_geometry_node(const DNode node, NodeState &node_state)
   {
     const bNode &bnode = *node->bnode();
 
     NodeParamsProvider params_provider{*this, node, node_state};
     GeoNodeExecParams params{params_provider};
     bnode.typeinfo->geometry_node_execute(params);
+    return params_provider.output_geometry_size;
   }
 
   void execute_multi_function_node(const DNode node,
@@ -872,6 +1078,20 @@ class GeometryNodesEvaluator {
     }
   }
 
+  void forward_cached_outputs(const DNode node, NodeState &node_state)
+  {
+    for (const int i : node_state.cached_output_values.index_range()) {
+      GMutablePointer value = node_state.cached_output_values[i];
+      if (value.get() == nullptr) {
+        continue;
+      }
+      OutputState &output_state = node_state.outputs[i];
+      output_state.has_been_computed = true;
+      this->forward_output(node.output(i), value);
+    }
+    node_state.cached_output_values.clear();
+  }
+
   void execute_unknown_node(const DNode node, NodeState &node_state)
   {
     LinearAllocator<> &allocator = local_allocators_.local();
@@ -1140,6 +1360,8 @@ class GeometryNodesEvaluator {
   {
     BLI_assert(value_to_forward.get() != nullptr);
 
+    this->add_output_to_cache(from_socket, value_to_forward);
+
     Vector<DInputSocket> to_sockets;
     auto handle_target_socket_fn = [&, this](const DInputSocket to_socket) {
       if (this->should_forward_to_socket(to_socket)) {
@@ -1171,6 +1393,27 @@ class GeometryNodesEvaluator {
         allocator, to_sockets_same_type, value_to_forward, from_socket);
   }
 
+  void add_output_to_cache(const DOutputSocket socket, const GPointer value)
+  {
+    if (params_.cache == nullptr) {
+      return;
+    }
+    const DNode node = socket.node();
+    const NodeWithState *node_with_state = node_states_.lookup_key_ptr_as(node);
+    if (node_with_state == nullptr) {
+      return;
+    }
+    const NodeState &node_state = *node_with_state->state;
+    if (!this->node_uses_cache(node, node_state)) {
+      return;
+    }
+    if (!node_state.cached_output_values.is_empty()) {
+      /* The value comes from the cache already. */
+      return;
+    }
+    params_.cache->add(this->cache_key(node, node_state, socket->index()), value);
+  }
+
   bool should_forward_to_socket(const DInputSocket socket)
   {
     const DNode to_node = socket.node();
@@ -1351,6 +1594,9 @@ class GeometryNodesEvaluator {
                         InputState &input_state,
                         Span<MultiInputValueItem> values)
   {
+    if (!params_.log_socket_value_fn) {
+      return;
+    }
     Vector<GPointer, 16> value_pointers;
     value_pointers.reserve(values.size());
     const CPPType &type = *input_state.type;
@@ -1495,6 +1741,17 @@ GMutablePointer NodeParamsProvider::alloc_output_value(const CPPType &type)
   return {type, allocator.allocate(type.size(), type.alignment())};
 }
 
+static int64_t geometry_set_points_num(const GeometrySet &geometry_set)
+{
+  int64_t points_num = 0;
+  for (const GeometryComponent *component : geometry_set.get_components_for_read()) {
+    if (component->attribute_domain_supported(ATTR_DOMAIN_POINT)) {
+      points_num += component->attribute_domain_size(ATTR_DOMAIN_POINT);
+    }
+  }
+  return points_num;
+}
+
 void NodeParamsProvider::set_output(StringRef identifier, GMutablePointer value)
 {
   const DOutputSocket socket = this->dnode.output_by_identifier(identifier);
@@ -1502,6 +1759,11 @@ void NodeParamsProvider::set_output(StringRef identifier, GMutablePointer value)
 
   evaluator_.log_socket_value(socket, value);
 
+  /* Counting points is only worth it when node executions are logged. */
+  if (evaluator_.params_.log_node_execution_fn && value.type()->is<GeometrySet>()) {
+    output_geometry_size += geometry_set_points_num(*value.get<GeometrySet>());
+  }
+
   OutputState &output_state = node_state_.outputs[socket->index()];
   BLI_assert(!output_state.has_been_computed);
   evaluator_.forward_output(socket, value);
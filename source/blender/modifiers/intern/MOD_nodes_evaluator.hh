@@ -17,6 +17,7 @@
 #pragma once
 
 #include "BLI_map.hh"
+#include "BLI_timeit.hh"
 
 #include "NOD_derived_node_tree.hh"
 #include "NOD_node_tree_multi_function.hh"
@@ -25,6 +26,8 @@
 
 #include "DNA_modifier_types.h"
 
+#include "MOD_nodes_cache.hh"
+
 namespace blender::modifiers::geometry_nodes {
 
 using namespace nodes::derived_node_tree_types;
@@ -32,6 +35,12 @@ using fn::GMutablePointer;
 using fn::GPointer;
 
 using LogSocketValueFn = std::function<void(DSocket, Span<GPointer>)>;
+/**
+ * Called after every execution of a node with its start and end time and the number of points
+ * in the geometries it outputs. This is called from the thread that executed the node.
+ */
+using LogNodeExecutionFn = std::function<void(
+    DNode, timeit::TimePoint start, timeit::TimePoint end, int64_t output_geometry_size)>;
 
 struct GeometryNodesEvaluationParams {
   blender::LinearAllocator<> allocator;
@@ -43,6 +52,10 @@ struct GeometryNodesEvaluationParams {
   Depsgraph *depsgraph;
   Object *self_object;
   LogSocketValueFn log_socket_value_fn;
+  /** Optional, for profiling the evaluation. */
+  LogNodeExecutionFn log_node_execution_fn;
+  /** Optional cache of node outputs that is shared between evaluations of the same modifier. */
+  GeometryNodesCache *cache = nullptr;
 
   Vector<GMutablePointer> r_output_values;
 };
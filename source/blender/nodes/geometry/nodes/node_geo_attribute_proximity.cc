@@ -70,57 +70,55 @@ static void proximity_calc(MutableSpan<float> distance_span,
                            const bool store_distances,
                            const bool store_locations)
 {
-  IndexRange range = positions.index_range();
-  threading::parallel_for(range, 512, [&](IndexRange range) {
-    BVHTreeNearest nearest_from_mesh;
-    BVHTreeNearest nearest_from_pointcloud;
-
-    copy_v3_fl(nearest_from_mesh.co, FLT_MAX);
-    copy_v3_fl(nearest_from_pointcloud.co, FLT_MAX);
-
-    nearest_from_mesh.index = -1;
-    nearest_from_pointcloud.index = -1;
-
-    for (int i : range) {
-      /* Use the distance to the last found point as upper bound to speedup the bvh lookup. */
-      nearest_from_mesh.dist_sq = len_squared_v3v3(nearest_from_mesh.co, positions[i]);
-
-      if (bvh_mesh_success) {
-        BLI_bvhtree_find_nearest(tree_data_mesh.tree,
-                                 positions[i],
-                                 &nearest_from_mesh,
-                                 tree_data_mesh.nearest_callback,
-                                 &tree_data_mesh);
-      }
+  VArray_Span<float3> positions_span{positions};
+  const float(*positions_co)[3] = reinterpret_cast<const float(*)[3]>(positions_span.data());
+
+  Array<BVHTreeNearest> nearest_from_mesh(positions.size());
+  for (BVHTreeNearest &nearest : nearest_from_mesh) {
+    nearest.index = -1;
+    nearest.dist_sq = FLT_MAX;
+    copy_v3_fl(nearest.co, FLT_MAX);
+  }
+  if (bvh_mesh_success) {
+    BLI_bvhtree_find_nearest_batch(tree_data_mesh.tree,
+                                   positions_co,
+                                   positions.size(),
+                                   nearest_from_mesh.data(),
+                                   tree_data_mesh.nearest_callback,
+                                   &tree_data_mesh,
+                                   0);
+  }
 
-      /* Use the distance to the closest point in the mesh to speedup the pointcloud bvh lookup.
-       * This is ok because we only need to find the closest point in the pointcloud if it's closer
-       * than the mesh. */
-      nearest_from_pointcloud.dist_sq = nearest_from_mesh.dist_sq;
-
-      if (bvh_pointcloud_success) {
-        BLI_bvhtree_find_nearest(tree_data_pointcloud.tree,
-                                 positions[i],
-                                 &nearest_from_pointcloud,
-                                 tree_data_pointcloud.nearest_callback,
-                                 &tree_data_pointcloud);
-      }
+  Array<BVHTreeNearest> nearest_from_pointcloud;
+  if (bvh_pointcloud_success) {
+    /* Use the distance to the closest point in the mesh to speedup the pointcloud bvh lookup.
+     * This is ok because we only need to find the closest point in the pointcloud if it's closer
+     * than the mesh. */
+    nearest_from_pointcloud.reinitialize(positions.size());
+    for (const int i : positions.index_range()) {
+      nearest_from_pointcloud[i].index = -1;
+      nearest_from_pointcloud[i].dist_sq = nearest_from_mesh[i].dist_sq;
+    }
+    BLI_bvhtree_find_nearest_batch(tree_data_pointcloud.tree,
+                                   positions_co,
+                                   positions.size(),
+                                   nearest_from_pointcloud.data(),
+                                   tree_data_pointcloud.nearest_callback,
+                                   &tree_data_pointcloud,
+                                   0);
+  }
 
-      if (nearest_from_pointcloud.dist_sq < nearest_from_mesh.dist_sq) {
-        if (store_distances) {
-          distance_span[i] = sqrtf(nearest_from_pointcloud.dist_sq);
-        }
-        if (store_locations) {
-          location_span[i] = nearest_from_pointcloud.co;
-        }
+  threading::parallel_for(positions.index_range(), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      const BVHTreeNearest &nearest = (bvh_pointcloud_success &&
+                                       nearest_from_pointcloud[i].index != -1) ?
+                                          nearest_from_pointcloud[i] :
+                                          nearest_from_mesh[i];
+      if (store_distances) {
+        distance_span[i] = sqrtf(nearest.dist_sq);
       }
-      else {
-        if (store_distances) {
-          distance_span[i] = sqrtf(nearest_from_mesh.dist_sq);
-        }
-        if (store_locations) {
-          location_span[i] = nearest_from_mesh.co;
-        }
+      if (store_locations) {
+        location_span[i] = nearest.co;
       }
     }
   });
@@ -15,6 +15,7 @@
  */
 
 #include "BLI_kdopbvh.h"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
@@ -102,7 +103,9 @@ static void get_result_domain_and_data_type(const GeometrySet &src_geometry,
   }
 }
 
-static void get_closest_in_bvhtree(BVHTreeFromMesh &tree_data,
+static void get_closest_in_bvhtree(BVHTree *tree,
+                                   BVHTree_NearestPointCallback callback,
+                                   void *userdata,
                                    const VArray<float3> &positions,
                                    const MutableSpan<int> r_indices,
                                    const MutableSpan<float> r_distances_sq,
@@ -112,22 +115,48 @@ static void get_closest_in_bvhtree(BVHTreeFromMesh &tree_data,
   BLI_assert(positions.size() == r_distances_sq.size() || r_distances_sq.is_empty());
   BLI_assert(positions.size() == r_positions.size() || r_positions.is_empty());
 
-  for (const int i : positions.index_range()) {
-    BVHTreeNearest nearest;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
-    if (!r_indices.is_empty()) {
-      r_indices[i] = nearest.index;
-    }
-    if (!r_distances_sq.is_empty()) {
-      r_distances_sq[i] = nearest.dist_sq;
-    }
-    if (!r_positions.is_empty()) {
-      r_positions[i] = nearest.co;
-    }
+  VArray_Span<float3> positions_span{positions};
+  Array<BVHTreeNearest> nearest(positions.size());
+  for (BVHTreeNearest &item : nearest) {
+    item.index = -1;
+    item.dist_sq = FLT_MAX;
   }
+  BLI_bvhtree_find_nearest_batch(tree,
+                                 reinterpret_cast<const float(*)[3]>(positions_span.data()),
+                                 positions.size(),
+                                 nearest.data(),
+                                 callback,
+                                 userdata,
+                                 0);
+
+  threading::parallel_for(positions.index_range(), 2048, [&](IndexRange range) {
+    for (const int i : range) {
+      if (!r_indices.is_empty()) {
+        r_indices[i] = nearest[i].index;
+      }
+      if (!r_distances_sq.is_empty()) {
+        r_distances_sq[i] = nearest[i].dist_sq;
+      }
+      if (!r_positions.is_empty()) {
+        r_positions[i] = nearest[i].co;
+      }
+    }
+  });
+}
+
+static void get_closest_in_bvhtree(BVHTreeFromMesh &tree_data,
+                                   const VArray<float3> &positions,
+                                   const MutableSpan<int> r_indices,
+                                   const MutableSpan<float> r_distances_sq,
+                                   const MutableSpan<float3> r_positions)
+{
+  get_closest_in_bvhtree(tree_data.tree,
+                         tree_data.nearest_callback,
+                         &tree_data,
+                         positions,
+                         r_indices,
+                         r_distances_sq,
+                         r_positions);
 }
 
 static void get_closest_pointcloud_points(const PointCloud &pointcloud,
@@ -140,17 +169,13 @@ static void get_closest_pointcloud_points(const PointCloud &pointcloud,
 
   BVHTreeFromPointCloud tree_data;
   BKE_bvhtree_from_pointcloud_get(&tree_data, &pointcloud, 2);
-
-  for (const int i : positions.index_range()) {
-    BVHTreeNearest nearest;
-    nearest.dist_sq = FLT_MAX;
-    const float3 position = positions[i];
-    BLI_bvhtree_find_nearest(
-        tree_data.tree, position, &nearest, tree_data.nearest_callback, &tree_data);
-    r_indices[i] = nearest.index;
-    r_distances_sq[i] = nearest.dist_sq;
-  }
-
+  get_closest_in_bvhtree(tree_data.tree,
+                         tree_data.nearest_callback,
+                         &tree_data,
+                         positions,
+                         r_indices,
+                         r_distances_sq,
+                         {});
   free_bvhtree_from_pointcloud(&tree_data);
 }
 
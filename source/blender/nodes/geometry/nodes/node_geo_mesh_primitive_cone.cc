@@ -14,6 +14,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_task.hh"
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 
@@ -275,6 +277,50 @@ static void calculate_uvs(Mesh *mesh,
   uv_attribute.save();
 }
 
+/**
+ * The normal of a vertex on the top or bottom ring, as the angle weighted average of the normals
+ * of the faces around it. Because the cone is rotationally symmetric, the two side faces around
+ * the vertex have the same corner angle and their sum points in the direction of the smooth
+ * surface normal. The caps add the same corner angle at every ring vertex.
+ *
+ * \param side: 1 for the top ring and -1 for the bottom ring.
+ */
+static float3 ring_vert_normal(const float angle,
+                               const float angle_delta,
+                               const float radius,
+                               const float other_radius,
+                               const float depth,
+                               const float side,
+                               const bool has_cap)
+{
+  const float x = std::cos(angle);
+  const float y = std::sin(angle);
+  const float3 side_normal = float3(x * depth, y * depth, side * (other_radius - radius));
+  if (!has_cap) {
+    return side_normal.normalized();
+  }
+
+  /* The side faces are flat, so the slope of their normals depends on the distance of the middle
+   * of their ring edge to the axis. This is the sum of the two unit face normals. */
+  const float half_angle_cos = std::cos(angle_delta * 0.5f);
+  const float side_face_normal_len = std::sqrt(
+      square_f(depth) + square_f((other_radius - radius) * half_angle_cos));
+  const float3 side_faces_normal = (side_face_normal_len == 0.0f) ?
+                                       float3(0.0f) :
+                                       side_normal * (2.0f * half_angle_cos /
+                                                      side_face_normal_len);
+
+  const float3 ring_edge = float3(radius * (std::cos(angle_delta) - 1.0f),
+                                  radius * std::sin(angle_delta),
+                                  0.0f);
+  const float3 side_edge = float3(other_radius - radius, 0.0f, -side * depth);
+  const float side_angle = angle_v3v3(ring_edge, side_edge);
+  const float cap_angle = M_PI - angle_delta;
+
+  const float3 normal = side_faces_normal * side_angle + float3(0.0f, 0.0f, side * cap_angle);
+  return normal.normalized();
+}
+
 Mesh *create_cylinder_or_cone_mesh(const float radius_top,
                                    const float radius_bottom,
                                    const float depth,
@@ -299,7 +345,10 @@ Mesh *create_cylinder_or_cone_mesh(const float radius_top,
     mesh->medge[0].v1 = 0;
     mesh->medge[0].v2 = 1;
     mesh->medge[0].flag |= ME_LOOSEEDGE;
-    BKE_mesh_calc_normals(mesh);
+    /* Normals of loose vertices point away from the origin. */
+    const float up = (height > 0.0f) ? 1.0f : -1.0f;
+    normal_float_to_short_v3(mesh->mvert[0].no, float3(0.0f, 0.0f, up));
+    normal_float_to_short_v3(mesh->mvert[1].no, float3(0.0f, 0.0f, -up));
     return mesh;
   }
 
@@ -315,28 +364,40 @@ Mesh *create_cylinder_or_cone_mesh(const float radius_top,
   MutableSpan<MEdge> edges{mesh->medge, mesh->totedge};
   MutableSpan<MPoly> polys{mesh->mpoly, mesh->totpoly};
 
-  /* Calculate vertex positions. */
+  /* Calculate vertex positions and normals. */
   const int top_verts_start = 0;
   const int bottom_verts_start = top_verts_start + (!top_is_point ? verts_num : 1);
-  float angle = 0.0f;
   const float angle_delta = 2.0f * M_PI / static_cast<float>(verts_num);
-  for (const int i : IndexRange(verts_num)) {
-    const float x = std::cos(angle);
-    const float y = std::sin(angle);
-    if (!top_is_point) {
-      copy_v3_v3(verts[top_verts_start + i].co, float3(x * radius_top, y * radius_top, height));
-    }
-    if (!bottom_is_point) {
-      copy_v3_v3(verts[bottom_verts_start + i].co,
-                 float3(x * radius_bottom, y * radius_bottom, -height));
+  const bool has_caps = fill_type != GEO_NODE_MESH_CIRCLE_FILL_NONE;
+  threading::parallel_for(IndexRange(verts_num), 512, [&](IndexRange range) {
+    for (const int i : range) {
+      const float angle = angle_delta * i;
+      const float x = std::cos(angle);
+      const float y = std::sin(angle);
+      if (!top_is_point) {
+        MVert &vert = verts[top_verts_start + i];
+        copy_v3_v3(vert.co, float3(x * radius_top, y * radius_top, height));
+        const float3 normal = ring_vert_normal(
+            angle, angle_delta, radius_top, radius_bottom, depth, 1.0f, has_caps);
+        normal_float_to_short_v3(vert.no, normal);
+      }
+      if (!bottom_is_point) {
+        MVert &vert = verts[bottom_verts_start + i];
+        copy_v3_v3(vert.co, float3(x * radius_bottom, y * radius_bottom, -height));
+        const float3 normal = ring_vert_normal(
+            angle, angle_delta, radius_bottom, radius_top, depth, -1.0f, has_caps);
+        normal_float_to_short_v3(vert.no, normal);
+      }
     }
-    angle += angle_delta;
-  }
+  });
+  /* The side faces around the points are symmetric, so their normals point along the axis. */
   if (top_is_point) {
     copy_v3_v3(verts[top_verts_start].co, float3(0.0f, 0.0f, height));
+    normal_float_to_short_v3(verts[top_verts_start].no, float3(0.0f, 0.0f, 1.0f));
   }
   if (bottom_is_point) {
     copy_v3_v3(verts[bottom_verts_start].co, float3(0.0f, 0.0f, -height));
+    normal_float_to_short_v3(verts[bottom_verts_start].no, float3(0.0f, 0.0f, -1.0f));
   }
 
   /* Add center vertices for the triangle fans at the end. */
@@ -345,9 +406,11 @@ Mesh *create_cylinder_or_cone_mesh(const float radius_top,
   if (fill_type == GEO_NODE_MESH_CIRCLE_FILL_TRIANGLE_FAN) {
     if (!top_is_point) {
       copy_v3_v3(verts[top_center_vert_index].co, float3(0.0f, 0.0f, height));
+      normal_float_to_short_v3(verts[top_center_vert_index].no, float3(0.0f, 0.0f, 1.0f));
     }
     if (!bottom_is_point) {
       copy_v3_v3(verts[bottom_center_vert_index].co, float3(0.0f, 0.0f, -height));
+      normal_float_to_short_v3(verts[bottom_center_vert_index].no, float3(0.0f, 0.0f, -1.0f));
     }
   }
 
@@ -534,8 +597,6 @@ Mesh *create_cylinder_or_cone_mesh(const float radius_top,
     }
   }
 
-  BKE_mesh_calc_normals(mesh);
-
   calculate_uvs(mesh, top_is_point, bottom_is_point, verts_num, fill_type);
 
   BLI_assert(BKE_mesh_is_valid(mesh));
@@ -14,7 +14,12 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include <array>
+
+#include "BLI_task.hh"
+
 #include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 
 #include "BKE_lib_id.h"
 #include "BKE_material.h"
@@ -37,7 +42,348 @@ static bNodeSocketTemplate geo_node_mesh_primitive_ico_sphere_out[] = {
 
 namespace blender::nodes {
 
+/* Set on nodes added after the parallel builder, nodes from older files keep building the sphere
+ * with BMesh, because the vertex order and the positions of the vertices are different. */
+#define GEO_NODE_ICO_SPHERE_PARALLEL_BUILD 1
+
+/**
+ * Every face of the icosahedron is subdivided into a triangular grid with #segments edges along
+ * each side. A grid point is identified by its face and its coordinates `(i, j)` with
+ * `i + j <= segments`, where `i` goes along the first side of the face and `j` along the third.
+ *
+ * Vertices and edges on the sides of the faces are shared with the neighboring faces, so they are
+ * stored per edge of the icosahedron. The remaining elements are stored per face. This gives every
+ * element a fixed index, so that the mesh arrays can be filled in parallel.
+ */
+class IcoSphereTopology {
+ public:
+  const int segments;
+  const int face_verts_num;
+  const int face_edges_num;
+  const int face_polys_num;
+
+  const int edge_verts_start = 12;
+  const int face_verts_start;
+  const int face_edges_start;
+
+  /* The vertices of the 30 icosahedron edges, and for every face side the index of the edge and
+   * whether the side goes in the opposite direction of the edge. */
+  std::array<std::array<int, 2>, 30> base_edges;
+  std::array<std::array<int, 3>, 20> face_sides;
+  std::array<std::array<bool, 3>, 20> face_sides_flipped;
+
+  IcoSphereTopology(const int segments)
+      : segments(segments),
+        face_verts_num((segments - 1) * (segments - 2) / 2),
+        face_edges_num(3 * segments * (segments - 1) / 2),
+        face_polys_num(segments * segments),
+        face_verts_start(12 + 30 * (segments - 1)),
+        face_edges_start(30 * segments)
+  {
+    int edge_by_verts[12][12];
+    for (const int v : IndexRange(12)) {
+      std::fill_n(edge_by_verts[v], 12, -1);
+    }
+    int base_edges_num = 0;
+    for (const int face : IndexRange(20)) {
+      for (const int side : IndexRange(3)) {
+        const int v1 = BM_icosphere_faces[face][side];
+        const int v2 = BM_icosphere_faces[face][(side + 1) % 3];
+        if (edge_by_verts[v1][v2] == -1) {
+          base_edges[base_edges_num] = {v1, v2};
+          edge_by_verts[v1][v2] = edge_by_verts[v2][v1] = base_edges_num++;
+        }
+        const int edge = edge_by_verts[v1][v2];
+        face_sides[face][side] = edge;
+        face_sides_flipped[face][side] = base_edges[edge][0] != v1;
+      }
+    }
+    BLI_assert(base_edges_num == 30);
+  }
+
+  int verts_num() const
+  {
+    return face_verts_start + 20 * face_verts_num;
+  }
+
+  int edges_num() const
+  {
+    return face_edges_start + 20 * face_edges_num;
+  }
+
+  int polys_num() const
+  {
+    return 20 * face_polys_num;
+  }
+
+  /** The vertex at the position `t` along an edge of the icosahedron, from its first vertex. */
+  int base_edge_vert(const int edge, const int t) const
+  {
+    if (t == 0) {
+      return base_edges[edge][0];
+    }
+    if (t == segments) {
+      return base_edges[edge][1];
+    }
+    return edge_verts_start + edge * (segments - 1) + t - 1;
+  }
+
+  int side_vert(const int face, const int side, const int t) const
+  {
+    const int edge = face_sides[face][side];
+    return base_edge_vert(edge, face_sides_flipped[face][side] ? segments - t : t);
+  }
+
+  /** The edge between the positions `t` and `t + 1` along a side of a face. */
+  int side_edge(const int face, const int side, const int t) const
+  {
+    const int edge = face_sides[face][side];
+    return edge * segments + (face_sides_flipped[face][side] ? segments - 1 - t : t);
+  }
+
+  int vert(const int face, const int i, const int j) const
+  {
+    if (j == 0) {
+      return side_vert(face, 0, i);
+    }
+    if (i + j == segments) {
+      return side_vert(face, 1, j);
+    }
+    if (i == 0) {
+      return side_vert(face, 2, segments - j);
+    }
+    return face_verts_start + face * face_verts_num + row_offset(segments - 2, j - 1) + i - 1;
+  }
+
+  /** The edge from `(i, j)` to `(i + 1, j)`. */
+  int edge_i(const int face, const int i, const int j) const
+  {
+    if (j == 0) {
+      return side_edge(face, 0, i);
+    }
+    return face_edges_start + face * face_edges_num + row_offset(segments - 1, j - 1) + i;
+  }
+
+  /** The edge from `(i, j)` to `(i, j + 1)`. */
+  int edge_j(const int face, const int i, const int j) const
+  {
+    if (i == 0) {
+      return side_edge(face, 2, segments - 1 - j);
+    }
+    return face_edges_start + face * face_edges_num + face_edges_num / 3 +
+           row_offset(segments - 1, i - 1) + j;
+  }
+
+  /** The edge from `(i + 1, j)` to `(i, j + 1)`. */
+  int edge_diagonal(const int face, const int i, const int j) const
+  {
+    if (i + j + 1 == segments) {
+      return side_edge(face, 1, j);
+    }
+    return face_edges_start + face * face_edges_num + face_edges_num / 3 * 2 +
+           row_offset(segments - 1, j) + i;
+  }
+
+  /** The first triangle in the row `j` of a face, every row has `2 * (segments - j) - 1`. */
+  int poly(const int face, const int j) const
+  {
+    return face * face_polys_num + j * (2 * segments - j);
+  }
+
+ private:
+  /**
+   * The number of elements in the rows before `row`, if the first row has `first_row_size`
+   * elements and every next row has one less.
+   */
+  static int row_offset(const int first_row_size, const int row)
+  {
+    return row * first_row_size - row * (row - 1) / 2;
+  }
+};
+
+static void calculate_ico_sphere_verts(const IcoSphereTopology &topology,
+                                       const Span<float3> corners,
+                                       const float radius,
+                                       MutableSpan<MVert> verts)
+{
+  const int segments = topology.segments;
+  /* The normals on a sphere are the normalized positions. */
+  auto set_vert = [&](const int index, const float3 &position) {
+    const float3 normal = position.normalized();
+    copy_v3_v3(verts[index].co, normal * radius);
+    normal_float_to_short_v3(verts[index].no, normal);
+  };
+
+  for (const int corner : IndexRange(12)) {
+    set_vert(corner, corners[corner]);
+  }
+
+  threading::parallel_for(IndexRange(30), 1, [&](IndexRange range) {
+    for (const int edge : range) {
+      const float3 &v1 = corners[topology.base_edges[edge][0]];
+      const float3 &v2 = corners[topology.base_edges[edge][1]];
+      for (const int t : IndexRange(1, segments - 1)) {
+        set_vert(topology.base_edge_vert(edge, t),
+                 float3::interpolate(v1, v2, float(t) / segments));
+      }
+    }
+  });
+
+  /* Every row of every face is a separate task, to use more threads than there are faces. */
+  threading::parallel_for(IndexRange(20 * segments), 32, [&](IndexRange range) {
+    for (const int face_row : range) {
+      const int face = face_row / segments;
+      const int j = face_row % segments;
+      if (j == 0) {
+        /* The first row is on a side of the face. */
+        continue;
+      }
+      const float3 &a = corners[BM_icosphere_faces[face][0]];
+      const float3 &b = corners[BM_icosphere_faces[face][1]];
+      const float3 &c = corners[BM_icosphere_faces[face][2]];
+      for (const int i : IndexRange(1, segments - 1 - j)) {
+        set_vert(topology.vert(face, i, j),
+                 (a * float(segments - i - j) + b * float(i) + c * float(j)) / float(segments));
+      }
+    }
+  });
+}
+
+static void calculate_ico_sphere_edges(const IcoSphereTopology &topology, MutableSpan<MEdge> edges)
+{
+  const int segments = topology.segments;
+  auto set_edge = [&](const int index, const int v1, const int v2) {
+    MEdge &edge = edges[index];
+    edge.v1 = v1;
+    edge.v2 = v2;
+    edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
+  };
+
+  threading::parallel_for(IndexRange(30), 1, [&](IndexRange range) {
+    for (const int edge : range) {
+      for (const int t : IndexRange(segments)) {
+        set_edge(edge * segments + t,
+                 topology.base_edge_vert(edge, t),
+                 topology.base_edge_vert(edge, t + 1));
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(20 * segments), 32, [&](IndexRange range) {
+    for (const int face_row : range) {
+      const int face = face_row / segments;
+      const int j = face_row % segments;
+      for (const int i : IndexRange(segments - j)) {
+        /* The edges on the sides of the face are added above. */
+        if (j > 0) {
+          set_edge(topology.edge_i(face, i, j),
+                   topology.vert(face, i, j),
+                   topology.vert(face, i + 1, j));
+        }
+        if (i > 0) {
+          set_edge(topology.edge_j(face, i, j),
+                   topology.vert(face, i, j),
+                   topology.vert(face, i, j + 1));
+        }
+        if (i + j + 1 < segments) {
+          set_edge(topology.edge_diagonal(face, i, j),
+                   topology.vert(face, i + 1, j),
+                   topology.vert(face, i, j + 1));
+        }
+      }
+    }
+  });
+}
+
+static void calculate_ico_sphere_faces(const IcoSphereTopology &topology,
+                                       MutableSpan<MLoop> loops,
+                                       MutableSpan<MPoly> polys,
+                                       MutableSpan<float2> uvs)
+{
+  const int segments = topology.segments;
+  threading::parallel_for(IndexRange(20 * segments), 32, [&](IndexRange range) {
+    for (const int face_row : range) {
+      const int face = face_row / segments;
+      const int j = face_row % segments;
+      /* The BMesh operator stores the UVs of the icosahedron per face corner. */
+      const float2 uv_a = BM_icosphere_uvs[face * 3 + 0];
+      const float2 uv_b = BM_icosphere_uvs[face * 3 + 1];
+      const float2 uv_c = BM_icosphere_uvs[face * 3 + 2];
+
+      int poly_index = topology.poly(face, j);
+      auto add_triangle = [&](const std::array<int, 3> &is,
+                              const std::array<int, 3> &js,
+                              const std::array<int, 3> &edges) {
+        const int loop_index = poly_index * 3;
+        MPoly &poly = polys[poly_index++];
+        poly.loopstart = loop_index;
+        poly.totloop = 3;
+        for (const int corner : IndexRange(3)) {
+          const int i = is[corner];
+          const int j = js[corner];
+          MLoop &loop = loops[loop_index + corner];
+          loop.v = topology.vert(face, i, j);
+          loop.e = edges[corner];
+          uvs[loop_index + corner] = (uv_a * float(segments - i - j) + uv_b * float(i) +
+                                      uv_c * float(j)) /
+                                     float(segments);
+        }
+      };
+
+      for (const int i : IndexRange(segments - j)) {
+        add_triangle({i, i + 1, i},
+                     {j, j, j + 1},
+                     {topology.edge_i(face, i, j),
+                      topology.edge_diagonal(face, i, j),
+                      topology.edge_j(face, i, j)});
+        if (i + j + 1 < segments) {
+          add_triangle({i + 1, i + 1, i},
+                       {j, j + 1, j + 1},
+                       {topology.edge_j(face, i + 1, j),
+                        topology.edge_i(face, i, j + 1),
+                        topology.edge_diagonal(face, i, j)});
+        }
+      }
+    }
+  });
+}
+
 static Mesh *create_ico_sphere_mesh(const int subdivisions, const float radius)
+{
+  const IcoSphereTopology topology(1 << (std::max(subdivisions, 1) - 1));
+
+  Mesh *mesh = BKE_mesh_new_nomain(topology.verts_num(),
+                                   topology.edges_num(),
+                                   0,
+                                   topology.polys_num() * 3,
+                                   topology.polys_num());
+  BKE_id_material_eval_ensure_default_slot(&mesh->id);
+  MutableSpan<MVert> verts{mesh->mvert, mesh->totvert};
+  MutableSpan<MLoop> loops{mesh->mloop, mesh->totloop};
+  MutableSpan<MEdge> edges{mesh->medge, mesh->totedge};
+  MutableSpan<MPoly> polys{mesh->mpoly, mesh->totpoly};
+
+  std::array<float3, 12> corners;
+  for (const int corner : IndexRange(12)) {
+    corners[corner] = float3(BM_icosphere_verts[corner]).normalized();
+  }
+
+  calculate_ico_sphere_verts(topology, corners, std::abs(radius), verts);
+  calculate_ico_sphere_edges(topology, edges);
+
+  MeshComponent mesh_component;
+  mesh_component.replace(mesh, GeometryOwnershipType::Editable);
+  OutputAttribute_Typed<float2> uv_attribute =
+      mesh_component.attribute_try_get_for_output_only<float2>("uv_map", ATTR_DOMAIN_CORNER);
+  calculate_ico_sphere_faces(topology, loops, polys, uv_attribute.as_span());
+  uv_attribute.save();
+
+  BLI_assert(BKE_mesh_is_valid(mesh));
+
+  return mesh;
+}
+
+static Mesh *create_ico_sphere_mesh_bmesh(const int subdivisions, const float radius)
 {
   const float4x4 transform = float4x4::identity();
 
@@ -64,12 +410,19 @@ static Mesh *create_ico_sphere_mesh(const int subdivisions, const float radius)
   return mesh;
 }
 
+static void geo_node_mesh_primitive_ico_sphere_init(bNodeTree *UNUSED(ntree), bNode *node)
+{
+  node->custom1 = GEO_NODE_ICO_SPHERE_PARALLEL_BUILD;
+}
+
 static void geo_node_mesh_primitive_ico_sphere_exec(GeoNodeExecParams params)
 {
   const int subdivisions = std::min(params.extract_input<int>("Subdivisions"), 10);
   const float radius = params.extract_input<float>("Radius");
 
-  Mesh *mesh = create_ico_sphere_mesh(subdivisions, radius);
+  Mesh *mesh = (params.node().custom1 & GEO_NODE_ICO_SPHERE_PARALLEL_BUILD) ?
+                   create_ico_sphere_mesh(subdivisions, radius) :
+                   create_ico_sphere_mesh_bmesh(subdivisions, radius);
   params.set_output("Geometry", GeometrySet::create_with_mesh(mesh));
 }
 
@@ -83,6 +436,7 @@ void register_node_type_geo_mesh_primitive_ico_sphere()
       &ntype, GEO_NODE_MESH_PRIMITIVE_ICO_SPHERE, "Ico Sphere", NODE_CLASS_GEOMETRY, 0);
   node_type_socket_templates(
       &ntype, geo_node_mesh_primitive_ico_sphere_in, geo_node_mesh_primitive_ico_sphere_out);
+  node_type_init(&ntype, blender::nodes::geo_node_mesh_primitive_ico_sphere_init);
   ntype.geometry_node_execute = blender::nodes::geo_node_mesh_primitive_ico_sphere_exec;
   nodeRegisterType(&ntype);
 }
@@ -14,6 +14,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BLI_task.hh"
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 
@@ -63,6 +65,15 @@ static int sphere_face_total(const int segments, const int rings)
   return quads + triangles;
 }
 
+/**
+ * The rings are the unit of parallelism below, every element has a fixed index that can be
+ * computed from its ring and segment, so rings don't depend on each other.
+ */
+static int64_t ring_grain_size(const int segments)
+{
+  return std::max(1, 1024 / segments);
+}
+
 static void calculate_sphere_vertex_data(MutableSpan<MVert> verts,
                                          const float radius,
                                          const int segments,
@@ -74,22 +85,23 @@ static void calculate_sphere_vertex_data(MutableSpan<MVert> verts,
   copy_v3_v3(verts[0].co, float3(0.0f, 0.0f, radius));
   normal_float_to_short_v3(verts[0].no, float3(0.0f, 0.0f, 1.0f));
 
-  int vert_index = 1;
-  float theta = delta_theta;
-  for (const int UNUSED(ring) : IndexRange(rings - 1)) {
-    float phi = 0.0f;
-    const float z = cosf(theta);
-    for (const int UNUSED(segment) : IndexRange(segments)) {
+  /* The normals on a sphere are the normalized positions. */
+  threading::parallel_for(IndexRange(rings - 1), ring_grain_size(segments), [&](IndexRange range) {
+    for (const int ring : range) {
+      const float theta = delta_theta * (ring + 1);
       const float sin_theta = std::sin(theta);
-      const float x = sin_theta * std::cos(phi);
-      const float y = sin_theta * std::sin(phi);
-      copy_v3_v3(verts[vert_index].co, float3(x, y, z) * radius);
-      normal_float_to_short_v3(verts[vert_index].no, float3(x, y, z));
-      phi += delta_phi;
-      vert_index++;
+      const float z = std::cos(theta);
+      const int ring_vert_index_start = 1 + ring * segments;
+      for (const int segment : IndexRange(segments)) {
+        const float phi = delta_phi * segment;
+        const float x = sin_theta * std::cos(phi);
+        const float y = sin_theta * std::sin(phi);
+        MVert &vert = verts[ring_vert_index_start + segment];
+        copy_v3_v3(vert.co, float3(x, y, z) * radius);
+        normal_float_to_short_v3(vert.no, float3(x, y, z));
+      }
     }
-    theta += delta_theta;
-  }
+  });
 
   copy_v3_v3(verts.last().co, float3(0.0f, 0.0f, -radius));
   normal_float_to_short_v3(verts.last().no, float3(0.0f, 0.0f, -1.0f));
@@ -99,46 +111,47 @@ static void calculate_sphere_edge_indices(MutableSpan<MEdge> edges,
                                           const int segments,
                                           const int rings)
 {
-  int edge_index = 0;
-
   /* Add the edges connecting the top vertex to the first ring. */
   const int first_vert_ring_index_start = 1;
   for (const int segment : IndexRange(segments)) {
-    MEdge &edge = edges[edge_index++];
+    MEdge &edge = edges[segment];
     edge.v1 = 0;
     edge.v2 = first_vert_ring_index_start + segment;
     edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
   }
 
-  int ring_vert_index_start = 1;
-  for (const int ring : IndexRange(rings - 1)) {
-    const int next_ring_vert_index_start = ring_vert_index_start + segments;
-
-    /* Add the edges running along each ring. */
-    for (const int segment : IndexRange(segments)) {
-      MEdge &edge = edges[edge_index++];
-      edge.v1 = ring_vert_index_start + segment;
-      edge.v2 = ring_vert_index_start + ((segment + 1) % segments);
-      edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
-    }
+  threading::parallel_for(IndexRange(rings - 1), ring_grain_size(segments), [&](IndexRange range) {
+    for (const int ring : range) {
+      const int ring_vert_index_start = 1 + ring * segments;
+      const int next_ring_vert_index_start = ring_vert_index_start + segments;
+      const int ring_edge_index_start = segments + ring * segments * 2;
 
-    /* Add the edges connecting to the next ring. */
-    if (ring < rings - 2) {
+      /* Add the edges running along each ring. */
       for (const int segment : IndexRange(segments)) {
-        MEdge &edge = edges[edge_index++];
+        MEdge &edge = edges[ring_edge_index_start + segment];
         edge.v1 = ring_vert_index_start + segment;
-        edge.v2 = next_ring_vert_index_start + segment;
+        edge.v2 = ring_vert_index_start + ((segment + 1) % segments);
         edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
       }
+
+      /* Add the edges connecting to the next ring. */
+      if (ring < rings - 2) {
+        for (const int segment : IndexRange(segments)) {
+          MEdge &edge = edges[ring_edge_index_start + segments + segment];
+          edge.v1 = ring_vert_index_start + segment;
+          edge.v2 = next_ring_vert_index_start + segment;
+          edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
+        }
+      }
     }
-    ring_vert_index_start += segments;
-  }
+  });
 
   /* Add the edges connecting the last ring to the bottom vertex. */
+  const int bottom_edge_fan_start = segments * (rings * 2 - 2);
   const int last_vert_index = sphere_vert_total(segments, rings) - 1;
   const int last_vert_ring_start = last_vert_index - segments;
   for (const int segment : IndexRange(segments)) {
-    MEdge &edge = edges[edge_index++];
+    MEdge &edge = edges[bottom_edge_fan_start + segment];
     edge.v1 = last_vert_index;
     edge.v2 = last_vert_ring_start + segment;
     edge.flag = ME_EDGEDRAW | ME_EDGERENDER;
@@ -150,78 +163,84 @@ static void calculate_sphere_faces(MutableSpan<MLoop> loops,
                                    const int segments,
                                    const int rings)
 {
-  int loop_index = 0;
-  int poly_index = 0;
-
   /* Add the triangles connected to the top vertex. */
   const int first_vert_ring_index_start = 1;
   for (const int segment : IndexRange(segments)) {
-    MPoly &poly = polys[poly_index++];
+    const int loop_index = segment * 3;
+    MPoly &poly = polys[segment];
     poly.loopstart = loop_index;
     poly.totloop = 3;
-    MLoop &loop_a = loops[loop_index++];
+    MLoop &loop_a = loops[loop_index];
     loop_a.v = 0;
     loop_a.e = segment;
-    MLoop &loop_b = loops[loop_index++];
+    MLoop &loop_b = loops[loop_index + 1];
     loop_b.v = first_vert_ring_index_start + segment;
     loop_b.e = segments + segment;
-    MLoop &loop_c = loops[loop_index++];
+    MLoop &loop_c = loops[loop_index + 2];
     loop_c.v = first_vert_ring_index_start + (segment + 1) % segments;
     loop_c.e = (segment + 1) % segments;
   }
 
-  int ring_vert_index_start = 1;
-  int ring_edge_index_start = segments;
-  for (const int UNUSED(ring) : IndexRange(1, rings - 2)) {
-    const int next_ring_vert_index_start = ring_vert_index_start + segments;
-    const int next_ring_edge_index_start = ring_edge_index_start + segments * 2;
-    const int ring_vertical_edge_index_start = ring_edge_index_start + segments;
-
-    for (const int segment : IndexRange(segments)) {
-      MPoly &poly = polys[poly_index++];
-      poly.loopstart = loop_index;
-      poly.totloop = 4;
-
-      MLoop &loop_a = loops[loop_index++];
-      loop_a.v = ring_vert_index_start + segment;
-      loop_a.e = ring_vertical_edge_index_start + segment;
-      MLoop &loop_b = loops[loop_index++];
-      loop_b.v = next_ring_vert_index_start + segment;
-      loop_b.e = next_ring_edge_index_start + segment;
-      MLoop &loop_c = loops[loop_index++];
-      loop_c.v = next_ring_vert_index_start + (segment + 1) % segments;
-      loop_c.e = ring_vertical_edge_index_start + (segment + 1) % segments;
-      MLoop &loop_d = loops[loop_index++];
-      loop_d.v = ring_vert_index_start + (segment + 1) % segments;
-      loop_d.e = ring_edge_index_start + segment;
+  const IndexRange quad_rings(1, rings - 2);
+  const int quad_loops_start = segments * 3;
+  threading::parallel_for(quad_rings, ring_grain_size(segments), [&](IndexRange range) {
+    for (const int ring : range) {
+      const int ring_vert_index_start = 1 + (ring - 1) * segments;
+      const int ring_edge_index_start = segments + (ring - 1) * segments * 2;
+      const int next_ring_vert_index_start = ring_vert_index_start + segments;
+      const int next_ring_edge_index_start = ring_edge_index_start + segments * 2;
+      const int ring_vertical_edge_index_start = ring_edge_index_start + segments;
+      const int ring_poly_index_start = ring * segments;
+
+      for (const int segment : IndexRange(segments)) {
+        const int poly_index = ring_poly_index_start + segment;
+        const int loop_index = quad_loops_start + (poly_index - segments) * 4;
+        MPoly &poly = polys[poly_index];
+        poly.loopstart = loop_index;
+        poly.totloop = 4;
+
+        MLoop &loop_a = loops[loop_index];
+        loop_a.v = ring_vert_index_start + segment;
+        loop_a.e = ring_vertical_edge_index_start + segment;
+        MLoop &loop_b = loops[loop_index + 1];
+        loop_b.v = next_ring_vert_index_start + segment;
+        loop_b.e = next_ring_edge_index_start + segment;
+        MLoop &loop_c = loops[loop_index + 2];
+        loop_c.v = next_ring_vert_index_start + (segment + 1) % segments;
+        loop_c.e = ring_vertical_edge_index_start + (segment + 1) % segments;
+        MLoop &loop_d = loops[loop_index + 3];
+        loop_d.v = ring_vert_index_start + (segment + 1) % segments;
+        loop_d.e = ring_edge_index_start + segment;
+      }
     }
-    ring_vert_index_start += segments;
-    ring_edge_index_start += segments * 2;
-  }
+  });
 
   /* Add the triangles connected to the bottom vertex. */
+  const int bottom_poly_index_start = segments * (rings - 1);
+  const int bottom_loop_index_start = quad_loops_start + segments * (rings - 2) * 4;
   const int last_edge_ring_start = segments * (rings - 2) * 2 + segments;
   const int bottom_edge_fan_start = last_edge_ring_start + segments;
   const int last_vert_index = sphere_vert_total(segments, rings) - 1;
   const int last_vert_ring_start = last_vert_index - segments;
   for (const int segment : IndexRange(segments)) {
-    MPoly &poly = polys[poly_index++];
+    const int loop_index = bottom_loop_index_start + segment * 3;
+    MPoly &poly = polys[bottom_poly_index_start + segment];
     poly.loopstart = loop_index;
     poly.totloop = 3;
 
-    MLoop &loop_a = loops[loop_index++];
+    MLoop &loop_a = loops[loop_index];
     loop_a.v = last_vert_index;
     loop_a.e = bottom_edge_fan_start + (segment + 1) % segments;
-    MLoop &loop_b = loops[loop_index++];
+    MLoop &loop_b = loops[loop_index + 1];
     loop_b.v = last_vert_ring_start + (segment + 1) % segments;
     loop_b.e = last_edge_ring_start + segment;
-    MLoop &loop_c = loops[loop_index++];
+    MLoop &loop_c = loops[loop_index + 2];
     loop_c.v = last_vert_ring_start + segment;
     loop_c.e = bottom_edge_fan_start + segment;
   }
 }
 
-static void calculate_sphere_uvs(Mesh *mesh, const float segments, const float rings)
+static void calculate_sphere_uvs(Mesh *mesh, const int segments, const int rings)
 {
   MeshComponent mesh_component;
   mesh_component.replace(mesh, GeometryOwnershipType::Editable);
@@ -229,32 +248,40 @@ static void calculate_sphere_uvs(Mesh *mesh, const float segments, const float r
       mesh_component.attribute_try_get_for_output_only<float2>("uv_map", ATTR_DOMAIN_CORNER);
   MutableSpan<float2> uvs = uv_attribute.as_span();
 
-  int loop_index = 0;
   const float dy = 1.0f / rings;
 
   for (const int i_segment : IndexRange(segments)) {
+    const int loop_index = i_segment * 3;
     const float segment = static_cast<float>(i_segment);
-    uvs[loop_index++] = float2((segment + 0.5f) / segments, 0.0f);
-    uvs[loop_index++] = float2(segment / segments, dy);
-    uvs[loop_index++] = float2((segment + 1.0f) / segments, dy);
+    uvs[loop_index] = float2((segment + 0.5f) / segments, 0.0f);
+    uvs[loop_index + 1] = float2(segment / segments, dy);
+    uvs[loop_index + 2] = float2((segment + 1.0f) / segments, dy);
   }
 
-  for (const int i_ring : IndexRange(1, rings - 2)) {
-    const float ring = static_cast<float>(i_ring);
-    for (const int i_segment : IndexRange(segments)) {
-      const float segment = static_cast<float>(i_segment);
-      uvs[loop_index++] = float2(segment / segments, ring / rings);
-      uvs[loop_index++] = float2(segment / segments, (ring + 1.0f) / rings);
-      uvs[loop_index++] = float2((segment + 1.0f) / segments, (ring + 1.0f) / rings);
-      uvs[loop_index++] = float2((segment + 1.0f) / segments, ring / rings);
+  const IndexRange quad_rings(1, rings - 2);
+  const int quad_loops_start = segments * 3;
+  threading::parallel_for(quad_rings, ring_grain_size(segments), [&](IndexRange range) {
+    for (const int i_ring : range) {
+      const float ring = static_cast<float>(i_ring);
+      const int ring_loop_index_start = quad_loops_start + (i_ring - 1) * segments * 4;
+      for (const int i_segment : IndexRange(segments)) {
+        const int loop_index = ring_loop_index_start + i_segment * 4;
+        const float segment = static_cast<float>(i_segment);
+        uvs[loop_index] = float2(segment / segments, ring / rings);
+        uvs[loop_index + 1] = float2(segment / segments, (ring + 1.0f) / rings);
+        uvs[loop_index + 2] = float2((segment + 1.0f) / segments, (ring + 1.0f) / rings);
+        uvs[loop_index + 3] = float2((segment + 1.0f) / segments, ring / rings);
+      }
     }
-  }
+  });
 
+  const int bottom_loop_index_start = quad_loops_start + segments * (rings - 2) * 4;
   for (const int i_segment : IndexRange(segments)) {
+    const int loop_index = bottom_loop_index_start + i_segment * 3;
     const float segment = static_cast<float>(i_segment);
-    uvs[loop_index++] = float2((segment + 0.5f) / segments, 1.0f);
-    uvs[loop_index++] = float2((segment + 1.0f) / segments, 1.0f - dy);
-    uvs[loop_index++] = float2(segment / segments, 1.0f - dy);
+    uvs[loop_index] = float2((segment + 0.5f) / segments, 1.0f);
+    uvs[loop_index + 1] = float2((segment + 1.0f) / segments, 1.0f - dy);
+    uvs[loop_index + 2] = float2(segment / segments, 1.0f - dy);
   }
 
   uv_attribute.save();
@@ -15,8 +15,9 @@
  */
 
 #include "BLI_hash.h"
-#include "BLI_kdtree.h"
+#include "BLI_map.hh"
 #include "BLI_rand.hh"
+#include "BLI_task.hh"
 #include "BLI_timeit.hh"
 
 #include "DNA_mesh_types.h"
@@ -140,26 +141,79 @@ static void sample_mesh_surface(const Mesh &mesh,
   }
 }
 
-BLI_NOINLINE static KDTree_3d *build_kdtree(Span<Vector<float3>> positions_all,
-                                            const int initial_points_len)
+/**
+ * Coordinates of a cell in the uniform grid used to find close points. The size of a cell is the
+ * minimum distance, so that all points closer than that are in the same or in adjacent cells.
+ */
+struct GridCell {
+  int64_t x, y, z;
+
+  uint64_t hash() const
+  {
+    return (uint64_t)x * 73856093 ^ (uint64_t)y * 19349663 ^ (uint64_t)z * 83492791;
+  }
+
+  friend bool operator==(const GridCell &a, const GridCell &b)
+  {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+  }
+};
+
+struct PointGrid {
+  Vector<GridCell> cells;
+  /* Indices of the points in every cell, in increasing order. */
+  Vector<Vector<int>> cell_points;
+  Map<GridCell, int> cell_indices;
+};
+
+static int64_t grid_cell_coordinate(const float position)
 {
-  KDTree_3d *kdtree = BLI_kdtree_3d_new(initial_points_len);
+  /* Clamp before converting, so that huge coordinates or a tiny cell size can't overflow. Points
+   * that end up in the same cell because of that are still compared by their actual distance.
+   * The comparisons are written so that NaN is clamped as well. */
+  const float limit = 1e15f;
+  const float cell = std::floor(position);
+  if (!(cell > -limit)) {
+    return (int64_t)-limit;
+  }
+  if (!(cell < limit)) {
+    return (int64_t)limit;
+  }
+  return (int64_t)cell;
+}
 
-  int i_point = 0;
-  for (const Vector<float3> &positions : positions_all) {
-    for (const float3 position : positions) {
-      BLI_kdtree_3d_insert(kdtree, i_point, position);
-      i_point++;
+BLI_NOINLINE static void build_point_grid(Span<float3> positions,
+                                          const float cell_size,
+                                          PointGrid &r_grid)
+{
+  const float cell_size_inv = 1.0f / cell_size;
+  Array<GridCell> point_cells(positions.size());
+  threading::parallel_for(positions.index_range(), 4096, [&](IndexRange range) {
+    for (const int i : range) {
+      const float3 position = positions[i] * cell_size_inv;
+      point_cells[i] = {grid_cell_coordinate(position.x),
+                        grid_cell_coordinate(position.y),
+                        grid_cell_coordinate(position.z)};
     }
+  });
+
+  /* Adding the points in order keeps the indices in every cell sorted. */
+  for (const int i : positions.index_range()) {
+    const GridCell &cell = point_cells[i];
+    const int cell_index = r_grid.cell_indices.lookup_or_add_cb(cell, [&]() {
+      r_grid.cells.append(cell);
+      r_grid.cell_points.append({});
+      return (int)r_grid.cells.size() - 1;
+    });
+    r_grid.cell_points[cell_index].append(i);
   }
-  BLI_kdtree_3d_balance(kdtree);
-  return kdtree;
 }
 
 BLI_NOINLINE static void update_elimination_mask_for_close_points(
     Span<Vector<float3>> positions_all,
     Span<int> instance_start_offsets,
     const float minimum_distance,
+    const int seed,
     MutableSpan<bool> elimination_mask,
     const int initial_points_len)
 {
@@ -167,39 +221,104 @@ BLI_NOINLINE static void update_elimination_mask_for_close_points(
     return;
   }
 
-  KDTree_3d *kdtree = build_kdtree(positions_all, initial_points_len);
+  Array<float3> positions(initial_points_len);
+  threading::parallel_for(positions_all.index_range(), 1, [&](IndexRange range) {
+    for (const int i_instance : range) {
+      positions.as_mutable_span()
+          .slice(instance_start_offsets[i_instance], positions_all[i_instance].size())
+          .copy_from(positions_all[i_instance]);
+    }
+  });
+
+  PointGrid grid;
+  build_point_grid(positions, minimum_distance, grid);
+
+  Array<Vector<int, 27>> cell_neighbors(grid.cells.size());
+  threading::parallel_for(grid.cells.index_range(), 256, [&](IndexRange range) {
+    for (const int cell_index : range) {
+      const GridCell &cell = grid.cells[cell_index];
+      for (int64_t z = cell.z - 1; z <= cell.z + 1; z++) {
+        for (int64_t y = cell.y - 1; y <= cell.y + 1; y++) {
+          for (int64_t x = cell.x - 1; x <= cell.x + 1; x++) {
+            if (const int *neighbor_index = grid.cell_indices.lookup_ptr({x, y, z})) {
+              cell_neighbors[cell_index].append(*neighbor_index);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  /* Cells whose coordinates have the same parity on every axis are at least one cell apart, so
+   * the points in them can't be closer than the minimum distance to each other. Processing the
+   * cells in eight groups like that allows the points of all cells in a group to be handled in
+   * parallel, while the result stays independent of the number of threads. The cells in every
+   * group are sorted by decreasing number of points, so that the cells which still have points
+   * left in a round come first. */
+  Vector<int> cells_by_parity[8];
+  int max_cell_points = 0;
+  for (const int cell_index : grid.cells.index_range()) {
+    const GridCell &cell = grid.cells[cell_index];
+    const int parity = (int)((cell.x & 1) | ((cell.y & 1) << 1) | ((cell.z & 1) << 2));
+    cells_by_parity[parity].append(cell_index);
+    max_cell_points = std::max(max_cell_points, (int)grid.cell_points[cell_index].size());
+  }
+  for (Vector<int> &cell_indices : cells_by_parity) {
+    std::stable_sort(cell_indices.begin(), cell_indices.end(), [&](const int a, const int b) {
+      return grid.cell_points[a].size() > grid.cell_points[b].size();
+    });
+  }
 
-  /* The elimination mask is a flattened array for every point,
-   * so keep track of the index to it separately. */
-  for (const int i_instance : positions_all.index_range()) {
-    Span<float3> positions = positions_all[i_instance];
-    const int offset = instance_start_offsets[i_instance];
+  /* Every point is eliminated until it is processed and found to have no close kept point. Points
+   * that are processed later are ignored, because they are eliminated at that point. */
+  elimination_mask.fill(true);
+  const float minimum_distance_sq = minimum_distance * minimum_distance;
+
+  /* Processing all points of a group before the next one would make the cells of the first groups
+   * denser than the others. Instead, every round only handles one point per cell, and the order
+   * of the groups is different in every round. */
+  RandomNumberGenerator rng(seed);
+  int group_order[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  int active_cells_num[8];
+  for (const int group : IndexRange(8)) {
+    active_cells_num[group] = cells_by_parity[group].size();
+  }
 
-    for (const int i : positions.index_range()) {
-      if (elimination_mask[offset + i]) {
-        continue;
+  for (const int round : IndexRange(max_cell_points)) {
+    rng.shuffle(MutableSpan<int>(group_order, 8));
+    for (const int group : group_order) {
+      Span<int> cell_indices = cells_by_parity[group];
+      int &cells_num = active_cells_num[group];
+      while (cells_num > 0 && grid.cell_points[cell_indices[cells_num - 1]].size() <= round) {
+        cells_num--;
       }
-
-      struct CallbackData {
-        int index;
-        MutableSpan<bool> elimination_mask;
-      } callback_data = {offset + i, elimination_mask};
-
-      BLI_kdtree_3d_range_search_cb(
-          kdtree,
-          positions[i],
-          minimum_distance,
-          [](void *user_data, int index, const float *UNUSED(co), float UNUSED(dist_sq)) {
-            CallbackData &callback_data = *static_cast<CallbackData *>(user_data);
-            if (index != callback_data.index) {
-              callback_data.elimination_mask[index] = true;
+      threading::parallel_for(IndexRange(cells_num), 256, [&](IndexRange range) {
+        for (const int cell_index : cell_indices.slice(range)) {
+          const int point_index = grid.cell_points[cell_index][round];
+          const float3 position = positions[point_index];
+          bool has_close_point = false;
+          for (const int neighbor_cell_index : cell_neighbors[cell_index]) {
+            for (const int neighbor_index : grid.cell_points[neighbor_cell_index]) {
+              if (elimination_mask[neighbor_index]) {
+                continue;
+              }
+              if (float3::distance_squared(position, positions[neighbor_index]) <=
+                  minimum_distance_sq) {
+                has_close_point = true;
+                break;
+              }
+            }
+            if (has_close_point) {
+              break;
             }
-            return true;
-          },
-          &callback_data);
+          }
+          if (!has_close_point) {
+            elimination_mask[point_index] = false;
+          }
+        }
+      });
     }
   }
-  BLI_kdtree_3d_free(kdtree);
 }
 
 BLI_NOINLINE static void update_elimination_mask_based_on_density_factors(
@@ -498,12 +617,13 @@ static void distribute_points_poisson_disk(Span<GeometryInstanceGroup> set_group
   const bool use_one_default = density_attribute_name.is_empty();
 
   /* Unlike the other result arrays, the elimination mask in stored as a flat array for every
-   * point, in order to simplify culling points from the KDTree (which needs to know about all
-   * points at once). */
+   * point, in order to simplify culling close points (which needs to know about all points at
+   * once). */
   Array<bool> elimination_mask(initial_points_len, false);
   update_elimination_mask_for_close_points(positions_all,
                                            instance_start_offsets,
                                            minimum_distance,
+                                           seed,
                                            elimination_mask,
                                            initial_points_len);
 
@@ -28,6 +28,9 @@
 #include "UI_interface.h"
 #include "UI_resources.h"
 
+using blender::bke::GeometryInstanceGroup;
+using blender::bke::InstancesRealizedView;
+
 static bNodeSocketTemplate geo_node_points_to_volume_in[] = {
     {SOCK_GEOMETRY, N_("Geometry")},
     {SOCK_FLOAT, N_("Density"), 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, FLT_MAX},
@@ -171,20 +174,30 @@ static float compute_voxel_size(const GeoNodeExecParams &params,
   return voxel_size;
 }
 
-static void gather_point_data_from_component(const GeoNodeExecParams &params,
-                                             const GeometryComponent &component,
+static void gather_point_data_from_instances(const GeoNodeExecParams &params,
+                                             Span<GeometryInstanceGroup> set_groups,
+                                             const GeometryComponentType component_type,
                                              Vector<float3> &r_positions,
                                              Vector<float> &r_radii)
 {
-  GVArray_Typed<float3> positions = component.attribute_get_for_read<float3>(
-      "position", ATTR_DOMAIN_POINT, {0, 0, 0});
-  GVArray_Typed<float> radii = params.get_input_attribute<float>(
-      "Radius", component, ATTR_DOMAIN_POINT, 0.0f);
-
-  for (const int i : IndexRange(positions.size())) {
-    r_positions.append(positions[i]);
-    r_radii.append(radii[i]);
+  const InstancesRealizedView instances{set_groups, component_type};
+  if (instances.is_empty()) {
+    return;
   }
+
+  GVArray_Typed<float3> positions = instances.attribute_get_for_read<float3>(
+      "position", ATTR_DOMAIN_POINT, {0, 0, 0});
+  GVArray_Typed<float> radii{instances.attribute_get_for_read(
+      ATTR_DOMAIN_POINT, CPPType::get<float>(), [&](const GeometryComponent &component) {
+        return params.get_input_attribute(
+            "Radius", component, ATTR_DOMAIN_POINT, CD_PROP_FLOAT, nullptr);
+      })};
+
+  const int offset = r_positions.size();
+  r_positions.resize(offset + positions.size());
+  r_radii.resize(offset + radii.size());
+  positions->materialize(r_positions.as_mutable_span().drop_front(offset));
+  radii->materialize(r_radii.as_mutable_span().drop_front(offset));
 }
 
 static void convert_to_grid_index_space(const float voxel_size,
@@ -204,20 +217,19 @@ static void initialize_volume_component_from_points(const GeometrySet &geometry_
                                                     GeometrySet &geometry_set_out,
                                                     const GeoNodeExecParams &params)
 {
+  /* The instances are only read, so they don't have to be realized. */
+  Vector<GeometryInstanceGroup> set_groups;
+  geometry_set_gather_instances(geometry_set_in, set_groups);
+
   Vector<float3> positions;
   Vector<float> radii;
-
-  if (geometry_set_in.has<MeshComponent>()) {
-    gather_point_data_from_component(
-        params, *geometry_set_in.get_component_for_read<MeshComponent>(), positions, radii);
-  }
-  if (geometry_set_in.has<PointCloudComponent>()) {
-    gather_point_data_from_component(
-        params, *geometry_set_in.get_component_for_read<PointCloudComponent>(), positions, radii);
+  for (const GeometryComponentType component_type :
+       {GEO_COMPONENT_TYPE_MESH, GEO_COMPONENT_TYPE_POINT_CLOUD, GEO_COMPONENT_TYPE_CURVE}) {
+    gather_point_data_from_instances(params, set_groups, component_type, positions, radii);
   }
-  if (geometry_set_in.has<CurveComponent>()) {
-    gather_point_data_from_component(
-        params, *geometry_set_in.get_component_for_read<CurveComponent>(), positions, radii);
+
+  if (positions.is_empty()) {
+    return;
   }
 
   const float max_radius = *std::max_element(radii.begin(), radii.end());
@@ -250,9 +262,6 @@ static void geo_node_points_to_volume_exec(GeoNodeExecParams params)
   GeometrySet geometry_set_in = params.extract_input<GeometrySet>("Geometry");
   GeometrySet geometry_set_out;
 
-  /* TODO: Read-only access to instances should be supported here, for now they are made real. */
-  geometry_set_in = geometry_set_realize_instances(geometry_set_in);
-
 #ifdef WITH_OPENVDB
   initialize_volume_component_from_points(geometry_set_in, geometry_set_out, params);
 #endif
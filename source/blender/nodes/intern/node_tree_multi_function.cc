@@ -18,6 +18,7 @@
 #include "NOD_type_conversions.hh"
 
 #include "FN_multi_function_network_evaluation.hh"
+#include "FN_multi_function_network_optimization.hh"
 
 #include "BLI_color.hh"
 #include "BLI_float2.hh"
@@ -403,6 +404,11 @@ MultiFunctionByNode get_multi_function_per_node(const DerivedNodeTree &tree, Res
     }
   });
 
+  /* Nodes that expanded into multiple functions are evaluated by a network evaluator that only
+   * references the dummy nodes, so chains of function nodes can still be fused. This has to happen
+   * after all nodes are expanded, because it invalidates the sockets in the network map. */
+  fn::mf_network_optimization::function_chain_fusion(network, scope);
+
   return functions_by_node;
 }
 
@@ -76,6 +76,77 @@ class FCurveEvaluationTest(AbstractAnimationTest, unittest.TestCase):
         self.assertAlmostEqual(1.0, fcurve.evaluate(10))
 
 
+class ActionEvaluationTest(unittest.TestCase):
+    """Evaluated values have to follow changes of the action between evaluations."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.scene = bpy.context.scene
+        self.object = bpy.data.objects.new('Empty', None)
+        self.scene.collection.objects.link(self.object)
+
+        self.action = bpy.data.actions.new('Action')
+        self.object.animation_data_create().action = self.action
+        self.fcurve_x = self.add_linear_fcurve('location', 0, [(1, 0.0), (11, 10.0)])
+        self.fcurve_y = self.add_linear_fcurve('location', 1, [(1, 0.0), (11, -10.0)])
+
+    def add_linear_fcurve(self, data_path: str, index: int, keys) -> bpy.types.FCurve:
+        fcurve = self.action.fcurves.new(data_path, index=index)
+        for frame, value in keys:
+            keyframe = fcurve.keyframe_points.insert(frame, value)
+            keyframe.interpolation = 'LINEAR'
+        return fcurve
+
+    def evaluate(self, frame: int) -> bpy.types.Object:
+        self.scene.frame_set(frame)
+        return self.object.evaluated_get(bpy.context.evaluated_depsgraph_get())
+
+    def test_keyframe_edit(self):
+        self.assertAlmostEqual(5.0, self.evaluate(6).location[0])
+
+        self.fcurve_x.keyframe_points[1].co.y = 20.0
+        self.assertAlmostEqual(10.0, self.evaluate(6).location[0])
+
+        self.fcurve_x.keyframe_points.insert(6, -1.0).interpolation = 'LINEAR'
+        self.assertAlmostEqual(-1.0, self.evaluate(6).location[0])
+        self.assertAlmostEqual(7.4, self.evaluate(8).location[0], places=5)
+
+    def test_keyframe_remove(self):
+        self.assertAlmostEqual(5.0, self.evaluate(6).location[0])
+
+        self.fcurve_x.keyframe_points.remove(self.fcurve_x.keyframe_points[1])
+        self.assertAlmostEqual(0.0, self.evaluate(6).location[0])
+
+    def test_channel_rename(self):
+        self.assertAlmostEqual(5.0, self.evaluate(6).location[0])
+
+        self.fcurve_x.data_path = 'scale'
+        self.assertAlmostEqual(3.0, self.evaluate(4).scale[0])
+
+        self.fcurve_x.array_index = 2
+        self.assertAlmostEqual(7.0, self.evaluate(8).scale[2])
+
+    def test_channel_remove(self):
+        self.assertAlmostEqual(-5.0, self.evaluate(6).location[1])
+
+        self.action.fcurves.remove(self.fcurve_x)
+        self.assertAlmostEqual(-3.0, self.evaluate(4).location[1])
+
+        self.add_linear_fcurve('location', 2, [(1, 0.0), (11, 100.0)])
+        evaluated = self.evaluate(8)
+        self.assertAlmostEqual(-7.0, evaluated.location[1])
+        self.assertAlmostEqual(70.0, evaluated.location[2])
+
+    def test_action_change(self):
+        self.assertAlmostEqual(5.0, self.evaluate(6).location[0])
+
+        self.action = bpy.data.actions.new('Other')
+        self.add_linear_fcurve('location', 0, [(1, 10.0), (11, 0.0)])
+        self.object.animation_data.action = self.action
+        self.assertAlmostEqual(7.0, self.evaluate(4).location[0])
+        self.assertAlmostEqual(8.0, self.evaluate(3).location[0])
+
+
 class EulerFilterTest(AbstractAnimationTest, unittest.TestCase):
     def setUp(self):
         super().setUp()
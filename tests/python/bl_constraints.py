@@ -375,6 +375,57 @@ class CustomSpaceTest(AbstractConstraintTests):
         )))
 
 
+class ConstraintRemovalTest(unittest.TestCase):
+    """Removed constraints must not be kept on the evaluated object.
+
+    Removing a constraint only tags the object transform for update, which still has to copy the
+    whole object to its evaluated copy.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        self.target = bpy.data.objects.new('Target', None)
+        self.target.location = (1.0, 2.0, 3.0)
+        self.owner = bpy.data.objects.new('Owner', None)
+        bpy.context.scene.collection.objects.link(self.target)
+        bpy.context.scene.collection.objects.link(self.owner)
+
+        constraint = self.owner.constraints.new('COPY_LOCATION')
+        constraint.target = self.target
+        bpy.context.view_layer.update()
+
+        # The evaluated object has to exist before the removal, otherwise it is copied anyway.
+        owner_eval = self._owner_eval()
+        self.assertEqual(len(owner_eval.constraints), 1)
+        self.assertEqual(owner_eval.matrix_world.translation, self.target.location)
+
+    def _owner_eval(self) -> bpy.types.Object:
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        return self.owner.evaluated_get(depsgraph)
+
+    def _assert_constraint_removed(self):
+        owner_eval = self._owner_eval()
+        self.assertEqual(len(owner_eval.constraints), 0)
+        self.assertEqual(owner_eval.matrix_world.translation, self.owner.location)
+
+    def test_remove(self):
+        self.owner.constraints.remove(self.owner.constraints[0])
+        self._assert_constraint_removed()
+
+    def test_clear(self):
+        self.owner.constraints.clear()
+        self._assert_constraint_removed()
+
+    def test_clear_operator(self):
+        context_override = {
+            'object': self.owner,
+            'selected_editable_objects': [self.owner],
+        }
+        bpy.ops.object.constraints_clear(context_override)
+        self._assert_constraint_removed()
+
+
 def main():
     global args
     import argparse
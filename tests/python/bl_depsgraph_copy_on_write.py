@@ -0,0 +1,49 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_depsgraph_copy_on_write.py
+import bpy
+import unittest
+
+
+class ObjectTransformTagTest(unittest.TestCase):
+    """Edits which tag only the object transform must still reach the evaluated object.
+
+    Only tags with ID_RECALC_TRANSFORM_ONLY are handled by copying the transform settings to the
+    evaluated object. A plain transform tag is also used for other changes of the object, which
+    need the whole object to be copied.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        self.object = bpy.data.objects.new('Empty', None)
+        bpy.context.scene.collection.objects.link(self.object)
+        bpy.context.view_layer.objects.active = self.object
+        bpy.context.view_layer.update()
+
+        # The evaluated object has to exist before the edit, otherwise it is copied anyway.
+        self.assertIsNone(self._object_eval().field)
+
+    def _object_eval(self) -> bpy.types.Object:
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        return self.object.evaluated_get(depsgraph)
+
+    def test_forcefield_toggle(self):
+        bpy.ops.object.forcefield_toggle()
+        self.assertEqual(self._object_eval().field.type, 'FORCE')
+
+        bpy.ops.object.forcefield_toggle()
+        self.assertEqual(self._object_eval().field.type, 'NONE')
+
+        bpy.ops.object.forcefield_toggle()
+        self.assertEqual(self._object_eval().field.type, 'FORCE')
+
+    def test_location(self):
+        self.object.location = (1.0, 2.0, 3.0)
+        self.assertEqual(self._object_eval().matrix_world.translation, self.object.location)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,75 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_geometry_nodes_point_distribute.py
+import unittest
+
+import bpy
+from mathutils import kdtree
+
+
+class PoissonDiskDistributeTest(unittest.TestCase):
+    """Points distributed with the Poisson disk method must keep the minimum distance."""
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+
+        mesh = bpy.data.meshes.new('Plane')
+        mesh.from_pydata([(-1, -1, 0), (1, -1, 0), (1, 1, 0), (-1, 1, 0)], [], [(0, 1, 2, 3)])
+        self.object = bpy.data.objects.new('Plane', mesh)
+        bpy.context.scene.collection.objects.link(self.object)
+
+        tree = bpy.data.node_groups.new('Distribute', 'GeometryNodeTree')
+        tree.inputs.new('NodeSocketGeometry', 'Geometry')
+        tree.outputs.new('NodeSocketGeometry', 'Geometry')
+        group_input = tree.nodes.new('NodeGroupInput')
+        group_output = tree.nodes.new('NodeGroupOutput')
+        self.distribute = tree.nodes.new('GeometryNodePointDistribute')
+        self.distribute.distribute_method = 'POISSON'
+        self.distribute.inputs['Density Max'].default_value = 2000.0
+        tree.links.new(group_input.outputs['Geometry'], self.distribute.inputs['Geometry'])
+        tree.links.new(self.distribute.outputs['Geometry'], group_output.inputs['Geometry'])
+
+        modifier = self.object.modifiers.new('Distribute', 'NODES')
+        modifier.node_group = tree
+
+    def _evaluated_points(self):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        points = []
+        for instance in depsgraph.object_instances:
+            if instance.object.type != 'POINTCLOUD' or instance.parent is None:
+                continue
+            if instance.parent.original != self.object:
+                continue
+            points.extend(instance.matrix_world @ point.co for point in instance.object.data.points)
+        return points
+
+    def _assert_minimum_distance(self, minimum_distance):
+        self.distribute.inputs['Distance Min'].default_value = minimum_distance
+        points = self._evaluated_points()
+        self.assertGreater(len(points), 1)
+
+        tree = kdtree.KDTree(len(points))
+        for i, co in enumerate(points):
+            tree.insert(co, i)
+        tree.balance()
+
+        for i, co in enumerate(points):
+            for _co, index, distance in tree.find_range(co, minimum_distance * 0.999):
+                if index != i:
+                    self.fail("Points %d and %d are %f apart, the minimum distance is %f" %
+                              (i, index, distance, minimum_distance))
+
+    def test_minimum_distance(self):
+        for minimum_distance in (0.02, 0.05, 0.2):
+            with self.subTest(minimum_distance=minimum_distance):
+                self._assert_minimum_distance(minimum_distance)
+
+    def test_tiny_minimum_distance(self):
+        # Grid cell coordinates don't fit into 32 bit integers.
+        self._assert_minimum_distance(1e-9)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()